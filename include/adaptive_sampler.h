@@ -0,0 +1,50 @@
+#ifndef ADAPTIVE_SAMPLER_H
+#define ADAPTIVE_SAMPLER_H
+
+#include <stdint.h>
+
+// Rate-of-change driven sampling interval.
+//
+// The interval doubles (up to maxIntervalMs) while readings stay inside a
+// band around the last reference point, halves when the smoothed temperature
+// derivative or variance rises, and drops straight to minIntervalMs when a
+// reading leaves the band. The slope is taken over the monotonic time between
+// samples, so an early sample (an alert wake) is not read as a slow one.
+// Call configure() on every boot.
+class AdaptiveSampler {
+private:
+  // Configuration (set by configure() each boot)
+  uint32_t minIntervalMs;
+  uint32_t maxIntervalMs;
+  float temperatureBand;    // °C around the reference
+  float humidityBand;       // %RH around the reference
+  float rateLimit;          // °C per minute
+
+  // State
+  bool primed;
+  uint32_t intervalMs;
+  float referenceTemperature;
+  float referenceHumidity;
+  float lastTemperature;
+  uint64_t lastSampleMs;
+  float meanTemperature;    // EWMA
+  float varianceTemperature; // EWMA
+  float slope;              // EWMA of °C per minute
+
+public:
+  static constexpr float SMOOTHING = 0.3f;
+
+  void configure(uint32_t minInterval, uint32_t maxInterval, float tempBand, float humBand,
+                 float maxRatePerMinute);
+  void reset();
+
+  // Feed one sample taken at sampledMs (monotonic); returns the interval
+  // until the next one in milliseconds
+  uint32_t update(float temperature, float humidity, uint64_t sampledMs);
+
+  uint32_t getIntervalMs() const { return primed ? intervalMs : minIntervalMs; }
+  float getSlope() const { return slope; }
+  float getStdDev() const;
+};
+
+#endif // ADAPTIVE_SAMPLER_H
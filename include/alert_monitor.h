@@ -0,0 +1,82 @@
+#ifndef ALERT_MONITOR_H
+#define ALERT_MONITOR_H
+
+#include <stdint.h>
+
+// Threshold and rate-of-change alarms for the alert fast path.
+//
+// evaluate() is cheap enough to run on every sensor-only check. It raises
+// an alert when a condition newly becomes active; conditions clear once the
+// reading is back inside the threshold by the hysteresis margin. A raised
+// alert stays pending, and evaluate() keeps returning it, until acknowledge()
+// records a successful publish, so an alarm is not lost to a failed
+// connection. Call configure() on every boot.
+
+enum class AlertType : uint8_t {
+  None = 0,
+  HighTemperature,
+  LowTemperature,
+  HighHumidity,
+  LowHumidity,
+  RateOfChange
+};
+
+static const uint8_t ALERT_TYPE_COUNT = 6;
+
+struct AlertThresholds {
+  float highTemperature;   // °C
+  float lowTemperature;    // °C
+  float highHumidity;      // %RH
+  float lowHumidity;       // %RH
+  float maxRatePerMinute;  // °C per minute, measured over rateWindowMs
+  float hysteresis;        // °C / %RH needed to clear a level alarm
+  uint32_t rateWindowMs;
+};
+
+class AlertMonitor {
+private:
+  AlertThresholds thresholds;
+  uint8_t activeMask;
+  uint8_t pendingMask;                   // Raised but not yet published
+  uint64_t detectedMs[ALERT_TYPE_COUNT]; // When each pending alarm was raised
+  bool primed;
+  float rateReferenceTemperature;
+  uint64_t rateReferenceMs;
+  float lastRate;
+  float lastTemperature;
+  float lastHumidity;
+
+  // Latency from detection to publish
+  uint32_t alarmCount;
+  uint32_t lastLatencyMs;
+  uint32_t maxLatencyMs;
+  uint64_t totalLatencyMs;
+
+  void updateLevel(AlertType type, bool breached, bool cleared, uint64_t timeMs, AlertType* raised);
+
+public:
+  void configure(const AlertThresholds& newThresholds);
+
+  // Returns the alert that became active with this sample, else the oldest
+  // one still pending from an earlier sample, or None
+  AlertType evaluate(float temperature, float humidity, uint64_t timeMs);
+
+  bool isActive(AlertType type) const;
+  bool anyActive() const { return activeMask != 0; }
+  // Last reading within margin of a level threshold, an alarm active, or no reading yet
+  bool isNearThreshold(float margin) const;
+  float getLastRate() const { return lastRate; }
+
+  bool isPending(AlertType type) const;
+  uint64_t getDetectedMs(AlertType type) const;
+  // The alarm went out: stop returning it and record its detection-to-publish latency
+  void acknowledge(AlertType type, uint64_t publishedMs);
+  uint32_t getAlarmCount() const { return alarmCount; }
+  uint32_t getLastLatencyMs() const { return lastLatencyMs; }
+  uint32_t getMaxLatencyMs() const { return maxLatencyMs; }
+  uint32_t getMeanLatencyMs() const;
+
+  static const char* describe(AlertType type);
+};
+
+#endif // ALERT_MONITOR_H
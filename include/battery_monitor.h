@@ -0,0 +1,45 @@
+#ifndef BATTERY_MONITOR_H
+#define BATTERY_MONITOR_H
+
+#include <stdint.h>
+
+// Cell voltage and state of charge of a single Li-ion/LiPo cell, read through
+// a resistor divider on an ADC pin.
+//
+// measure() takes BATTERY_ADC_SAMPLES readings (millivolts, already corrected
+// with the chip's factory calibration by the HAL), discards the highest and
+// lowest, scales the mean by BATTERY_DIVIDER_RATIO and applies the two-point
+// board calibration (BATTERY_CAL_GAIN, BATTERY_CAL_OFFSET_MV). Successive
+// measurements are smoothed, so a single reading taken during a load spike
+// does not move the policy tier.
+//
+// State of charge is interpolated on a resting-voltage curve, so measure
+// before the radio comes up. The smoothing carries across deep sleep.
+class BatteryMonitor {
+private:
+  uint16_t filteredMv; // 0 until a cell has been detected
+  uint16_t lastMv;
+
+public:
+  static const uint16_t MIN_PRESENT_MV = 2500; // Lower readings: no cell (floating or grounded pin)
+  static constexpr float SMOOTHING = 0.5f;     // Weight of a new measurement
+
+  void reset();
+
+  // Sample the ADC; false when no cell is detected
+  bool measure();
+
+  // Cell millivolts for a pin voltage (divider and calibration applied)
+  static uint16_t cellMillivolts(uint32_t pinMillivolts);
+  // Resting-voltage curve lookup, 0-100 %
+  static uint8_t stateOfCharge(uint16_t cellMv);
+  // Inverse of stateOfCharge(), for simulated discharge curves
+  static uint16_t restingMillivolts(float percent);
+
+  bool isPresent() const { return filteredMv > 0; }
+  uint16_t getMillivolts() const { return filteredMv; }
+  uint16_t getLastMillivolts() const { return lastMv; }
+  uint8_t getStateOfCharge() const { return stateOfCharge(filteredMv); }
+};
+
+#endif // BATTERY_MONITOR_H
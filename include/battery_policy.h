@@ -0,0 +1,64 @@
+#ifndef BATTERY_POLICY_H
+#define BATTERY_POLICY_H
+
+#include <stdint.h>
+
+// Operating tiers by remaining charge, most generous first
+enum class BatteryTier : uint8_t {
+  Normal,
+  Conserve,
+  Low,
+  Critical,
+};
+
+static const uint8_t BATTERY_TIER_COUNT = 4;
+
+// What a tier allows
+struct BatteryTierSettings {
+  uint8_t sleepMultiplier; // Applied to the deep sleep duration / sampling interval
+  uint8_t publishEvery;    // Readings per publish; the ones in between are batched
+  uint16_t cpuMhz;         // CPU clock ceiling
+  bool homekit;            // HomeKit updates (HomeSpan is only started in a tier that allows it)
+};
+
+// Maps the battery's state of charge to an operating tier.
+//
+// The tier drops as soon as the charge falls below a tier's threshold and
+// only climbs back once the charge is hysteresis points above it, so a cell
+// hovering on a boundary (or recovering under no load) does not flap between
+// schedules. takePublishSlot() counts readings and lets every
+// publishEvery-th one through to the publishers.
+//
+// Pure logic, no HAL access: the host discharge simulation drives it through
+// the firmware. Call configure() on every boot.
+class BatteryPolicy {
+private:
+  // Configuration
+  uint8_t tierStart[BATTERY_TIER_COUNT]; // Charge (%) below which tier i applies; [0] unused
+  uint8_t hysteresis;
+  BatteryTierSettings settings[BATTERY_TIER_COUNT];
+
+  // State
+  BatteryTier tier;
+  uint8_t readingsSincePublish;
+
+  BatteryTier tierFor(int stateOfCharge) const;
+
+public:
+  void configure(const uint8_t tierStartPercent[BATTERY_TIER_COUNT], uint8_t hysteresisPercent,
+                 const BatteryTierSettings tierSettings[BATTERY_TIER_COUNT]);
+  void reset();
+
+  // Re-evaluate the tier; true when it changed
+  bool update(uint8_t stateOfCharge);
+
+  // Count one reading; true when it should be published now
+  bool takePublishSlot();
+
+  BatteryTier getTier() const { return tier; }
+  const BatteryTierSettings& getSettings() const { return settings[(uint8_t)tier]; }
+
+  static const char* tierName(BatteryTier tier);
+};
+
+#endif // BATTERY_POLICY_H
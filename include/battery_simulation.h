@@ -0,0 +1,49 @@
+#ifndef BATTERY_SIMULATION_H
+#define BATTERY_SIMULATION_H
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+#include "battery_policy.h"
+
+// Host harness that discharges a simulated cell under the firmware.
+//
+// step() charges the time the fakes spent asleep, awake and with a radio on
+// since the previous call against the cell, using EnergyModel currents (the
+// awake CPU share at the fake's current clock), then puts the resting
+// voltage for the remaining charge on the battery ADC pin, so the firmware's
+// own monitor and policy see the cell drain. The caller runs setup()/loop()
+// on the simulated clock and reports the policy tier after every pass.
+class BatterySimulation {
+private:
+  float capacityMah = 0.0f;
+  float usedMah = 0.0f;
+  uint64_t lastTotalMicros = 0;
+  uint64_t lastSleepMicros = 0;
+  uint64_t lastRadioMicros = 0;
+  BatteryTier lastTier = BatteryTier::Normal;
+
+  void printLine(const char* event) const;
+
+public:
+  explicit BatterySimulation(float capacity) : capacityMah(capacity) {}
+
+  // Full cell on the ADC pin; call after FakeHal::reset()
+  void begin();
+
+  // Integrate the charge used since the last step and update the ADC pin
+  void step();
+
+  // Log a line whenever the firmware's tier changes
+  void observeTier(BatteryTier tier);
+
+  float stateOfCharge() const;
+  bool empty() const { return usedMah >= capacityMah; }
+
+  // Lifetime and average current
+  void printReport() const;
+};
+
+#endif // ARDUINO
+
+#endif // BATTERY_SIMULATION_H
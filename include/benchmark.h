@@ -0,0 +1,42 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// Minimal microbenchmark runner shared by the host and ESP32 bench builds.
+// Timing uses the CPU cycle counter on target and a steady clock (ns) on the
+// host. Each benchmark is repeated and summarised as one JSON line:
+//   {"bench":"heat_index","unit":"ns","iters":1000,"reps":15,
+//    "median":12.3,"mean":12.5,"stddev":0.4,"min":12.1,"max":13.2}
+// Values are per operation.
+
+typedef void (*BenchmarkFunction)(uint32_t iterations);
+
+struct BenchmarkCase {
+  const char* name;
+  BenchmarkFunction function;
+  uint32_t iterations; // Operations per repetition
+};
+
+class Benchmark {
+private:
+  static volatile float floatSink;
+  static volatile uint32_t intSink;
+
+public:
+  static const uint8_t REPETITIONS = 15;
+
+  // Current timestamp in the platform's unit (cycles or ns)
+  static uint32_t ticks();
+  static const char* unit();
+
+  // Run one warm-up pass plus REPETITIONS timed passes and print the summary
+  static void run(const BenchmarkCase& benchmark);
+
+  // Keep results alive so the compiler cannot drop the measured work
+  static void consume(float value) { floatSink = value; }
+  static void consume(uint32_t value) { intSink = value; }
+};
+
+#endif // BENCHMARK_H
@@ -5,16 +5,20 @@
 #include "config.h"
 
 #if BLYNK_ENABLED
-#include <WiFi.h>
-// Forward declaration to avoid multiple inclusion of BlynkSimpleEsp32.h
-class BlynkWifi;
-extern BlynkWifi Blynk;
+#include "hal.h"
+#include "blynk_pins.h"
+#include "rolling_stats.h"
 
 class BlynkManager {
 private:
   bool initialized;
   unsigned long lastConnectionCheck;
+  unsigned long reconnects;
   static const unsigned long CONNECTION_CHECK_INTERVAL = 30000; // 30 seconds
+  static const int LEAF_PIN_COUNT = 3; // Temperature, humidity, heat index
+  static const int WINDOW_PIN_COUNT = 8; // Mean, min, max, stddev for temperature then humidity
+
+  static void writeWindowStats(int basePin, const WindowStats& stats);
 
 public:
   BlynkManager();
@@ -22,8 +26,17 @@ public:
   void run();
   void sendSensorData(float temperature, float humidity, float heatIndex);
   void sendStatus(const String& sensorName, bool isOnline);
+  // Immediate alarm: current values plus a Blynk event (notification)
+  void sendAlert(const char* description, float temperature, float humidity, float heatIndex);
+  // Gateway: leaf readings on their own pin group (GATEWAY_BLYNK_PIN_BASE)
+  void sendLeafData(uint8_t leaf, float temperature, float humidity, float heatIndex);
+  // Window aggregates on their own pin group (ROLLING_STATS_PIN_BASE)
+  void sendWindowStats(uint8_t window, const WindowStats& temperature, const WindowStats& humidity);
+  // Cell state of charge and voltage (BLYNK_VIRTUAL_PIN_BATTERY_LEVEL / _VOLTAGE)
+  void sendBattery(uint8_t percent, float volts);
   bool isConnected();
   void checkConnection();
+  unsigned long getReconnectCount() const { return reconnects; }
   
   // Static callback functions for Blynk
   static void onConnected();
@@ -0,0 +1,37 @@
+#ifndef BOOT_METRICS_H
+#define BOOT_METRICS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Boot latency metrics: time from boot (millis() == 0) to the first valid
+// sensor sample and to the first sample delivered to any publisher.
+// Reported as "METRIC <name>=<value>" lines so logs can be checked against
+// FAST_BOOT_TARGET_FIRST_PUBLISH_MS by scripts.
+class BootMetrics {
+private:
+  static unsigned long setupMs;
+  static unsigned long firstSampleMs;
+  static unsigned long firstPublishMs;
+  static bool setupMarked;
+  static bool sampleMarked;
+  static bool publishMarked;
+
+public:
+  static void reset();
+
+  // Record the first occurrence only; later calls are ignored
+  static void markSetupComplete(); // End of a normal (not quick-wake) setup(), printed at once
+  static void markFirstSample();
+  static void markFirstPublish();
+
+  static bool hasFirstPublish() { return publishMarked; }
+  static unsigned long getSetupMs() { return setupMs; }
+  static unsigned long getFirstSampleMs() { return firstSampleMs; }
+  static unsigned long getFirstPublishMs() { return firstPublishMs; }
+
+  // Print the metrics and whether the first-publish target was met
+  static void report();
+};
+
+#endif // BOOT_METRICS_H
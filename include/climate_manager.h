@@ -4,9 +4,34 @@
 #include <Arduino.h>
 #include <Adafruit_Sensor.h>
 #include "config.h"
+#include "measurement_policy.h"
+
+// Host builds have no sensor drivers and the emulator has no I2C devices:
+// both always use the simulated sensor
+#if !defined(ARDUINO) || defined(QEMU_BUILD) || SENSOR_TYPE == SENSOR_TYPE_SIMULATED
+#define CLIMATE_SENSOR_SIMULATED 1
+#else
+#define CLIMATE_SENSOR_SIMULATED 0
+#endif
+
+// Identity of a good reading. Only readings handed to the publishers are
+// numbered (alert checks and batched readings are not), and the numbers
+// continue across deep sleep (RTC memory), so a gap or a repeat at a sink
+// means a submitted sample was dropped or sent twice. The acquisition time is
+// PowerManager's monotonic clock, plus the RTC timer reading TimeService
+// turns into UTC when it is sent.
+struct SampleStamp {
+  uint32_t sequence;   // From 1; 0 until the first published reading
+  uint64_t acquiredMs;
+  uint64_t rtcUs;
+};
 
 // Unified Sensor interface for climate sensors
 class ClimateManager {
+private:
+  static uint32_t sequenceCounter; // RTC memory
+  SampleStamp lastStamp = {};
+
 public:
   virtual ~ClimateManager() = default;
   
@@ -16,6 +41,21 @@ public:
   virtual bool getHumidityEvent(sensors_event_t* event) = 0;
   virtual void getTemperatureSensor(sensor_t* sensor) = 0;
   virtual void getHumiditySensor(sensor_t* sensor) = 0;
+
+  // Free a wedged bus before begin() is retried; true if the bus is usable
+  virtual bool recoverBus() { return true; }
+
+  // Conversion mode for the following readings; sensors with one mode ignore it
+  virtual void setPrecision(MeasurementPrecision precision) { (void)precision; }
+
+  // Run the on-chip heater once to drive off condensation; false without a heater
+  virtual bool pulseHeater() { return false; }
+  
+  // Record when a good reading was taken (called by SensorSupervisor)
+  void markAcquired(uint64_t acquiredMs);
+  // Number the last good reading as it goes to the publishers
+  const SampleStamp& stamp();
+  const SampleStamp& getLastStamp() const { return lastStamp; }
   
   // Convenience methods
   virtual String getSensorName() = 0;
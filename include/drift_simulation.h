@@ -0,0 +1,49 @@
+#ifndef DRIFT_SIMULATION_H
+#define DRIFT_SIMULATION_H
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+
+// Host harness that checks the time service against a drifting RTC timer.
+//
+// The fake RTC timer runs offsetPpm fast (negative: slow) plus a daily
+// sinusoidal swing of swingPpm, like an RC oscillator following room
+// temperature. After every pass step() compares TimeService::now() with the
+// true UTC of the fake SNTP server and counts estimates outside their own
+// error bound. The caller runs setup()/loop() on the simulated clock.
+class DriftSimulation {
+private:
+  double offsetPpm = 0.0;
+  double swingPpm = 0.0;
+  double driftSumPpm = 0.0;
+  uint64_t lastTotalMicros = 0;
+  uint64_t checks = 0;
+  uint64_t violations = 0;
+  int64_t maxErrorMs = 0;   // Largest |estimate - UTC| seen
+  uint32_t maxBoundMs = 0;  // Largest error bound claimed
+  uint64_t syncedMicros = 0; // Simulated time from the first check on
+  uint32_t lastSyncCount = 0;
+  unsigned long wakes = 0;
+
+  void printLine(const char* event) const;
+
+public:
+  DriftSimulation(double offset, double swing) : offsetPpm(offset), swingPpm(swing) {}
+
+  // Set the starting drift; call after FakeHal::reset()
+  void begin();
+
+  // Move the drift along its daily cycle and check the current estimate
+  void step();
+
+  // Count a deep sleep wake, to compare against the SNTP requests
+  void observeWake() { wakes++; }
+
+  // Error, bound violations and SNTP exchanges over the run
+  void printReport() const;
+};
+
+#endif // ARDUINO
+
+#endif // DRIFT_SIMULATION_H
@@ -0,0 +1,33 @@
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+#include <stdint.h>
+
+// Rough ESP32 supply current per operating state, used to turn measured or
+// simulated state durations into energy estimates. Figures are typical
+// DevKit values at 3.3 V; adjust them to the board being modelled.
+struct EnergyModel {
+  static constexpr float SUPPLY_VOLTAGE = 3.3f;
+  static constexpr float ACTIVE_CURRENT_MA = 40.0f;       // CPU at 240 MHz, radio off
+  static constexpr float RADIO_CURRENT_MA = 120.0f;       // WiFi on, averaged over TX/RX bursts
+  static constexpr float DEEP_SLEEP_CURRENT_MA = 0.01f;   // RTC timer only
+  static constexpr float LIGHT_SLEEP_IDLE_CURRENT_MA = 4.0f;  // Auto light sleep, WiFi waking for DTIM beacons
+  static constexpr float MODEM_SLEEP_RADIO_CURRENT_MA = 5.0f; // Radio share with modem sleep, averaged
+  static constexpr float CPU_BASE_CURRENT_MA = 20.0f;         // Digital core at the lowest clock
+
+  // CPU-only current, roughly linear in clock frequency up to ACTIVE_CURRENT_MA at 240 MHz
+  static float cpuCurrentMa(uint32_t cpuMhz) {
+    return CPU_BASE_CURRENT_MA + (ACTIVE_CURRENT_MA - CPU_BASE_CURRENT_MA) * cpuMhz / 240.0f;
+  }
+
+  // Energy in millijoules; radio time is a subset of awake time
+  static float energyMillijoules(uint64_t awakeMicros, uint64_t radioMicros, uint64_t sleepMicros) {
+    uint64_t cpuOnlyMicros = awakeMicros > radioMicros ? awakeMicros - radioMicros : 0;
+    float milliampSeconds = (RADIO_CURRENT_MA * radioMicros +
+                             ACTIVE_CURRENT_MA * cpuOnlyMicros +
+                             DEEP_SLEEP_CURRENT_MA * sleepMicros) / 1e6f;
+    return milliampSeconds * SUPPLY_VOLTAGE;
+  }
+};
+
+#endif // ENERGY_MODEL_H
@@ -0,0 +1,36 @@
+#ifndef FEATURE_SETTINGS_H
+#define FEATURE_SETTINGS_H
+
+#include "config.h"
+
+#ifndef FIRMWARE_VARIANT
+#define FIRMWARE_VARIANT "custom" // Set by the variant envs in platformio.ini
+#endif
+
+// Compile-time view of the feature selection (config.h defaults, overridden
+// per variant env). Modules that are absent from a variant stay behind #if;
+// code that merely branches on a setting tests these constants instead, so
+// the untaken branch is folded away in every translation unit without LTO.
+struct Features {
+  static constexpr const char* VARIANT = FIRMWARE_VARIANT;
+  static constexpr int SENSOR = SENSOR_TYPE;
+  static constexpr bool HOMEKIT = HOMEKIT_ENABLED;
+  static constexpr bool BLYNK = BLYNK_ENABLED;
+  static constexpr bool MQTT = MQTT_ENABLED;
+  static constexpr bool DEEP_SLEEP = DEEP_SLEEP_ENABLED;
+  static constexpr bool BATTERY = BATTERY_MONITOR_ENABLED;
+  static constexpr int ROLE = NODE_ROLE;
+};
+
+static_assert(Features::SENSOR >= SENSOR_TYPE_DHT11 && Features::SENSOR <= SENSOR_TYPE_SIMULATED,
+              "SENSOR_TYPE must be one of the SENSOR_TYPE_* values");
+static_assert(Features::ROLE != NODE_ROLE_LEAF || Features::DEEP_SLEEP,
+              "NODE_ROLE_LEAF requires DEEP_SLEEP_ENABLED");
+static_assert(Features::ROLE != NODE_ROLE_GATEWAY || !Features::DEEP_SLEEP,
+              "NODE_ROLE_GATEWAY must stay awake to receive leaf frames");
+static_assert(GATEWAY_HOMEKIT_LEAVES <= GATEWAY_MAX_LEAVES,
+              "GATEWAY_HOMEKIT_LEAVES cannot bridge more leaves than GATEWAY_MAX_LEAVES");
+static_assert(!Features::BATTERY || (BATTERY_ADC_PIN >= 32 && BATTERY_ADC_PIN <= 39),
+              "BATTERY_ADC_PIN must be an ADC1 pin (32-39): ADC2 is unusable while WiFi is on");
+
+#endif // FEATURE_SETTINGS_H
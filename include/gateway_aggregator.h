@@ -0,0 +1,54 @@
+#ifndef GATEWAY_AGGREGATOR_H
+#define GATEWAY_AGGREGATOR_H
+
+#include <stdint.h>
+#include "config.h"
+#include "sample_frame.h"
+
+// Per-leaf state on the gateway
+struct LeafRecord {
+  uint8_t mac[6];
+  uint16_t lastSequence;
+  float temperature;
+  float humidity;
+  bool sensorError;
+  uint32_t lastSeenMs;
+  uint32_t frames;      // Accepted samples
+  uint32_t duplicates;  // Retransmitted or replayed frames dropped
+  uint32_t missed;      // Samples lost (gaps in the sequence)
+  bool pending;         // Accepted but not yet published
+};
+
+// Deduplicates sample frames from leaf nodes and keeps the latest reading per
+// leaf. Leaves are identified by MAC address and get a fixed index (HomeKit
+// accessory, Blynk pin group) in order of first contact.
+//
+// Transport-independent, so it runs unchanged on the host.
+class GatewayAggregator {
+private:
+  LeafRecord leaves[GATEWAY_MAX_LEAVES];
+  uint8_t count;
+  uint32_t rejected;
+
+  int findOrAdd(const uint8_t* mac);
+
+public:
+  // Older sequence numbers within this window count as duplicates; anything
+  // further back is taken as a leaf that lost its RTC memory
+  static const int16_t DUPLICATE_WINDOW = 64;
+
+  GatewayAggregator();
+  void reset();
+
+  // Returns the leaf index for a new sample, -1 for duplicates or a full table
+  int accept(const uint8_t* mac, const SampleFrame& frame, uint32_t nowMs);
+
+  // Next leaf with an unpublished sample (clears its pending flag), -1 if none
+  int takePending();
+
+  const LeafRecord& leaf(uint8_t index) const { return leaves[index]; }
+  uint8_t leafCount() const { return count; }
+  uint32_t rejectedCount() const { return rejected; } // Frames from leaves beyond GATEWAY_MAX_LEAVES
+};
+
+#endif // GATEWAY_AGGREGATOR_H
@@ -0,0 +1,43 @@
+#ifndef GATEWAY_NODE_H
+#define GATEWAY_NODE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+#include "hal.h"
+#include "gateway_aggregator.h"
+
+// Gateway role: receives leaf sample frames over Hal::peers() and feeds them
+// to the aggregator. Frames arrive on the radio task, so they are handed to
+// loop() through a single-producer/single-consumer queue.
+class GatewayNode {
+private:
+  struct RawFrame {
+    uint8_t mac[6];
+    uint8_t data[SAMPLE_FRAME_SIZE];
+    uint8_t length;
+  };
+
+  static const uint8_t QUEUE_SIZE = 16;
+  static RawFrame queue[QUEUE_SIZE];
+  static std::atomic<uint8_t> head; // Written by the radio task
+  static std::atomic<uint8_t> tail; // Written by loop()
+  static uint32_t overflows;
+  static std::atomic<uint32_t> malformed; // Counted by the radio task and by poll()
+  static GatewayAggregator leafAggregator;
+
+  static void onReceive(const uint8_t* mac, const uint8_t* data, size_t length);
+
+public:
+  // Start listening; call after WiFi so the radio is on the access point's channel
+  static bool begin();
+
+  // Drain received frames into the aggregator; returns the number of new samples
+  static int poll();
+
+  static GatewayAggregator& aggregator() { return leafAggregator; }
+
+  static void printStats();
+};
+
+#endif // GATEWAY_NODE_H
@@ -0,0 +1,202 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Hardware abstraction layer
+//
+// Thin interfaces over the Arduino, ESP-IDF, HomeSpan and Blynk calls the
+// managers depend on. On target they are backed by hal_esp32.cpp and
+// hal_esp32_publishers.cpp, on the host ([env:native]) by the fakes in
+// hal_fake.h, so the sensing-and-publishing pipeline builds and runs on Linux.
+//
+// State that has to survive deep sleep is declared RTC_DATA_ATTR. The loader
+// fills RTC memory at power-on only, but C++ constructors run on every boot,
+// wakes included, so an object kept there must be trivially constructible or
+// the constructor would wipe what it carried over. Such classes take their
+// settings through configure() on each boot instead.
+
+enum class WakeCause {
+  PowerOn,
+  Timer,
+  ExternalRtcIo,
+  ExternalRtcCntl,
+  Touchpad,
+  Ulp
+};
+
+enum class HalPinMode {
+  Input,
+  InputPullup,
+  Output,
+  OutputOpenDrain
+};
+
+// Monotonic time since boot
+class HalClock {
+public:
+  virtual ~HalClock() = default;
+  virtual unsigned long millis() = 0;
+  virtual unsigned long micros() = 0;
+  virtual void delay(unsigned long ms) = 0;
+  virtual void delayMicros(unsigned long us) = 0; // Busy wait, for bit-banged bus timing
+  // RTC timer: keeps counting through deep sleep, restarts at power-on; runs
+  // off the RTC slow clock, so it drifts against real time
+  virtual uint64_t rtcMicros() = 0;
+};
+
+// Sleep, wake-up sources and chip status
+class HalPower {
+public:
+  virtual ~HalPower() = default;
+  virtual WakeCause wakeCause() = 0;
+  virtual void enableTimerWakeup(uint64_t microseconds) = 0;
+  virtual void deepSleep() = 0; // Does not return on target
+  virtual uint32_t freeHeap() = 0;
+  virtual uint32_t minFreeHeap() = 0; // Low-water mark since boot
+  virtual uint32_t cpuFrequencyMhz() = 0;
+  // Fixed CPU clock (80, 160 or 240 MHz keep the radio usable)
+  virtual void setCpuFrequencyMhz(uint32_t mhz) = 0;
+  // Dynamic frequency scaling between minMhz and maxMhz, optionally with
+  // automatic light sleep when idle; false if the mode is not supported
+  virtual bool configurePowerManagement(uint32_t maxMhz, uint32_t minMhz, bool lightSleep) = 0;
+  // Keep the CPU at the configured maximum while held
+  virtual void holdCpuFrequency(bool hold) = 0;
+};
+
+// WiFi station
+class HalNetwork {
+public:
+  virtual ~HalNetwork() = default;
+  virtual void begin(const char* ssid, const char* password) = 0; // Non-blocking
+  virtual void reconnect() = 0; // Reuse the stored credentials
+  virtual bool isConnected() = 0;
+  virtual void shutdown() = 0;  // Disconnect and turn the radio off
+  virtual void setModemSleep(bool enabled) = 0; // Radio naps between DTIM beacons, stays associated
+  virtual long rssi() = 0;
+  virtual String localIP() = 0;
+  virtual String macAddress() = 0;
+};
+
+// GPIO and I2C
+class HalBus {
+public:
+  virtual ~HalBus() = default;
+  virtual void pinMode(uint8_t pin, HalPinMode mode) = 0;
+  virtual void digitalWrite(uint8_t pin, bool high) = 0;
+  virtual bool digitalRead(uint8_t pin) = 0;
+  virtual void i2cBegin(int sda, int scl) = 0;
+  virtual void i2cEnd() = 0;
+  // ADC reading in millivolts at the pin, corrected with the chip's factory calibration
+  virtual uint32_t analogReadMillivolts(uint8_t pin) = 0;
+};
+
+// Blynk cloud session
+class HalBlynkLink {
+public:
+  virtual ~HalBlynkLink() = default;
+  virtual void begin(const char* authToken, const char* ssid, const char* password) = 0;
+  virtual bool connected() = 0;
+  virtual void run() = 0;
+  virtual void virtualWrite(int pin, float value) = 0;
+  virtual void virtualWrite(int pin, const char* value) = 0;
+  virtual void logEvent(const char* eventCode, const char* description) = 0;
+  virtual void setConnectionCallbacks(void (*onConnected)(), void (*onDisconnected)()) = 0;
+};
+
+// MQTT 3.1.1 client: clean session, QoS 0 publishes
+class HalMqttLink {
+public:
+  virtual ~HalMqttLink() = default;
+  // Empty username connects anonymously
+  virtual bool connect(const char* host, uint16_t port, const char* clientId, const char* username,
+                       const char* password, uint16_t keepAliveSeconds) = 0;
+  virtual bool connected() = 0;
+  virtual bool publish(const char* topic, const uint8_t* payload, size_t length) = 0;
+  virtual void disconnect() = 0;
+};
+
+// Connectionless frames between nodes (ESP-NOW), no access point association
+class HalPeerLink {
+public:
+  typedef void (*ReceiveCallback)(const uint8_t* mac, const uint8_t* data, size_t length);
+
+  virtual ~HalPeerLink() = default;
+  virtual bool begin(uint8_t channel) = 0; // Channel is used only when not associated
+  // Blocks until the peer acknowledges (unicast) or the frame is on air (broadcast)
+  virtual bool send(const uint8_t* peerMac, const uint8_t* data, size_t length) = 0;
+  virtual void setReceiveCallback(ReceiveCallback onReceive) = 0; // Called from the radio task
+  virtual void end() = 0;
+};
+
+// TCP listener for the local HTTP endpoint: one client at a time, every
+// call returns immediately
+class HalHttpLink {
+public:
+  virtual ~HalHttpLink() = default;
+  virtual bool begin(uint16_t port) = 0;
+  // Keep the current client or take a pending one; true while one is connected
+  virtual bool accept() = 0;
+  // Bytes received so far, up to capacity (0 when none are waiting)
+  virtual size_t read(uint8_t* buffer, size_t capacity) = 0;
+  // Bytes the send buffer takes now, up to length (0 when it is full); never waits
+  virtual size_t write(const uint8_t* data, size_t length) = 0;
+  virtual void closeClient() = 0;
+  virtual void end() = 0;
+};
+
+// UDP socket over the WiFi association; every call returns immediately
+class HalDatagramLink {
+public:
+  virtual ~HalDatagramLink() = default;
+  virtual bool begin(uint16_t localPort) = 0;
+  virtual bool sendTo(const char* host, uint16_t port, const uint8_t* data, size_t length) = 0;
+  // Next waiting datagram, truncated to capacity (0 when none is waiting)
+  virtual size_t receive(uint8_t* buffer, size_t capacity) = 0;
+  virtual void end() = 0;
+};
+
+// SNTP client: request() starts one exchange and returns at once
+class HalTimeSync {
+public:
+  virtual ~HalTimeSync() = default;
+  virtual bool request(const char* server) = 0;
+  // True once the answer has arrived, with UTC (microseconds since the epoch) as of now
+  virtual bool poll(uint64_t& unixMicros) = 0;
+  virtual void end() = 0;
+};
+
+// HomeSpan accessory exposing the temperature and humidity services
+class HalHomeKitLink {
+public:
+  virtual ~HalHomeKitLink() = default;
+  virtual void begin(const char* deviceName) = 0;
+  // Bridge: local sensors plus one bridged accessory per leaf node
+  virtual void beginBridge(const char* deviceName, uint8_t leafCount) = 0;
+  virtual void poll() = 0;
+  virtual void setTemperature(float temperature) = 0;
+  virtual void setHumidity(float humidity) = 0;
+  virtual void setLeafReading(uint8_t leaf, float temperature, float humidity) = 0;
+  // BatteryService on the sensor accessory (present when the battery monitor is enabled)
+  virtual void setBatteryLevel(uint8_t percent, bool low) = 0;
+};
+
+// Accessors for the active implementation
+class Hal {
+public:
+  static HalClock& clock();
+  static HalPower& power();
+  static HalNetwork& network();
+  static HalBus& bus();
+  static HalPeerLink& peers();
+  static HalBlynkLink& blynk();
+  static HalMqttLink& mqtt();
+  static HalHttpLink& http();
+  static HalDatagramLink& datagram();
+  static HalTimeSync& timeSync();
+  static HalHomeKitLink& homekit();
+};
+
+#endif // HAL_H
@@ -0,0 +1,419 @@
+#ifndef HAL_FAKE_H
+#define HAL_FAKE_H
+
+#include "hal.h"
+
+#ifndef ARDUINO
+
+#include <map>
+
+// Host fakes behind the HAL ([env:native] only).
+// Time is simulated: delay() advances the clock instantly, so long runs and
+// replays finish far faster than real time.
+
+class FakeClock : public HalClock {
+private:
+  uint64_t nowMicros = 0;
+  uint64_t bootMicros = 0;
+  double rtcMicrosElapsed = 0.0; // Advances at the drifted rate
+  double rtcDriftPpm = 0.0;
+
+public:
+  unsigned long millis() override { return (nowMicros - bootMicros) / 1000; }
+  unsigned long micros() override { return nowMicros - bootMicros; }
+  void delay(unsigned long ms) override { advanceMicros(ms * 1000ULL); }
+  void delayMicros(unsigned long us) override { advanceMicros(us); }
+  uint64_t rtcMicros() override { return (uint64_t)rtcMicrosElapsed; }
+
+  // RTC slow clock error against the simulated (true) time from now on; positive runs fast
+  void setRtcDrift(double ppm) { rtcDriftPpm = ppm; }
+  void advanceMicros(uint64_t microseconds) {
+    nowMicros += microseconds;
+    rtcMicrosElapsed += microseconds * (1.0 + rtcDriftPpm * 1e-6);
+  }
+  // Simulated time since the fakes were reset; keeps running across reboots
+  uint64_t totalMicros() const { return nowMicros; }
+  // millis()/micros() restart from zero, as after a deep sleep wake-up
+  void reboot() { bootMicros = nowMicros; }
+  void reset() {
+    nowMicros = 0;
+    bootMicros = 0;
+    rtcMicrosElapsed = 0.0;
+    rtcDriftPpm = 0.0;
+  }
+};
+
+class FakePower : public HalPower {
+private:
+  WakeCause cause = WakeCause::PowerOn;
+  uint64_t timerWakeupMicros = 0;
+  bool sleepRequested = false;
+  uint64_t sleptMicros = 0;
+  uint32_t heap = 200000;
+  uint32_t heapLowWater = 200000;
+  uint32_t cpuMhz = 240;
+  bool pmConfigured = false;
+  uint32_t pmMaxMhz = 240;
+  uint32_t pmMinMhz = 240;
+  bool lightSleep = false;
+  bool lightSleepSupported = true;
+  bool cpuHeld = false;
+
+public:
+  WakeCause wakeCause() override { return cause; }
+  void enableTimerWakeup(uint64_t microseconds) override { timerWakeupMicros = microseconds; }
+  void deepSleep() override { sleepRequested = true; }
+  uint32_t freeHeap() override { return heap; }
+  uint32_t minFreeHeap() override { return heapLowWater; }
+  uint32_t cpuFrequencyMhz() override;
+  void setCpuFrequencyMhz(uint32_t mhz) override { cpuMhz = mhz; }
+  bool configurePowerManagement(uint32_t maxMhz, uint32_t minMhz, bool lightSleep) override;
+  void holdCpuFrequency(bool hold) override { cpuHeld = hold; }
+
+  bool deepSleepRequested() const { return sleepRequested; }
+  uint64_t timerWakeup() const { return timerWakeupMicros; }
+  // Total simulated time spent in deep sleep
+  uint64_t sleepMicros() const { return sleptMicros; }
+  void setFreeHeap(uint32_t bytes) {
+    heap = bytes;
+    if (bytes < heapLowWater) {
+      heapLowWater = bytes;
+    }
+  }
+  bool isLightSleepEnabled() const { return pmConfigured && lightSleep; }
+  bool isCpuFrequencyHeld() const { return cpuHeld; }
+  // Emulate an SDK built without tickless idle
+  void setLightSleepSupported(bool supported) { lightSleepSupported = supported; }
+  // Let the armed timer expire and reboot with a timer wake-up cause
+  void wakeFromDeepSleep();
+  void reset();
+};
+
+class FakeNetwork : public HalNetwork {
+private:
+  bool accessPointAvailable = true;
+  unsigned long associationDelayMs = 1500;
+  bool radioOn = false;
+  bool modemSleep = false;
+  uint64_t connectStartedMicros = 0;
+  uint64_t accumulatedRadioMicros = 0;
+
+public:
+  void begin(const char* ssid, const char* password) override;
+  void reconnect() override;
+  bool isConnected() override;
+  void shutdown() override;
+  long rssi() override { return isConnected() ? -55 : 0; }
+  String localIP() override { return isConnected() ? "192.168.4.2" : "0.0.0.0"; }
+  String macAddress() override { return "24:0A:C4:00:00:01"; }
+  void setModemSleep(bool enabled) override { modemSleep = enabled; }
+
+  void setAccessPointAvailable(bool available) { accessPointAvailable = available; }
+  void setAssociationDelay(unsigned long ms) { associationDelayMs = ms; }
+  bool isRadioOn() const { return radioOn; }
+  bool isModemSleepEnabled() const { return modemSleep; }
+  // Total simulated time the radio has been powered
+  uint64_t radioOnMicros() const;
+  void reset();
+};
+
+class FakeBus : public HalBus {
+private:
+  static const uint8_t PIN_COUNT = 40;
+  bool levels[PIN_COUNT] = {};
+  HalPinMode modes[PIN_COUNT] = {};
+  int i2cBeginCount = 0;
+  int i2cEndCount = 0;
+  // Stuck I2C slave: holds the data line low until it sees enough clock pulses
+  uint8_t heldPin = PIN_COUNT;
+  uint8_t clockPin = PIN_COUNT;
+  int pulsesUntilRelease = 0;
+  unsigned long clockPulses = 0;
+  uint32_t analogMillivolts[PIN_COUNT] = {};
+
+public:
+  void pinMode(uint8_t pin, HalPinMode mode) override;
+  void digitalWrite(uint8_t pin, bool high) override;
+  bool digitalRead(uint8_t pin) override;
+  void i2cBegin(int sda, int scl) override;
+  void i2cEnd() override { i2cEndCount++; }
+  uint32_t analogReadMillivolts(uint8_t pin) override { return pin < PIN_COUNT ? analogMillivolts[pin] : 0; }
+
+  void setAnalogMillivolts(uint8_t pin, uint32_t millivolts) {
+    if (pin < PIN_COUNT) analogMillivolts[pin] = millivolts;
+  }
+  void setLevel(uint8_t pin, bool high) { if (pin < PIN_COUNT) levels[pin] = high; }
+  // Hold dataPin low until clockPin has risen this many times (-1: never release)
+  void holdLineLow(uint8_t dataPin, uint8_t clock, int releaseAfterPulses);
+  bool isLineHeld() const { return pulsesUntilRelease != 0; }
+  unsigned long clockPulseCount() const { return clockPulses; }
+  int i2cBeginCalls() const { return i2cBeginCount; }
+  int i2cEndCalls() const { return i2cEndCount; }
+  void reset();
+};
+
+// In-process loopback: frames sent are handed straight to the receive
+// callback, so a leaf and the gateway aggregation can run in one process.
+class FakePeerLink : public HalPeerLink {
+private:
+  bool started = false;
+  bool peerAvailable = true;
+  uint8_t localMac[6] = { 0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01 };
+  ReceiveCallback receiveCallback = nullptr;
+  unsigned long sent = 0;
+  unsigned long delivered = 0;
+  uint64_t startedMicros = 0;
+  uint64_t accumulatedRadioMicros = 0;
+
+public:
+  bool begin(uint8_t channel) override;
+  bool send(const uint8_t* peerMac, const uint8_t* data, size_t length) override;
+  void setReceiveCallback(ReceiveCallback onReceive) override { receiveCallback = onReceive; }
+  void end() override;
+
+  // Source address of looped-back frames, to impersonate several leaves
+  void setLocalMac(const uint8_t* mac);
+  // Simulate the gateway being out of range (sends are not acknowledged)
+  void setPeerAvailable(bool available) { peerAvailable = available; }
+  unsigned long sendCount() const { return sent; }
+  unsigned long deliveredCount() const { return delivered; }
+  // Total simulated time the radio has been on for peer frames
+  uint64_t radioOnMicros() const;
+  void reset();
+};
+
+class FakeBlynkLink : public HalBlynkLink {
+private:
+  bool serverAvailable = true;
+  bool sessionOpen = false;
+  unsigned long loginLatencyMs = 350; // Cloud round trips: TCP, login, hardware info
+  unsigned long writes = 0;
+  unsigned long events = 0;
+  unsigned long bytes = 0;
+  std::map<int, String> lastValues;
+  std::map<int, unsigned long> pinWrites;
+  void (*connectedCallback)() = nullptr;
+  void (*disconnectedCallback)() = nullptr;
+
+  void record(int pin, const String& value);
+
+public:
+  void begin(const char* authToken, const char* ssid, const char* password) override;
+  bool connected() override;
+  void run() override { connected(); }
+  void virtualWrite(int pin, float value) override { record(pin, String(value, 3)); }
+  void virtualWrite(int pin, const char* value) override { record(pin, String(value)); }
+  void logEvent(const char* eventCode, const char* description) override;
+  void setConnectionCallbacks(void (*onConnected)(), void (*onDisconnected)()) override;
+
+  void setServerAvailable(bool available) { serverAvailable = available; }
+  void setLoginLatency(unsigned long ms) { loginLatencyMs = ms; }
+  // Session state is lost with the chip reset, without a disconnect callback
+  void powerCycle() { sessionOpen = false; }
+  unsigned long writeCount() const { return writes; }
+  unsigned long writeCount(int pin) const;
+  unsigned long eventCount() const { return events; }
+  // Approximate bytes on the wire (Blynk frame header plus "vw" body)
+  unsigned long bytesSent() const { return bytes; }
+  String lastValue(int pin) const;
+  void reset();
+};
+
+// Local broker stand-in: accepts clean-session connects and records QoS 0
+// publishes, charging the simulated clock for the connect round trip.
+class FakeMqttLink : public HalMqttLink {
+private:
+  bool brokerAvailable = true;
+  bool sessionOpen = false;
+  unsigned long connectLatencyMs = 40; // TCP handshake plus CONNECT/CONNACK on a LAN broker
+  unsigned long sessions = 0;
+  unsigned long publishes = 0;
+  unsigned long bytes = 0;
+  uint16_t keepAlive = 0;
+  String lastTopicValue;
+  String lastPayloadValue;
+
+public:
+  bool connect(const char* host, uint16_t port, const char* clientId, const char* username,
+               const char* password, uint16_t keepAliveSeconds) override;
+  bool connected() override;
+  bool publish(const char* topic, const uint8_t* payload, size_t length) override;
+  void disconnect() override;
+
+  void setBrokerAvailable(bool available) { brokerAvailable = available; }
+  void setConnectLatency(unsigned long ms) { connectLatencyMs = ms; }
+  void powerCycle() { sessionOpen = false; }
+  unsigned long sessionCount() const { return sessions; }
+  unsigned long publishCount() const { return publishes; }
+  // MQTT packet bytes sent (CONNECT, PUBLISH, DISCONNECT)
+  unsigned long bytesSent() const { return bytes; }
+  uint16_t keepAliveSeconds() const { return keepAlive; }
+  String lastTopic() const { return lastTopicValue; }
+  String lastPayload() const { return lastPayloadValue; }
+  void reset();
+};
+
+// Scrape client stand-in: queued requests are accepted one at a time and
+// delivered in chunks, and the full response is kept for inspection.
+class FakeHttpLink : public HalHttpLink {
+private:
+  static const uint8_t MAX_PENDING = 4;
+
+  bool listening = false;
+  uint16_t listenPort = 0;
+  String pending[MAX_PENDING];
+  uint8_t pendingCount = 0;
+  bool clientOpen = false;
+  String request;
+  size_t requestOffset = 0;
+  size_t chunkBytes = 64; // Bytes a client delivers per read()
+  size_t sendBufferBytes = SIZE_MAX; // write() capacity per accept() pass
+  size_t sendBufferFree = SIZE_MAX;
+  String response;
+  String lastResponseValue;
+  unsigned long served = 0;
+  unsigned long written = 0;
+
+public:
+  bool begin(uint16_t port) override;
+  bool accept() override;
+  size_t read(uint8_t* buffer, size_t capacity) override;
+  size_t write(const uint8_t* data, size_t length) override;
+  void closeClient() override;
+  void end() override;
+
+  // Queue a client that sends this raw request; false when the backlog is full
+  bool queueRequest(const char* raw);
+  void setChunkSize(size_t bytes) { chunkBytes = bytes > 0 ? bytes : 1; }
+  // Bytes write() takes until the next accept(), when the client has read
+  // them; 0 is a client that stopped reading
+  void setSendBufferSize(size_t bytes) { sendBufferBytes = bytes; }
+  bool isListening() const { return listening; }
+  uint16_t port() const { return listenPort; }
+  // Response of the last closed connection
+  String lastResponse() const { return lastResponseValue; }
+  unsigned long closedCount() const { return served; }
+  unsigned long bytesWritten() const { return written; }
+  void reset();
+};
+
+// Bound socket plus a stand-in echo server on the LAN: every datagram sent
+// while associated comes back after the echo delay. Every n-th one can be
+// lost or echoed twice, to exercise gap and duplicate detection.
+class FakeDatagramLink : public HalDatagramLink {
+private:
+  static const uint8_t MAX_IN_FLIGHT = 8;
+
+  struct Echo {
+    String payload;
+    uint64_t dueMicros;
+  };
+
+  bool bound = false;
+  Echo inFlight[MAX_IN_FLIGHT];
+  uint8_t inFlightCount = 0;
+  unsigned long echoDelayMs = 20;
+  unsigned long dropEvery = 0;      // 0: never
+  unsigned long duplicateEvery = 0; // 0: never
+  unsigned long sent = 0;
+  unsigned long echoed = 0;
+
+  void queueEcho(const String& payload);
+
+public:
+  bool begin(uint16_t localPort) override;
+  bool sendTo(const char* host, uint16_t port, const uint8_t* data, size_t length) override;
+  size_t receive(uint8_t* buffer, size_t capacity) override;
+  void end() override;
+
+  void setEchoDelay(unsigned long ms) { echoDelayMs = ms; }
+  void setDropEvery(unsigned long n) { dropEvery = n; }
+  void setDuplicateEvery(unsigned long n) { duplicateEvery = n; }
+  bool isBound() const { return bound; }
+  unsigned long sentCount() const { return sent; }
+  unsigned long echoedCount() const { return echoed; }
+  void reset();
+};
+
+// SNTP server on the simulated clock: true UTC is EPOCH_MICROS plus the
+// simulated time, answered after a round trip while associated. The answer
+// can be given a fixed error to check that it stays within the bound.
+class FakeTimeSync : public HalTimeSync {
+private:
+  bool pending = false;
+  uint64_t answerDueMicros = 0;
+  unsigned long roundTripMs = 40;
+  long answerErrorMs = 0;
+  bool serverAvailable = true;
+  unsigned long requests = 0;
+  unsigned long answers = 0;
+
+public:
+  static const uint64_t EPOCH_MICROS = 1767225600ULL * 1000000ULL; // 2026-01-01T00:00:00Z
+
+  bool request(const char* server) override;
+  bool poll(uint64_t& unixMicros) override;
+  void end() override { pending = false; }
+
+  uint64_t trueUnixMicros() const;
+  void setRoundTrip(unsigned long ms) { roundTripMs = ms; }
+  void setAnswerError(long ms) { answerErrorMs = ms; }
+  void setServerAvailable(bool available) { serverAvailable = available; }
+  unsigned long requestCount() const { return requests; }
+  unsigned long answerCount() const { return answers; }
+  void reset();
+};
+
+class FakeHomeKitLink : public HalHomeKitLink {
+private:
+  bool started = false;
+  uint8_t bridgedLeaves = 0;
+  float temperature = 20.0f;
+  float humidity = 50.0f;
+  unsigned long updates = 0;
+  unsigned long leafUpdates = 0;
+  int batteryPercent = -1;
+  bool batteryLow = false;
+
+public:
+  void begin(const char* deviceName) override { (void)deviceName; started = true; }
+  void beginBridge(const char* deviceName, uint8_t leafCount) override;
+  void poll() override {}
+  void setTemperature(float value) override { temperature = value; updates++; }
+  void setHumidity(float value) override { humidity = value; updates++; }
+  void setLeafReading(uint8_t leaf, float leafTemperature, float leafHumidity) override;
+  void setBatteryLevel(uint8_t percent, bool low) override { batteryPercent = percent; batteryLow = low; }
+
+  bool isStarted() const { return started; }
+  uint8_t bridgedLeafCount() const { return bridgedLeaves; }
+  unsigned long leafUpdateCount() const { return leafUpdates; }
+  float currentTemperature() const { return temperature; }
+  float currentHumidity() const { return humidity; }
+  unsigned long updateCount() const { return updates; }
+  int currentBatteryLevel() const { return batteryPercent; } // -1 until first set
+  bool isBatteryLow() const { return batteryLow; }
+  void reset();
+};
+
+// Typed access to the fakes installed behind Hal::*()
+class FakeHal {
+public:
+  static FakeClock& clock();
+  static FakePower& power();
+  static FakeNetwork& network();
+  static FakeBus& bus();
+  static FakePeerLink& peers();
+  static FakeBlynkLink& blynk();
+  static FakeMqttLink& mqtt();
+  static FakeHttpLink& http();
+  static FakeDatagramLink& datagram();
+  static FakeTimeSync& timeSync();
+  static FakeHomeKitLink& homekit();
+
+  // Restore every fake to its power-on state
+  static void reset();
+};
+
+#endif // ARDUINO
+
+#endif // HAL_FAKE_H
@@ -2,47 +2,26 @@
 #define HOMEKIT_MANAGER_H
 
 #include <Arduino.h>
-#include <WiFi.h>
 #include "config.h"
+#include "hal.h"
 
 #if HOMEKIT_ENABLED
-#include "HomeSpan.h"
-
-// HomeSpan Temperature Sensor Service
-struct TemperatureSensor : Service::TemperatureSensor {
-  SpanCharacteristic *temp;
-
-  TemperatureSensor() : Service::TemperatureSensor() {
-    temp = new Characteristic::CurrentTemperature(20.0);
-    temp->setRange(-40, 100);
-  }
-
-  void updateTemperature(float newTemp) { temp->setVal(newTemp); }
-};
-
-// HomeSpan Humidity Sensor Service
-struct HumiditySensor : Service::HumiditySensor {
-  SpanCharacteristic *humidity;
-
-  HumiditySensor() : Service::HumiditySensor() {
-    humidity = new Characteristic::CurrentRelativeHumidity(50.0);
-    humidity->setRange(0, 100);
-  }
-
-  void updateHumidity(float newHumidity) { humidity->setVal(newHumidity); }
-};
 
 class HomeKitManager {
 private:
-  TemperatureSensor *tempSensor;
-  HumiditySensor *humSensor;
   bool initialized;
 
+  bool start(const String& deviceName, uint8_t leafCount);
+
 public:
   HomeKitManager();
   bool begin(const String& deviceName);
+  // Gateway: bridge with one accessory per leaf node
+  bool beginBridge(const String& deviceName, uint8_t leafCount);
   void poll();
   void updateSensorData(float temperature, float humidity);
+  void updateLeafData(uint8_t leaf, float temperature, float humidity);
+  void updateBattery(uint8_t percent, bool low);
   bool isInitialized() const { return initialized; }
 };
 
@@ -50,10 +29,19 @@ public:
 
 // WiFi management functions
 class WiFiManager {
+private:
+  static const unsigned long CONNECT_POLL_INTERVAL = 50; // milliseconds
+  static unsigned long reconnects;
+
 public:
+  // Blocking connect: beginConnect() followed by waitForConnection()
   static void connect();
+  // Start association without waiting, so other bring-up can overlap it
+  static void beginConnect();
+  static bool waitForConnection(unsigned long timeoutMs);
   static void checkStatus();
-  static bool isConnected() { return WiFi.status() == WL_CONNECTED; }
+  static bool isConnected() { return Hal::network().isConnected(); }
+  static unsigned long getReconnectCount() { return reconnects; }
 };
 
 #endif
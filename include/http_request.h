@@ -0,0 +1,57 @@
+#ifndef HTTP_REQUEST_H
+#define HTTP_REQUEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Incremental HTTP/1.x request parser for the local metrics endpoint.
+//
+// Bytes can arrive in any split across reads. Only the request line is kept
+// (method and path); header fields are scanned for the terminating blank
+// line and discarded, so memory use is fixed no matter what the client sends.
+
+enum class HttpParseStatus : uint8_t {
+  Incomplete,  // Need more bytes
+  Complete,    // Request line and headers received
+  Malformed,   // Not an HTTP/1.x request line
+  TooLarge     // Request line or header block over the limit
+};
+
+enum class HttpMethod : uint8_t {
+  Get,
+  Head,
+  Other
+};
+
+class HttpRequestParser {
+public:
+  static const size_t MAX_REQUEST_LINE = 128;  // Including the terminator
+  static const size_t MAX_HEADER_BYTES = 2048;
+
+private:
+  char line[MAX_REQUEST_LINE];
+  size_t lineLength;
+  size_t headerBytes;
+  bool lineDone;
+  bool atLineStart;  // Only CR seen since the last LF
+  HttpParseStatus status;
+  HttpMethod requestMethod;
+  const char* requestPath;
+
+  HttpParseStatus parseRequestLine();
+
+public:
+  HttpRequestParser();
+
+  void reset();
+
+  // Consume bytes; once the status is no longer Incomplete further bytes are ignored
+  HttpParseStatus feed(const uint8_t* data, size_t length);
+
+  HttpParseStatus getStatus() const { return status; }
+  // Valid once Complete; the path excludes any query string
+  HttpMethod getMethod() const { return requestMethod; }
+  const char* getPath() const { return requestPath; }
+};
+
+#endif // HTTP_REQUEST_H
@@ -0,0 +1,19 @@
+#ifndef I2C_RECOVERY_H
+#define I2C_RECOVERY_H
+
+#include <stdint.h>
+
+// I2C bus clear (UM10204 section 3.1.16).
+//
+// A slave reset or brown-out in the middle of a read can leave it driving
+// SDA low, waiting for clock pulses that never come; every later
+// transaction then fails. The controller is detached, SCL is toggled by hand
+// until the slave lets go of SDA (at most I2C_RECOVERY_PULSES, enough to
+// finish any byte plus the acknowledge bit), and a STOP condition resets the
+// bus state of every slave. The caller re-attaches the controller
+// (Wire.begin) afterwards.
+//
+// Returns true when SDA is high (released) at the end.
+bool recoverI2cBus(uint8_t sdaPin, uint8_t sclPin);
+
+#endif // I2C_RECOVERY_H
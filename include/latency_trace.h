@@ -0,0 +1,62 @@
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <stdint.h>
+
+// Latency distribution in fixed millisecond buckets (Prometheus-style upper
+// bounds, plus an overflow bucket). Constant memory and O(buckets) to
+// record, so one can be kept per sink and per stage.
+class LatencyHistogram {
+public:
+  static const uint8_t BUCKETS = 11;
+  static const uint32_t BOUNDS_MS[BUCKETS];
+
+private:
+  uint32_t counts[BUCKETS + 1]; // [BUCKETS]: above the last bound
+  uint32_t total;
+  uint64_t sumMs;
+  uint32_t maxMs;
+
+public:
+  LatencyHistogram() { reset(); }
+  void reset();
+  void record(uint32_t ms);
+
+  uint32_t getCount() const { return total; }
+  uint64_t getSumMs() const { return sumMs; }
+  uint32_t getMaxMs() const { return maxMs; }
+  uint32_t getMeanMs() const { return total > 0 ? (uint32_t)(sumMs / total) : 0; }
+  // Samples at or below BOUNDS_MS[bucket] (cumulative, as Prometheus expects)
+  uint32_t getCumulativeCount(uint8_t bucket) const;
+  // Upper bound of the bucket holding the given quantile (0..1); the
+  // observed maximum when it falls in the overflow bucket
+  uint32_t getQuantileMs(float quantile) const;
+};
+
+// Gap and duplicate detection on a stream of sequence numbers, the same way
+// GatewayAggregator checks leaf frames: a number at or below the last one
+// seen is a duplicate (re-sent, or arrived late), a jump counts the numbers
+// skipped. A jump back by more than RESTART_WINDOW is taken as a restarted
+// numbering (power cycle) rather than a flood of duplicates.
+class SequenceTracker {
+private:
+  uint32_t last;
+  bool primed;
+  uint32_t gaps;       // Sequence numbers never seen
+  uint32_t duplicates;
+
+public:
+  static const int32_t RESTART_WINDOW = 64;
+
+  SequenceTracker() { reset(); }
+  void reset();
+
+  // False for a duplicate
+  bool observe(uint32_t sequence);
+
+  uint32_t getLast() const { return last; }
+  uint32_t getGaps() const { return gaps; }
+  uint32_t getDuplicates() const { return duplicates; }
+};
+
+#endif // LATENCY_TRACE_H
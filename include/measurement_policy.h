@@ -0,0 +1,82 @@
+#ifndef MEASUREMENT_POLICY_H
+#define MEASUREMENT_POLICY_H
+
+#include <stdint.h>
+
+// Conversion modes of sensors with a repeatability/energy trade-off (SHT4x:
+// about 1.6, 4.5 and 8.3 ms per conversion); values match SHT41_PRECISION_*
+enum class MeasurementPrecision : uint8_t {
+  Low = 0,
+  Medium = 1,
+  High = 2,
+};
+
+static const uint8_t MEASUREMENT_PRECISION_COUNT = 3;
+
+// What a reading is for
+enum class MeasurementPurpose : uint8_t {
+  Routine,   // Sensor-only alert checks away from any threshold
+  Threshold, // Checks close to (or inside) an alert threshold
+  Publish,   // Readings handed to the publishers
+};
+
+// Picks the conversion precision per reading and schedules heater pulses.
+//
+// Routine readings use the cheap precision; published readings and checks
+// that decide an alert use the precise one. While humidity stays at or above
+// heaterHumidity for heaterHoldMs, a heater pulse is due every
+// heaterIntervalMs to drive condensation off the sensing element; readings
+// within cooldownMs of a pulse see the heated die and should be skipped.
+//
+// Also keeps the conversion time per precision and the heater time, so the
+// cost of each mode shows up next to the wake duration. Times are passed in
+// so the policy runs on any clock. Call configure() on every boot.
+class MeasurementPolicy {
+private:
+  // Configuration
+  MeasurementPrecision routinePrecision;
+  MeasurementPrecision precisePrecision;
+  float heaterHumidity;
+  uint32_t heaterHoldMs;
+  uint32_t heaterIntervalMs;
+  uint32_t cooldownMs;
+
+  // State
+  bool humid;
+  uint64_t humidSinceMs;
+  bool heated;
+  uint64_t lastPulseMs;
+
+  // Statistics
+  uint32_t conversions[MEASUREMENT_PRECISION_COUNT];
+  uint64_t conversionMicros[MEASUREMENT_PRECISION_COUNT];
+  uint32_t maxConversionMicros[MEASUREMENT_PRECISION_COUNT];
+  uint32_t heaterPulses;
+  uint64_t heaterMicros;
+
+public:
+  void configure(MeasurementPrecision routine, MeasurementPrecision precise, float humidityLimit,
+                 uint32_t holdMs, uint32_t intervalMs, uint32_t heaterCooldownMs);
+  void reset();
+
+  MeasurementPrecision select(MeasurementPurpose purpose) const;
+
+  // Track how long humidity has stayed high
+  void observeHumidity(float humidity, uint64_t nowMs);
+  bool isHeaterDue(uint64_t nowMs) const;
+  void recordHeaterPulse(uint64_t nowMs, uint32_t durationMicros);
+  bool isCoolingDown(uint64_t nowMs) const;
+
+  // Duration of one reading (both channels) taken at this precision
+  void recordConversion(MeasurementPrecision precision, uint32_t durationMicros);
+  uint32_t getConversionCount(MeasurementPrecision precision) const;
+  uint32_t getMeanConversionMicros(MeasurementPrecision precision) const;
+  uint32_t getHeaterPulses() const { return heaterPulses; }
+
+  static const char* precisionName(MeasurementPrecision precision);
+
+  // Conversion time per precision and heater time, with METRIC lines
+  void printStats() const;
+};
+
+#endif // MEASUREMENT_POLICY_H
@@ -0,0 +1,96 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "hal.h"
+#include "http_request.h"
+#include "publish_dispatcher.h"
+
+// Values exposed on /metrics, gathered at scrape time
+struct MetricsSnapshot {
+  bool readingValid;             // False until the first good reading
+  float temperature;
+  float humidity;
+  float heatIndex;
+  unsigned long readings;
+  unsigned long readFailures;
+  uint8_t sensorHealth;          // SensorHealth: 0 healthy, 1 degraded, 2 offline, 3 recovering
+  unsigned long sensorRecoveries;
+  unsigned long sensorRecoveryMs; // Time to recovery of the last outage
+  unsigned long wifiReconnects;
+  unsigned long blynkReconnects;
+  unsigned long loopMicros;      // Last loop() pass, excluding the idle delay
+  unsigned long loopMaxMicros;
+  uint16_t batteryMillivolts;    // 0: no battery monitor or no cell
+  uint8_t batteryPercent;
+  uint8_t batteryTier;           // BatteryTier: 0 normal, 1 conserve, 2 low, 3 critical
+  bool timeSynced;               // False: no time service or no SNTP sync yet
+  uint32_t timeErrorMs;
+  float timeDriftPpm;
+  const PublishDispatcher* publishers; // Optional per-sink counters
+};
+
+typedef void (*MetricsCollector)(MetricsSnapshot& snapshot);
+
+// Local HTTP endpoint serving GET /metrics in Prometheus text format, so the
+// LAN can scrape the device without going through the Blynk cloud.
+//
+// service() is called from loop() and never waits: it accepts at most one
+// client, reads whatever bytes have arrived and answers once the request is
+// complete. Responses are rendered into a static buffer (nothing is
+// allocated per scrape) and written as the socket's send buffer takes them:
+// a full body is larger than that buffer, so it goes out over several passes.
+// A client that stalls, on its request or on reading the answer, is dropped
+// after METRICS_CLIENT_TIMEOUT, so homekit.poll() keeps its cadence.
+class MetricsServer {
+private:
+  static const size_t READ_CHUNK = 64;
+  static const uint8_t MAX_READS_PER_PASS = 4;
+  static const size_t HEADER_SIZE = 192;
+
+  static char body[METRICS_RESPONSE_SIZE];
+  static char header[HEADER_SIZE];
+  static size_t headerLength;
+  static const char* responseBody;   // body, a constant or nullptr
+  static size_t responseBodyLength;
+  static size_t responseOffset;      // Header and body bytes written so far
+  static bool responding;
+  static HttpRequestParser parser;
+  static MetricsCollector collector;
+  static bool started;
+  static bool clientActive;
+  static unsigned long clientStartMs;
+  static unsigned long scrapes;
+  static unsigned long rejected;
+  static unsigned long timeouts;
+  static unsigned long lastResponseMicros;
+  static unsigned long maxResponseMicros;
+
+  static void respond();
+  // Queue the response for sendPending(); content must outlive the client
+  static void sendResponse(int status, const char* reason, const char* extraHeaders,
+                           const char* content, size_t length, bool includeBody);
+  // Write what the send buffer takes now; true once the whole response is out
+  static bool sendPending();
+
+public:
+  // Listen on METRICS_SERVER_PORT; collect fills the snapshot for each scrape
+  static bool begin(MetricsCollector collect);
+
+  // Make progress on the current client, if any; returns immediately
+  static void service();
+
+  static void end();
+
+  // Render the metrics body; returns its length, 0 if it does not fit
+  static size_t render(const MetricsSnapshot& snapshot, char* buffer, size_t capacity);
+
+  static unsigned long getScrapeCount() { return scrapes; }
+  static unsigned long getRejectedCount() { return rejected; }
+  static unsigned long getTimeoutCount() { return timeouts; }
+
+  static void printStats();
+};
+
+#endif // METRICS_SERVER_H
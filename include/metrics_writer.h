@@ -0,0 +1,39 @@
+#ifndef METRICS_WRITER_H
+#define METRICS_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Renders Prometheus text exposition format (0.0.4) into a caller-owned
+// buffer without allocating. Once a metric does not fit, it and everything
+// after it are dropped and overflowed() reports it; the output always ends
+// on a complete line.
+class MetricsWriter {
+private:
+  char* buffer;
+  size_t capacity;
+  size_t used;
+  bool overflow;
+
+  void append(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+public:
+  MetricsWriter(char* buffer, size_t capacity);
+
+  // NaN is written as "NaN", which Prometheus accepts
+  void gauge(const char* name, const char* help, double value, uint8_t decimals = 2);
+  void counter(const char* name, const char* help, unsigned long value);
+
+  // One family with a sample per label value: family() then labelled() per sample
+  void family(const char* name, const char* help, const char* type);
+  void labelled(const char* name, const char* label, const char* labelValue, unsigned long value);
+  // Histogram bucket: labelled() plus the upper bound as le (NULL: +Inf)
+  void bucket(const char* name, const char* label, const char* labelValue, const unsigned long* le,
+              unsigned long value);
+
+  const char* data() const { return buffer; }
+  size_t length() const { return used; }
+  bool overflowed() const { return overflow; }
+};
+
+#endif // METRICS_WRITER_H
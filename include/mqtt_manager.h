@@ -0,0 +1,71 @@
+#ifndef MQTT_MANAGER_H
+#define MQTT_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#if MQTT_ENABLED
+#include "hal.h"
+
+// One queued reading; the time is PowerManager's monotonic clock at
+// acquisition, rtcUs the RTC timer for TimeService
+struct MqttSample {
+  uint64_t timeMs;
+  uint64_t rtcUs;
+  float temperature;
+  float humidity;
+  float heatIndex;
+};
+
+// Short-session MQTT publisher.
+//
+// Readings are queued with addSample() and flush() sends everything queued in
+// one packed QoS 0 payload inside a connect-publish-disconnect cycle with a
+// clean session, so no broker-side state or keepalive traffic outlives the
+// wake. The queue lives in RTC memory: readings taken while the broker is
+// unreachable go out with the next successful flush (oldest dropped when
+// MQTT_BACKLOG_SIZE is exceeded).
+//
+// Payload: {"sensor":"DHT11","samples":[[age_ms,temp,humidity,heat_index],...]}
+// with age_ms counted back from the moment of publishing. With the time
+// service synced, each sample also carries its UTC time and error bound:
+// [age_ms,temp,humidity,heat_index,unix_ms,error_ms]. Both are worked out at
+// publish time, so readings queued before the first sync are dated as well.
+class MqttManager {
+private:
+  static MqttSample backlog[MQTT_BACKLOG_SIZE]; // RTC memory
+  static uint8_t backlogStart;                  // RTC memory
+  static uint8_t backlogCount;                  // RTC memory
+  static char payload[MQTT_PAYLOAD_SIZE];
+
+  String sensorName;
+  unsigned long lastSessionMs;
+  unsigned long lastAttemptMs;
+  unsigned long dropped;
+
+  size_t buildPayload(uint64_t nowMs, uint8_t* sampleCount);
+
+public:
+  MqttManager();
+  void setSensorName(const String& name) { sensorName = name; }
+
+  // Queue a reading for the next flush(); times from its SampleStamp, so
+  // age_ms covers the wait for a sink slot or a later wake as well
+  void addSample(uint64_t acquiredMs, uint64_t rtcUs, float temperature, float humidity, float heatIndex);
+
+  // Connect, publish the whole queue as one payload, disconnect.
+  // Returns true once the queue has been handed to the broker.
+  bool flush();
+
+  // Flush a backlog the broker missed, PUBLISH_RETRY_BACKOFF after the last attempt
+  void service();
+
+  uint8_t pendingCount() const { return backlogCount; }
+  unsigned long getDroppedCount() const { return dropped; }
+  // Duration of the last connect-publish-disconnect cycle
+  unsigned long getLastSessionMs() const { return lastSessionMs; }
+};
+
+#endif // MQTT_ENABLED
+
+#endif // MQTT_MANAGER_H
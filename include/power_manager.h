@@ -3,12 +3,39 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "feature_settings.h"
+
+// Operating phases, each with its own CPU frequency policy
+enum class PowerPhase : uint8_t {
+  Idle,     // Between samples: frequency floor, automatic light sleep
+  Sample,   // Sensor reads
+  Publish,  // HomeKit/Blynk updates
+};
+
+static const uint8_t POWER_PHASE_COUNT = 3;
 
 class PowerManager {
 private:
   static unsigned long wakeupTime;
   static unsigned long operationStartTime;
   static bool deepSleepScheduled;
+  static unsigned long sleepDurationSeconds;
+  static unsigned long checkIntervalSeconds;
+  static uint8_t sleepMultiplier;
+  static uint32_t cpuCeilingMhz;
+  static uint64_t sleepOffsetMs; // RTC memory: time before this wake
+  static bool lowPowerModeActive;
+  static bool lightSleepActive;
+  static PowerPhase currentPhase;
+  static uint32_t phaseFrequencyMhz[POWER_PHASE_COUNT];
+  static uint64_t phaseMicros[POWER_PHASE_COUNT];
+  static unsigned long phaseStartMicros;
+
+  static void beginLowPowerMode();
+  static void applyPhasePolicy();
+  static void accumulatePhaseTime();
+  static float getPhaseCurrentMa(PowerPhase phase);
+  static uint32_t getPhaseFrequency(PowerPhase phase);
   
 public:
   PowerManager();
@@ -43,11 +70,53 @@ public:
   // Cancel scheduled deep sleep
   static void cancelDeepSleep();
   
-  // Check if deep sleep is enabled in configuration
-  static bool isDeepSleepEnabled();
+  // Set the next deep sleep duration and re-arm the wake-up timer
+  static void setSleepDuration(unsigned long seconds);
+  
+  // Get the next deep sleep duration in seconds
+  static unsigned long getSleepDuration();
+  
+  // Wake up at least this often for sensor-only checks (0 = off)
+  static void setCheckInterval(unsigned long seconds);
+  
+  // Stretch the sleep duration (not the check interval) by this factor
+  static void setSleepMultiplier(uint8_t multiplier);
+  
+  // Current sleep duration factor
+  static uint8_t getSleepMultiplier();
+  
+  // Seconds the wake-up timer is actually armed for
+  static unsigned long getArmedSleepDuration();
+  
+  // Milliseconds since first boot, continued across deep sleep
+  static uint64_t getMonotonicMillis();
+  
+  // Check if deep sleep is enabled in configuration (constant-folded)
+  static constexpr bool isDeepSleepEnabled() { return Features::DEEP_SLEEP; }
   
   // Print power statistics
   static void printPowerStats();
+  
+  // CPU frequency held while in a phase (Idle: ceiling for frequency scaling)
+  static void setPhaseFrequency(PowerPhase phase, uint32_t mhz);
+  
+  // Cap every phase frequency (and the fixed clock when scaling is off)
+  static void setCpuCeiling(uint32_t mhz);
+  
+  // Switch phase, apply its frequency policy and account the time spent
+  static void enterPhase(PowerPhase phase);
+  
+  // Current phase
+  static PowerPhase getPhase();
+  
+  // Check if frequency scaling / light sleep is in effect
+  static bool isLowPowerModeActive();
+  
+  // Average supply current estimated from the time spent in each phase
+  static float getAverageCurrentMa();
+  
+  // Print time per phase and the estimated average current
+  static void printPhaseStats();
 };
 
 #endif // POWER_MANAGER_H
@@ -0,0 +1,113 @@
+#ifndef PUBLISH_DISPATCHER_H
+#define PUBLISH_DISPATCHER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "publisher.h"
+#include "latency_trace.h"
+
+// What a full sink queue does with a new sample
+enum class QueuePolicy : uint8_t {
+  DropNewest,  // Keep the backlog, discard the incoming sample
+  Overwrite    // Discard the oldest queued sample (latest value matters most)
+};
+
+struct SinkOptions {
+  uint8_t queueCapacity;        // 1..PublishDispatcher::MAX_QUEUE_DEPTH
+  QueuePolicy policy;
+  uint8_t retryBudget;          // Failed attempts per sample before it is dropped
+  unsigned long retryBackoffMs; // Wait after a failed attempt
+};
+
+// Per-sink counters. Each sample is timed at acquisition (its timeMs), at
+// enqueue, when the sink accepts it and, for sinks whose server answers,
+// at the acknowledgement.
+struct SinkStats {
+  unsigned long delivered;
+  unsigned long dropped;        // Queue full (per policy)
+  unsigned long failed;         // Retry budget exhausted
+  unsigned long retries;
+  unsigned long lastLagMs;      // Sample time to delivery, last sample
+  unsigned long maxLagMs;
+  unsigned long lastQueueMs;    // Enqueue to delivery, last sample
+  unsigned long maxCallMs;      // Slowest publish() call
+  unsigned long acks;
+  unsigned long lastAckLagMs;   // Sample time to acknowledgement, last ack
+  LatencyHistogram publishLatency; // Sample time to delivery
+  LatencyHistogram ackLatency;     // Sample time to acknowledgement
+  SequenceTracker sent;         // Delivered sequence numbers; gaps are readings this sink
+                                // never got (not published, dropped or failed)
+  SequenceTracker acked;        // Acknowledged ones; duplicates are repeated answers
+};
+
+// Fans each sample out to every registered sink through a bounded queue per
+// sink. service() gives every sink at most one publish() call per pass, so a
+// slow or failing sink holds back only its own queue: it cannot hold the
+// others hostage with inline retries, and while it backs off the others
+// keep delivering. Sinks are serviced in registration order, so register
+// latency-sensitive sinks (HomeKit) first.
+class PublishDispatcher {
+public:
+  static const uint8_t MAX_SINKS = 6;
+  static const uint8_t MAX_QUEUE_DEPTH = 8;
+
+private:
+  struct Entry {
+    PublishSample sample;
+    uint64_t enqueuedMs;
+  };
+
+  struct Sink {
+    Publisher* publisher;
+    SinkOptions options;
+    Entry queue[MAX_QUEUE_DEPTH];
+    uint8_t head;
+    uint8_t count;
+    uint8_t attempts;             // Failed attempts on the head sample
+    unsigned long retryAtMs;
+    bool backingOff;
+    bool enabled;
+    SinkStats stats;
+  };
+
+  Sink sinks[MAX_SINKS];
+  uint8_t sinkCount;
+
+  void pop(Sink& sink);
+  void collectAcks(Sink& sink, uint64_t nowMs);
+
+public:
+  PublishDispatcher();
+
+  // Unregister every sink and clear the counters
+  void reset() { sinkCount = 0; }
+
+  // Register a sink; false when MAX_SINKS are already registered
+  bool addSink(Publisher& publisher, const SinkOptions& options);
+
+  // Stop or resume handing samples to a registered sink without touching the
+  // others. Disabling drops its queue (counted as dropped) and keeps its
+  // counters; false when the publisher is not registered.
+  bool setSinkEnabled(Publisher& publisher, bool enabled);
+
+  // Queue a sample on every sink
+  void submit(const PublishSample& sample);
+
+  // One publish attempt per ready sink and any acknowledgements that have
+  // arrived; returns the number of samples delivered
+  uint8_t service(uint64_t nowMs);
+
+  // Service until every queue is empty, nothing can progress or the timeout
+  // passes (quick wakes, before deep sleep); returns samples delivered
+  uint8_t drain(unsigned long timeoutMs);
+
+  uint8_t getSinkCount() const { return sinkCount; }
+  const char* getSinkName(uint8_t index) const { return sinks[index].publisher->name(); }
+  uint8_t getQueuedCount(uint8_t index) const { return sinks[index].count; }
+  bool isSinkEnabled(uint8_t index) const { return sinks[index].enabled; }
+  const SinkStats& getStats(uint8_t index) const { return sinks[index].stats; }
+
+  void printStats();
+};
+
+#endif // PUBLISH_DISPATCHER_H
@@ -0,0 +1,118 @@
+#ifndef PUBLISHER_H
+#define PUBLISHER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "homekit_manager.h"
+#include "blynk_manager.h"
+#include "mqtt_manager.h"
+
+// One reading as handed to every sink; the time is PowerManager's monotonic
+// clock at acquisition, the sequence number and RTC timer reading come from
+// ClimateManager (see SampleStamp)
+struct PublishSample {
+  uint64_t timeMs;
+  uint32_t sequence;
+  uint64_t rtcUs;
+  float temperature;
+  float humidity;
+  float heatIndex;
+};
+
+// Server acknowledgement of a published sample
+struct PublishAck {
+  uint32_t sequence;
+  uint64_t timeMs; // Acquisition time of the acknowledged sample
+};
+
+// A telemetry sink driven by PublishDispatcher
+class Publisher {
+public:
+  virtual ~Publisher() = default;
+  virtual const char* name() const = 0;
+  // False while the sink cannot accept anything (not connected); samples stay queued
+  virtual bool isReady() = 0;
+  // False asks the dispatcher to retry this sample later
+  virtual bool publish(const PublishSample& sample) = 0;
+  // Next acknowledgement from the server, for sinks whose server sends one
+  virtual bool takeAck(PublishAck& ack) {
+    (void)ack;
+    return false;
+  }
+};
+
+#if HOMEKIT_ENABLED
+class HomeKitPublisher : public Publisher {
+private:
+  HomeKitManager& homekit;
+
+public:
+  explicit HomeKitPublisher(HomeKitManager& manager) : homekit(manager) {}
+  const char* name() const override { return "homekit"; }
+  bool isReady() override { return WiFiManager::isConnected() && homekit.isInitialized(); }
+  bool publish(const PublishSample& sample) override;
+};
+#endif
+
+#if BLYNK_ENABLED
+class BlynkPublisher : public Publisher {
+private:
+  BlynkManager& blynk;
+  String sensorName;
+
+public:
+  explicit BlynkPublisher(BlynkManager& manager) : blynk(manager), sensorName("unknown") {}
+  void setSensorName(const String& name) { sensorName = name; }
+  const char* name() const override { return "blynk"; }
+  bool isReady() override { return WiFiManager::isConnected() && blynk.isConnected(); }
+  bool publish(const PublishSample& sample) override;
+};
+#endif
+
+#if MQTT_ENABLED
+// MqttManager owns delivery: a sample counts as published once it is in the
+// RTC backlog, which is flushed whenever WiFi is up and keeps whatever the
+// broker did not take for the next flush. Always ready, so samples reach
+// the backlog (and survive deep sleep) even while offline; the lag stats of
+// this sink end at the hand-over.
+class MqttPublisher : public Publisher {
+private:
+  MqttManager& mqtt;
+
+public:
+  explicit MqttPublisher(MqttManager& manager) : mqtt(manager) {}
+  const char* name() const override { return "mqtt"; }
+  bool isReady() override { return true; }
+  bool publish(const PublishSample& sample) override;
+};
+#endif
+
+#if SERIAL_CSV_ENABLED
+// CSV,<time_ms>,<temperature>,<humidity>,<heat_index> on the serial port
+class SerialCsvPublisher : public Publisher {
+public:
+  const char* name() const override { return "csv"; }
+  bool isReady() override { return true; }
+  bool publish(const PublishSample& sample) override;
+};
+#endif
+
+#if ECHO_SINK_ENABLED
+// Sends "SEQ <sequence> <acquired_ms>" datagrams to a UDP echo server and
+// turns the echoes into acknowledgements, so end-to-end latency, loss and
+// duplication can be measured against a stand-in server
+class EchoPublisher : public Publisher {
+public:
+  static const size_t DATAGRAM_SIZE = 48;
+
+  const char* name() const override { return "echo"; }
+  bool isReady() override { return WiFiManager::isConnected(); }
+  bool publish(const PublishSample& sample) override;
+  bool takeAck(PublishAck& ack) override;
+
+  static size_t format(const PublishSample& sample, char* buffer, size_t capacity);
+  static bool parse(const char* datagram, size_t length, PublishAck& ack);
+};
+#endif
+
+#endif // PUBLISHER_H
@@ -0,0 +1,104 @@
+#ifndef ROLLING_STATS_H
+#define ROLLING_STATS_H
+
+#include <stdint.h>
+
+// Aggregates over one window
+struct WindowStats {
+  uint32_t count;
+  float mean;
+  float stddev;  // Sample standard deviation (n - 1), 0 below two samples
+  float min;
+  float max;
+};
+
+// Sliding-window min/max/mean/stddev in constant memory.
+//
+// The window is split into BUCKETS time buckets. Each bucket keeps a Welford
+// summary (count, mean, sum of squared deviations), so an update is O(1) and
+// numerically stable; getStats() merges the live buckets with Chan's parallel
+// update. Min and max come from monotonic deques holding at most one entry
+// per bucket, so both are O(1) to read. Whole buckets expire at once: the
+// window covers between windowMs - bucketMs and windowMs of history.
+//
+// Call configure() on every boot; it keeps the state when the window is
+// unchanged.
+class RollingWindow {
+public:
+  static const uint8_t BUCKETS = 12;
+
+private:
+  struct Bucket {
+    uint16_t count;
+    float mean;
+    float m2;     // Sum of squared deviations from the mean
+  };
+
+  struct Extreme {
+    uint32_t bucketId;
+    float value;
+  };
+
+  // Ring buffer deque: values strictly increasing (min) or decreasing (max) from the front
+  struct MonotonicDeque {
+    Extreme entries[BUCKETS + 1];
+    uint8_t head;
+    uint8_t count;
+
+    void clear() { head = 0; count = 0; }
+    const Extreme& front() const { return entries[head]; }
+    const Extreme& back() const { return entries[(head + count - 1) % (BUCKETS + 1)]; }
+    void popFront() { head = (head + 1) % (BUCKETS + 1); count--; }
+    void popBack() { count--; }
+    void pushBack(const Extreme& entry) { entries[(head + count++) % (BUCKETS + 1)] = entry; }
+  };
+
+  uint32_t windowMs;
+  uint32_t bucketMs;
+  bool started;
+  uint32_t currentBucketId;   // Time / bucketMs of the newest bucket
+  Bucket buckets[BUCKETS];    // Indexed by bucketId % BUCKETS
+  MonotonicDeque minimums;
+  MonotonicDeque maximums;
+
+  void advanceTo(uint32_t bucketId);
+  static void pushExtreme(MonotonicDeque& deque, uint32_t bucketId, float value, bool keepSmaller);
+
+public:
+  void configure(uint32_t window);
+  void reset();
+
+  void add(uint64_t timeMs, float value);
+
+  // Aggregates over the window ending at nowMs (expires old buckets)
+  WindowStats getStats(uint64_t nowMs);
+
+  uint32_t getWindowMs() const { return windowMs; }
+};
+
+enum class RollingQuantity : uint8_t {
+  Temperature,
+  Humidity
+};
+
+// Temperature and humidity over 5 min, 1 h and 24 h windows
+class RollingStats {
+public:
+  static const uint8_t WINDOW_COUNT = 3;
+  static const uint32_t WINDOW_MS[WINDOW_COUNT];
+  static const char* const WINDOW_NAMES[WINDOW_COUNT];
+
+private:
+  RollingWindow temperature[WINDOW_COUNT];
+  RollingWindow humidity[WINDOW_COUNT];
+
+public:
+  void configure();
+  void reset();
+
+  void add(uint64_t timeMs, float temperatureValue, float humidityValue);
+
+  WindowStats getStats(uint8_t window, RollingQuantity quantity, uint64_t nowMs);
+};
+
+#endif // ROLLING_STATS_H
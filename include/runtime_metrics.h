@@ -0,0 +1,35 @@
+#ifndef RUNTIME_METRICS_H
+#define RUNTIME_METRICS_H
+
+#include <Arduino.h>
+
+// Steady-state cost of the main loop and the heap footprint, the run-time
+// counterpart of BootMetrics. Loop timing covers the work done in one
+// loop() pass and excludes the idle delay at its end. Reported as
+// "METRIC <name>=<value>" lines so emulator and bench-rig logs can be
+// compared across builds (scripts/qemu_run.py).
+class RuntimeMetrics {
+private:
+  static unsigned long passStartMicros;
+  static unsigned long lastMicros;
+  static unsigned long maxMicros;
+  static uint64_t totalMicros;
+  static uint32_t passes;
+
+public:
+  static void reset();
+
+  // Bracket the work of one loop() pass
+  static void beginPass();
+  static void endPass();
+
+  static unsigned long getLastMicros() { return lastMicros; }
+  static unsigned long getMaxMicros() { return maxMicros; }
+  static unsigned long getMeanMicros() { return passes ? (unsigned long)(totalMicros / passes) : 0; }
+  static uint32_t getPassCount() { return passes; }
+
+  // Print loop timing and the current and lowest free heap
+  static void report();
+};
+
+#endif // RUNTIME_METRICS_H
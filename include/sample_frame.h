@@ -0,0 +1,41 @@
+#ifndef SAMPLE_FRAME_H
+#define SAMPLE_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Compact sample frame sent by leaf nodes to the gateway over ESP-NOW.
+//
+// Wire layout (little endian, 10 bytes):
+//   0  magic 'C'
+//   1  version
+//   2  sequence (uint16), incremented on every wake, kept in RTC memory
+//   4  temperature in 0.01 °C (int16)
+//   6  relative humidity in 0.01 % (uint16)
+//   8  flags (SAMPLE_FLAG_*)
+//   9  CRC-8 over bytes 0-8
+//
+// The sender is identified by its MAC address, which ESP-NOW delivers with
+// every frame, so the frame itself carries no node ID.
+
+static const uint8_t SAMPLE_FRAME_MAGIC = 'C';
+static const uint8_t SAMPLE_FRAME_VERSION = 1;
+static const size_t SAMPLE_FRAME_SIZE = 10;
+
+static const uint8_t SAMPLE_FLAG_SENSOR_ERROR = 0x01; // Reading invalid, values are zero
+static const uint8_t SAMPLE_FLAG_COLD_BOOT = 0x02;    // First frame after power-on (sequence restarted)
+
+struct SampleFrame {
+  uint16_t sequence;
+  float temperature;
+  float humidity;
+  uint8_t flags;
+};
+
+// Returns the number of bytes written (SAMPLE_FRAME_SIZE), 0 if buffer is too small
+size_t encodeSampleFrame(const SampleFrame& frame, uint8_t* buffer, size_t bufferSize);
+
+// Returns false for short, corrupt or unknown-version frames
+bool decodeSampleFrame(const uint8_t* data, size_t length, SampleFrame* frame);
+
+#endif // SAMPLE_FRAME_H
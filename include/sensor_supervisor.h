@@ -0,0 +1,73 @@
+#ifndef SENSOR_SUPERVISOR_H
+#define SENSOR_SUPERVISOR_H
+
+#include <Arduino.h>
+#include <Adafruit_Sensor.h>
+#include "config.h"
+#include "climate_manager.h"
+
+enum class SensorHealth : uint8_t {
+  Healthy,     // Last reading was good
+  Degraded,    // Failed readings, below SENSOR_FAILURE_THRESHOLD
+  Offline,     // Driver down; re-initialized with backoff
+  Recovering   // Re-initialized, waiting for the first good reading
+};
+
+// Watches the climate sensor and brings it back when it stops answering.
+//
+// read() counts consecutive failures. At SENSOR_FAILURE_THRESHOLD the sensor
+// goes Offline: reads are skipped and service() re-initializes the driver,
+// clearing the bus first (recoverBus(), an I2C bus clear for the SHT41), with
+// an exponential backoff from SENSOR_RETRY_BACKOFF_MIN up to
+// SENSOR_RETRY_BACKOFF_MAX. Time to recovery runs from the first failed
+// reading (or failed start) to the first good reading after a re-init. Times are passed in so the state machine
+// runs on any clock.
+class SensorSupervisor {
+private:
+  ClimateManager* sensor;
+  SensorHealth health;
+  uint8_t consecutiveFailures;
+  uint64_t failingSinceMs;
+  uint64_t nextAttemptMs;
+  uint32_t backoffMs;
+
+  uint32_t failedReads;
+  uint32_t reinitAttempts;
+  uint32_t busRecoveries;
+  uint32_t recoveries;
+  uint32_t lastRecoveryMs;
+  uint32_t maxRecoveryMs;
+
+  void setHealth(SensorHealth next);
+  void goOffline(uint64_t nowMs);
+  bool reinitialize(uint64_t nowMs);
+
+public:
+  SensorSupervisor();
+
+  // Start the driver; on failure clear the bus and try once more, then go Offline
+  bool begin(ClimateManager* climateSensor, uint64_t nowMs);
+
+  // Read both channels; false (and nothing read) while Offline
+  bool read(sensors_event_t* temperatureEvent, sensors_event_t* humidityEvent, uint64_t nowMs);
+
+  // Re-initialize an Offline sensor when its backoff has elapsed; true on success
+  bool service(uint64_t nowMs);
+
+  SensorHealth getHealth() const { return health; }
+  bool isOnline() const { return health != SensorHealth::Offline; }
+  uint8_t getConsecutiveFailures() const { return consecutiveFailures; }
+  uint32_t getFailedReads() const { return failedReads; }
+  uint32_t getReinitAttempts() const { return reinitAttempts; }
+  uint32_t getBusRecoveries() const { return busRecoveries; }
+  uint32_t getRecoveryCount() const { return recoveries; }
+  uint32_t getLastRecoveryMs() const { return lastRecoveryMs; }
+  uint32_t getMaxRecoveryMs() const { return maxRecoveryMs; }
+  uint32_t getBackoffMs() const { return backoffMs; }
+
+  static const char* describe(SensorHealth state);
+
+  void printStats();
+};
+
+#endif // SENSOR_SUPERVISOR_H
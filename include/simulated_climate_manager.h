@@ -0,0 +1,53 @@
+#ifndef SIMULATED_CLIMATE_MANAGER_H
+#define SIMULATED_CLIMATE_MANAGER_H
+
+#include "climate_manager.h"
+
+// Hardware-free sensor used by host builds and emulation targets.
+// Reports whatever the harness last set through the static setters, and
+// injects faults: transient read failures, or a wedged I2C bus that fails
+// every read and begin() until recoverBus() clears it. Readings and heater
+// pulses take as long as on an SHT41 (datasheet maxima), so wake durations
+// on the host follow the measurement policy. After a heater pulse the die
+// reads warm for a while, as the real sensor does.
+class SimulatedClimateManager : public ClimateManager {
+private:
+  static float temperature;
+  static float humidity;
+  static bool readFailure;
+  static bool busStuck;
+  static uint16_t failingReads;
+  static uint32_t heaterPulses;
+  static bool dieWarm;
+  static unsigned long pulseEndMs;
+  MeasurementPrecision precision = MeasurementPrecision::High;
+
+  void fillSensor(sensor_t* sensor, int32_t type, float minValue, float maxValue);
+  static float dieExcessCelsius();
+
+public:
+  static void setReading(float newTemperature, float newHumidity);
+  static void setReadFailure(bool failing);
+  // Fail the next count reads, then recover on its own
+  static void failNextReads(uint16_t count);
+  // Fail until a bus recovery (on I2C_SDA_PIN/I2C_SCL_PIN) succeeds
+  static void setBusStuck(bool stuck);
+  static bool isBusStuck() { return busStuck; }
+  static uint32_t getHeaterPulses() { return heaterPulses; }
+
+  // SHT41 conversion time (both channels) at a precision
+  static uint32_t conversionMicros(MeasurementPrecision precision);
+
+  bool begin() override;
+  bool getTemperatureEvent(sensors_event_t* event) override;
+  bool getHumidityEvent(sensors_event_t* event) override;
+  void getTemperatureSensor(sensor_t* sensor) override;
+  void getHumiditySensor(sensor_t* sensor) override;
+  bool recoverBus() override;
+  void setPrecision(MeasurementPrecision newPrecision) override { precision = newPrecision; }
+  bool pulseHeater() override;
+  String getSensorName() override;
+  void printSensorInfo() override;
+};
+
+#endif // SIMULATED_CLIMATE_MANAGER_H
@@ -0,0 +1,85 @@
+#ifndef TIME_SERVICE_H
+#define TIME_SERVICE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#if TIME_SYNC_ENABLED
+
+// Absolute time of an RTC timer reading, with the worst-case error of the estimate
+struct WallTime {
+  uint64_t unixMs;  // Milliseconds since 1970-01-01T00:00:00Z
+  uint32_t errorMs; // |estimate - UTC| stays below this
+  bool valid;       // False until the first SNTP sync since power-on
+};
+
+// Wall-clock time across deep sleep without an SNTP exchange on every wake.
+//
+// An SNTP answer anchors UTC to the RTC timer (Hal::clock().rtcMicros()),
+// which keeps counting through deep sleep. Between syncs a timer reading is
+// converted by extrapolating from the anchor, corrected for the RTC clock's
+// drift: once two syncs are at least TIME_DRIFT_MIN_INTERVAL apart, the rate
+// error between them is measured and smoothed into driftPpm. The error bound
+// grows with the time since the anchor, by TIME_RTC_TOLERANCE_PPM while the
+// drift is unknown and TIME_DRIFT_RESIDUAL_PPM after that; a new sync is due
+// when it passes TIME_MAX_ERROR_MS or the anchor is TIME_SYNC_INTERVAL old.
+//
+// Samples carry the raw timer reading, so toWall() also dates readings taken
+// before the first sync of a wake (or buffered across many wakes) at send time.
+// Anchors and drift live in RTC memory; a power-on reset restarts the RTC
+// timer and drops them.
+class TimeService {
+private:
+  static bool synced;             // RTC memory
+  static uint64_t anchorRtcUs;    // RTC memory: timer reading at the last sync
+  static uint64_t anchorUnixUs;   // RTC memory: UTC at the last sync
+  static uint64_t referenceRtcUs; // RTC memory: start of the current drift measurement
+  static uint64_t referenceUnixUs;
+  static float driftPpm;          // RTC memory: RTC rate error, positive when it runs fast
+  static bool driftKnown;
+  static int32_t lastCorrectionMs; // RTC memory: estimate minus SNTP at the last sync
+  static uint32_t syncCount;       // RTC memory
+  static uint32_t failureCount;    // RTC memory
+  static bool requesting;
+  static unsigned long requestStartMs;
+  static unsigned long lastAttemptMs;
+  static bool attempted;
+
+  static void startRequest();
+  static bool finishRequest(unsigned long timeoutMs); // True once the request ended
+  static void applySync(uint64_t rtcUs, uint64_t unixUs);
+
+public:
+  // Call once per boot; a power-on reset drops the RTC-memory anchors
+  static void begin();
+
+  // Non-blocking: starts a due sync while WiFi is up and collects the answer
+  static void service();
+
+  // Blocking sync for quick wakes; true once the answer was applied
+  static bool syncNow(unsigned long timeoutMs);
+
+  // No anchor yet, error bound over TIME_MAX_ERROR_MS or anchor too old
+  static bool isSyncDue();
+
+  // Absolute time of an RTC timer reading (earlier or later than the anchor)
+  static WallTime toWall(uint64_t rtcUs);
+  static WallTime now();
+
+  // ISO 8601 UTC with milliseconds; text needs 25 bytes
+  static void formatUtc(uint64_t unixMs, char* text, size_t size);
+
+  static bool isSynced() { return synced; }
+  static bool isDriftKnown() { return driftKnown; }
+  static float getDriftPpm() { return driftPpm; }
+  static int32_t getLastCorrectionMs() { return lastCorrectionMs; }
+  static uint32_t getSyncCount() { return syncCount; }
+  static uint32_t getFailureCount() { return failureCount; }
+
+  // Print UTC, error bound and drift, with METRIC lines
+  static void printStats();
+};
+
+#endif // TIME_SYNC_ENABLED
+
+#endif // TIME_SERVICE_H
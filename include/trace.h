@@ -0,0 +1,47 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+#include <Adafruit_Sensor.h>
+#include "config.h"
+
+// Sensor and connectivity trace, shared by the on-device recorder and the
+// host replay harness. One event per line, embedded in the serial log so a
+// captured monitor session is itself a trace file:
+//   TRACE,<ms>,S,<temperature>,<humidity>   sensor sample
+//   TRACE,<ms>,U                            WiFi link up
+//   TRACE,<ms>,D                            WiFi link down
+// <ms> counts from first boot and keeps running across deep sleep.
+
+enum class TraceEventType {
+  Sample,
+  LinkUp,
+  LinkDown
+};
+
+struct TraceEvent {
+  uint64_t timeMs;
+  TraceEventType type;
+  float temperature;
+  float humidity;
+};
+
+// Parse one log line; returns false if the line carries no trace event
+bool parseTraceLine(const char* line, TraceEvent* event);
+
+class TraceRecorder {
+private:
+  static bool linkUp;
+
+public:
+  // Record a temperature/humidity event pair as one sample
+  static void recordSample(const sensors_event_t& temperatureEvent, const sensors_event_t& humidityEvent);
+
+  // Record link transitions; call every loop pass with the current state
+  static void observeLink(bool connected);
+
+  // Trace clock in milliseconds since first boot
+  static uint64_t now();
+};
+
+#endif // TRACE_H
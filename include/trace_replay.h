@@ -0,0 +1,35 @@
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include "trace.h"
+
+#ifndef ARDUINO
+
+#include <vector>
+
+// Host harness that feeds a recorded trace through the firmware pipeline.
+// Samples drive the simulated sensor and link events drive the fake access
+// point; the caller runs setup()/loop() on the simulated clock.
+class TraceReplay {
+private:
+  std::vector<TraceEvent> events;
+  size_t nextEvent = 0;
+
+public:
+  // Load every trace event from a log file; returns false if none were found
+  bool load(const char* path);
+
+  // Apply all events due at the given trace time
+  void advanceTo(uint64_t timeMs);
+
+  bool finished() const { return nextEvent >= events.size(); }
+  uint64_t durationMs() const { return events.empty() ? 0 : events.back().timeMs; }
+  size_t eventCount() const { return events.size(); }
+
+  // Print publishes, bytes sent, radio-on time and estimated energy
+  void printReport();
+};
+
+#endif // ARDUINO
+
+#endif // TRACE_REPLAY_H
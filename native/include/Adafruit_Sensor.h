@@ -0,0 +1,38 @@
+#ifndef NATIVE_ADAFRUIT_SENSOR_H
+#define NATIVE_ADAFRUIT_SENSOR_H
+
+// Host copy of the Adafruit Unified Sensor types used by ClimateManager.
+// Layout matches Adafruit_Sensor.h so recorded events replay unchanged.
+
+#include <stdint.h>
+
+typedef enum {
+  SENSOR_TYPE_RELATIVE_HUMIDITY = 12,
+  SENSOR_TYPE_AMBIENT_TEMPERATURE = 13
+} sensors_type_t;
+
+typedef struct {
+  int32_t version;
+  int32_t sensor_id;
+  int32_t type;
+  int32_t reserved0;
+  int32_t timestamp;
+  union {
+    float data[4];
+    float temperature;
+    float relative_humidity;
+  };
+} sensors_event_t;
+
+typedef struct {
+  char name[12];
+  int32_t version;
+  int32_t sensor_id;
+  int32_t type;
+  float max_value;
+  float min_value;
+  float resolution;
+  int32_t min_delay;
+} sensor_t;
+
+#endif // NATIVE_ADAFRUIT_SENSOR_H
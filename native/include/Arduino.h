@@ -0,0 +1,95 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Minimal Arduino core for the host ([env:native]) build.
+// Provides just the subset of the Arduino API the firmware uses; timing is
+// routed to the simulated clock of the HAL fakes (see hal_fake.h).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <math.h>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+
+// RTC slow memory does not exist on the host; plain statics survive the
+// simulated deep sleep just the same
+#define RTC_DATA_ATTR
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+class String {
+private:
+  std::string value;
+
+public:
+  String(const char* text = "") : value(text ? text : "") {}
+  String(const std::string& text) : value(text) {}
+  explicit String(char c) : value(1, c) {}
+  String(int number, unsigned char base = DEC);
+  String(unsigned int number, unsigned char base = DEC);
+  String(long number, unsigned char base = DEC);
+  String(unsigned long number, unsigned char base = DEC);
+  String(float number, unsigned int decimals = 2);
+  String(double number, unsigned int decimals = 2);
+
+  const char* c_str() const { return value.c_str(); }
+  unsigned int length() const { return value.length(); }
+  long toInt() const;
+  float toFloat() const;
+
+  String& operator+=(const String& other) { value += other.value; return *this; }
+  bool operator==(const String& other) const { return value == other.value; }
+  bool operator!=(const String& other) const { return value != other.value; }
+
+  friend String operator+(const String& lhs, const String& rhs) {
+    return String(lhs.value + rhs.value);
+  }
+};
+
+class Print {
+public:
+  virtual ~Print() = default;
+  virtual size_t write(const char* data, size_t length) = 0;
+
+  size_t print(const char* text);
+  size_t print(const String& text) { return print(text.c_str()); }
+  size_t print(char c) { return write(&c, 1); }
+  size_t print(int number, int base = DEC) { return print(String(number, base)); }
+  size_t print(unsigned int number, int base = DEC) { return print(String(number, base)); }
+  size_t print(long number, int base = DEC) { return print(String(number, base)); }
+  size_t print(unsigned long number, int base = DEC) { return print(String(number, base)); }
+  size_t print(double number, int digits = 2) { return print(String(number, digits)); }
+
+  size_t println() { return print("\n"); }
+  template <typename T>
+  size_t println(const T& value) { return print(value) + println(); }
+  template <typename T>
+  size_t println(const T& value, int format) { return print(value, format) + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// Serial port backed by stdout
+class HardwareSerial : public Print {
+private:
+  bool echo = true;
+
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  void flush();
+  void setEcho(bool enabled) { echo = enabled; }
+  explicit operator bool() const { return true; }
+  size_t write(const char* data, size_t length) override;
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""Compare two benchmark logs and flag kernels that got slower.
+
+Usage: bench_compare.py baseline.log current.log [--threshold 0.10]
+
+Logs are raw output of the bench_native / bench_esp32 environments; every
+line that parses as a benchmark JSON object is used, anything else is
+ignored. Exits with status 1 if any kernel's median regressed by more than
+the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    results = {}
+    with open(path, encoding="utf-8", errors="replace") as log:
+        for line in log:
+            start = line.find("{")
+            if start < 0:
+                continue
+            try:
+                record = json.loads(line[start:])
+            except ValueError:
+                continue
+            if "bench" in record and "median" in record:
+                results[record["bench"]] = record
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="allowed relative slowdown of the median (default 0.10)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+
+    for name in sorted(set(baseline) | set(current)):
+        if name not in baseline or name not in current:
+            print(f"{name:28s} {'only in ' + ('current' if name in current else 'baseline')}")
+            continue
+        old, new = baseline[name], current[name]
+        if old["unit"] != new["unit"]:
+            print(f"{name:28s} unit mismatch ({old['unit']} vs {new['unit']})")
+            continue
+        change = (new["median"] - old["median"]) / old["median"] if old["median"] else 0.0
+        flag = "REGRESSION" if change > args.threshold else ""
+        regressions += bool(flag)
+        print(f"{name:28s} {old['median']:10.2f} -> {new['median']:10.2f} {new['unit']:6s} "
+              f"{change:+7.1%} {flag}")
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Build every firmware variant and check it against budgets.json.
+
+Usage: check_variants.py [--env NAME ...] [--no-boot] [--update [--headroom 0.05]]
+
+For each variant env in platformio.ini (env:variant_*, or the ones given
+with --env), runs `pio run -e NAME`; the env's post-link script
+(scripts/size_budget.py) measures flash and static RAM and fails the build
+when either is over budget. Unless --no-boot is given, the same env is then
+rebuilt with QEMU_BUILD and booted under the ESP32 QEMU (scripts/qemu_run.py)
+until its boot metric (custom_boot_metric in the env) is printed. Prints one
+line per variant and exits with status 1 if any variant failed to build,
+boot, or meet a budget, or has no budget yet. --update rewrites budgets.json
+from the measurements plus headroom instead of checking them; budgets only
+ever come from such a run.
+"""
+
+import argparse
+import configparser
+import json
+import os
+import subprocess
+import sys
+
+import qemu_run
+
+BUDGETS = "budgets.json"
+PROJECT = "platformio.ini"
+DEFAULT_BOOT_METRIC = "boot_setup_ms"
+
+
+def variant_envs():
+    """{env: boot metric} for every env:variant_* section of platformio.ini."""
+    project = configparser.ConfigParser(interpolation=None, inline_comment_prefixes=(";",))
+    project.read(PROJECT, encoding="utf-8")
+    envs = {}
+    for section in project.sections():
+        if section.startswith("env:variant_"):
+            # Only one level of extends: each variant env extends [variant]
+            inherited = project.get(project.get(section, "extends", fallback=""),
+                                    "custom_boot_metric", fallback=DEFAULT_BOOT_METRIC)
+            envs[section[len("env:"):]] = project.get(section, "custom_boot_metric",
+                                                      fallback=inherited)
+    return envs
+
+
+def measure_size(env):
+    """(built, sizes): sizes from the post-link script, None if linking failed."""
+    report = os.path.join(".pio", "build", env, "size.json")
+    if os.path.exists(report):
+        os.remove(report)
+    built = subprocess.run(["pio", "run", "-e", env]).returncode == 0
+    if not os.path.exists(report):
+        return built, None
+    with open(report, encoding="utf-8") as sizes:
+        return built, json.load(sizes)
+
+
+def measure_boot(env, metric, seconds, qemu):
+    qemu_run.build(env)
+    image = qemu_run.merge_image(env, qemu_run.DEFAULT_ESPTOOL)
+    metrics = qemu_run.parse(qemu_run.run_qemu(qemu, image, seconds, [], until=metric))
+    return metrics.get(metric)
+
+
+def rounded_up(value, step):
+    return -(-int(value) // step) * step
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--env", action="append", help="variant to check (default: all in budgets.json)")
+    parser.add_argument("--no-boot", action="store_true", help="skip the emulated boot")
+    parser.add_argument("--seconds", type=float, default=60, help="emulator time limit per variant")
+    parser.add_argument("--qemu", default="qemu-system-xtensa")
+    parser.add_argument("--update", action="store_true", help="rewrite budgets.json from this run")
+    parser.add_argument("--headroom", type=float, default=0.05,
+                        help="margin added by --update (default 0.05)")
+    args = parser.parse_args()
+
+    with open(BUDGETS, encoding="utf-8") as budgets_file:
+        budgets = json.load(budgets_file)
+    variants = variant_envs()
+    failures = 0
+
+    for env in args.env or sorted(variants):
+        budget = budgets.get(env, {})
+        boot_metric = variants.get(env, DEFAULT_BOOT_METRIC)
+        built, measured = measure_size(env)
+        if measured is None:
+            print(f"{env:32s} BUILD FAILED")
+            failures += 1
+            continue
+        if not args.no_boot:
+            measured[boot_metric] = measure_boot(env, boot_metric, args.seconds, args.qemu)
+            if measured[boot_metric] is None:
+                print(f"{env:32s} BOOT FAILED ({boot_metric} not printed)")
+                failures += 1
+                continue
+
+        over = [key for key, value in measured.items() if key in budget and value > budget[key]]
+        missing = [key for key in measured if key not in budget]
+        failures += (bool(over) or bool(missing) or not built) and not args.update
+        print(f"{env:32s} " + "  ".join(f"{key}={value}/{budget.get(key, '-')}"
+                                         for key, value in sorted(measured.items()))
+              + (f"  OVER: {', '.join(over)}" if over else "")
+              + (f"  NO BUDGET: {', '.join(missing)} (run --update)" if missing and not args.update else ""))
+
+        if args.update:
+            budgets[env] = dict(budget, **{key: rounded_up(value * (1 + args.headroom),
+                                                           100 if key.endswith("_ms") else 1024)
+                                           for key, value in measured.items()})
+
+    if args.update:
+        with open(BUDGETS, "w", encoding="utf-8") as budgets_file:
+            json.dump(budgets, budgets_file, indent=2, sort_keys=True)
+            budgets_file.write("\n")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
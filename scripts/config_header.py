@@ -0,0 +1,19 @@
+"""PlatformIO pre-build script: create include/config.h from the template.
+
+config.h holds credentials and is never committed, so a fresh checkout has
+none. Envs that must build unattended (the host build and its unit tests,
+the firmware variants) list this script under extra_scripts; it copies
+include/config.h.template when config.h is missing and leaves an existing
+one alone.
+"""
+
+import os
+import shutil
+
+Import("env")  # noqa: F821 (provided by PlatformIO)
+
+include_dir = os.path.join(env.subst("$PROJECT_DIR"), "include")  # noqa: F821
+config = os.path.join(include_dir, "config.h")
+if not os.path.exists(config):
+    shutil.copyfile(os.path.join(include_dir, "config.h.template"), config)
+    print("Created include/config.h from config.h.template")
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""UDP echo server for the firmware's echo sink (ECHO_SINK_ENABLED).
+
+Usage: echo_server.py [--port 9999] [--drop N] [--duplicate N] [--delay-ms MS] [--json out.json]
+
+Echoes every "SEQ <sequence> <acquired_ms>" datagram back to its sender, so
+the device can time sample-to-acknowledgement latency, and checks the
+sequence numbers as they arrive: a number at or below the last one from the
+same device is a duplicate, a jump counts the numbers skipped as gaps. With
+--drop / --duplicate every N-th datagram is swallowed or echoed twice, to
+check that the device's own gap and duplicate counters see the same faults.
+Runs until interrupted; prints a summary per device and writes it as JSON
+with --json.
+"""
+
+import argparse
+import json
+import re
+import socket
+import sys
+import time
+
+DATAGRAM = re.compile(rb"^SEQ (\d+) (\d+)$")
+RESTART_WINDOW = 64  # Same as SequenceTracker: a larger jump back is a reboot
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=9999)
+    parser.add_argument("--drop", type=int, default=0, help="swallow every N-th datagram")
+    parser.add_argument("--duplicate", type=int, default=0, help="echo every N-th datagram twice")
+    parser.add_argument("--delay-ms", type=float, default=0, help="wait before echoing")
+    parser.add_argument("--json", help="write the per-device summary here on exit")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("", args.port))
+    print(f"Echoing on UDP port {args.port}", file=sys.stderr)
+
+    devices = {}
+    received = 0
+    try:
+        while True:
+            data, sender = sock.recvfrom(256)
+            match = DATAGRAM.match(data.strip())
+            if not match:
+                continue
+            received += 1
+            sequence = int(match.group(1))
+            device = devices.setdefault(sender[0], {"received": 0, "gaps": 0, "duplicates": 0,
+                                                    "restarts": 0, "last": None})
+            device["received"] += 1
+            last = device["last"]
+            if last is not None:
+                delta = sequence - last
+                if delta <= -RESTART_WINDOW:
+                    device["restarts"] += 1
+                elif delta <= 0:
+                    device["duplicates"] += 1
+                    print(f"{sender[0]} duplicate {sequence}", file=sys.stderr)
+                elif delta > 1:
+                    device["gaps"] += delta - 1
+                    print(f"{sender[0]} gap {last + 1}..{sequence - 1}", file=sys.stderr)
+            if last is None or sequence > last or sequence - last <= -RESTART_WINDOW:
+                device["last"] = sequence
+
+            if args.drop and received % args.drop == 0:
+                continue
+            if args.delay_ms:
+                time.sleep(args.delay_ms / 1000.0)
+            sock.sendto(data, sender)
+            if args.duplicate and received % args.duplicate == 0:
+                sock.sendto(data, sender)
+    except KeyboardInterrupt:
+        pass
+
+    for address, device in sorted(devices.items()):
+        print(f"{address:16s} received {device['received']}, gaps {device['gaps']}, "
+              f"duplicates {device['duplicates']}, restarts {device['restarts']}")
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as out:
+            json.dump(devices, out, indent=2, sort_keys=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
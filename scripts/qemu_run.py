@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""Boot the firmware under Espressif's ESP32 QEMU and collect its METRIC lines.
+
+Usage: qemu_run.py [--build] [--seconds 90] [--save-log run.log] [--json out.json]
+       qemu_run.py --log run.log                 (parse a captured log only)
+       qemu_run.py ... --baseline base.json [--threshold 0.10]
+
+Builds (with --build) and merges the qemu_esp32 environment into a 4 MB flash
+image, runs qemu-system-xtensa for the given wall-clock time and prints every
+"METRIC <name>=<value>" line of the serial log as one JSON object; repeated
+metrics keep their last value. With --baseline, a saved JSON object from an
+earlier run is compared and the script exits with status 1 if a time metric
+(*_ms, *_us) grew or a heap metric (*heap_bytes) shrank by more than the
+threshold. Emulated timing is only comparable between runs on the same host.
+"""
+
+import argparse
+import json
+import os
+import re
+import select
+import subprocess
+import sys
+import time
+
+METRIC = re.compile(r"METRIC (\w+)=(-?[0-9.]+)")
+
+# Layout written by the Arduino core's esptool upload step
+FLASH_LAYOUT = [
+    ("0x1000", "bootloader.bin"),
+    ("0x8000", "partitions.bin"),
+    ("0xe000", None),  # boot_app0.bin from the framework package
+    ("0x10000", "firmware.bin"),
+]
+
+
+def parse(lines):
+    metrics = {}
+    for line in lines:
+        match = METRIC.search(line)
+        if match:
+            value = float(match.group(2))
+            metrics[match.group(1)] = int(value) if value.is_integer() else value
+    return metrics
+
+
+# Emulator images of any env are built with QEMU_BUILD into their own tree, so
+# they never overwrite (or get size-checked as) the real firmware
+QEMU_BUILD_DIR = os.path.join(".pio", "qemu")
+DEFAULT_ESPTOOL = "pio pkg exec --package tool-esptoolpy -- esptool.py"
+
+
+def build(env):
+    settings = dict(os.environ, PLATFORMIO_BUILD_FLAGS="-DQEMU_BUILD",
+                    PLATFORMIO_BUILD_DIR=QEMU_BUILD_DIR)
+    subprocess.run(["pio", "run", "-e", env], check=True, env=settings)
+
+
+def merge_image(env, esptool):
+    build_dir = os.path.join(QEMU_BUILD_DIR, env)
+    framework = os.path.expanduser(
+        "~/.platformio/packages/framework-arduinoespressif32/tools/partitions/boot_app0.bin")
+    image = os.path.join(build_dir, "qemu_flash.bin")
+    # QEMU's flash model only does DIO: patch the header instead of the env
+    command = esptool.split() + ["--chip", "esp32", "merge_bin", "--flash_mode", "dio",
+                                 "--fill-flash-size", "4MB", "-o", image]
+    for offset, name in FLASH_LAYOUT:
+        command += [offset, os.path.join(build_dir, name) if name else framework]
+    subprocess.run(command, check=True)
+    return image
+
+
+def run_qemu(qemu, image, seconds, extra_args, until=None):
+    """Serial log lines; stops early once the metric named by until is printed."""
+    command = [qemu, "-nographic", "-machine", "esp32",
+               "-drive", f"file={image},if=mtd,format=raw",
+               # The emulated timer groups otherwise reset the chip on slow hosts
+               "-global", "driver=timer.esp32.timg,property=wdt_disable,value=true"] + extra_args
+    process = subprocess.Popen(command, stdin=subprocess.DEVNULL, stdout=subprocess.PIPE,
+                               stderr=subprocess.STDOUT)
+    lines, pending = [], b""
+    deadline = time.monotonic() + seconds
+    try:
+        while time.monotonic() < deadline and process.poll() is None:
+            ready, _, _ = select.select([process.stdout], [], [], 0.5)
+            if not ready:
+                continue
+            pending += os.read(process.stdout.fileno(), 4096)
+            *complete, pending = pending.split(b"\n")
+            for raw in complete:
+                line = raw.decode("utf-8", errors="replace").rstrip("\r")
+                print(line, file=sys.stderr)
+                lines.append(line)
+                if until and f"METRIC {until}=" in line:
+                    return lines
+    finally:
+        process.terminate()
+        process.wait(timeout=5)
+    return lines
+
+
+def compare(baseline, current, threshold):
+    regressions = 0
+    for name in sorted(set(baseline) & set(current)):
+        old, new = baseline[name], current[name]
+        if name == "uptime_ms" or name.endswith("target_ms"):
+            continue
+        if name.endswith(("_ms", "_us")):
+            change = (new - old) / old if old else 0.0
+        elif name.endswith("heap_bytes"):
+            change = (old - new) / old if old else 0.0
+        else:
+            continue
+        flag = "REGRESSION" if change > threshold else ""
+        regressions += bool(flag)
+        print(f"{name:28s} {old:>10} -> {new:>10} {change:+7.1%} {flag}")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--env", default="qemu_esp32")
+    parser.add_argument("--build", action="store_true",
+                        help="build ENV with QEMU_BUILD into .pio/qemu first")
+    parser.add_argument("--seconds", type=float, default=90,
+                        help="wall-clock run time (default 90: boot plus one regular reading)")
+    parser.add_argument("--qemu", default="qemu-system-xtensa")
+    parser.add_argument("--qemu-arg", action="append", default=[],
+                        help="extra QEMU argument, repeatable (e.g. an efuse drive)")
+    parser.add_argument("--esptool", default=DEFAULT_ESPTOOL)
+    parser.add_argument("--log", help="parse this serial log instead of running QEMU")
+    parser.add_argument("--save-log", help="write the captured serial log here")
+    parser.add_argument("--json", help="write the metrics object here (use as a later baseline)")
+    parser.add_argument("--baseline", help="metrics JSON from an earlier run")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="allowed relative change in the bad direction (default 0.10)")
+    args = parser.parse_args()
+
+    if args.log:
+        with open(args.log, encoding="utf-8", errors="replace") as log:
+            lines = log.read().splitlines()
+    else:
+        if args.build:
+            build(args.env)
+        image = merge_image(args.env, args.esptool)
+        lines = run_qemu(args.qemu, image, args.seconds, args.qemu_arg)
+        if args.save_log:
+            with open(args.save_log, "w", encoding="utf-8") as log:
+                log.write("\n".join(lines) + "\n")
+
+    metrics = parse(lines)
+    print(json.dumps(metrics, sort_keys=True))
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as out:
+            json.dump(metrics, out, sort_keys=True)
+    if "boot_setup_ms" not in metrics:
+        print("boot_setup_ms missing: the firmware did not finish setup()", file=sys.stderr)
+        return 1
+
+    if args.baseline:
+        with open(args.baseline, encoding="utf-8") as base:
+            if compare(json.load(base), metrics, args.threshold):
+                return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
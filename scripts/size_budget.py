@@ -0,0 +1,67 @@
+"""PlatformIO post-link check of flash and static RAM against budgets.json.
+
+Used by the variant envs (extra_scripts = post:scripts/size_budget.py). After
+firmware.elf is linked, the section sizes are summed the way PlatformIO's own
+size report does for the ESP32, written to $BUILD_DIR/size.json for
+scripts/check_variants.py, and the build fails if the env's flash_bytes or
+ram_bytes budget is exceeded. Envs without a budget entry are only reported.
+"""
+
+import json
+import os
+import re
+import subprocess
+
+Import("env")  # noqa: F821 (provided by PlatformIO)
+
+# Flash: code and constants in the image; static RAM: initialized data, BSS and
+# .noinit. IRAM code counts towards flash only, as in `pio run -t size`.
+FLASH_SECTIONS = re.compile(
+    r"^\.(?:iram0\.text|iram0\.vectors|dram0\.data|flash\.text|flash\.rodata|flash\.appdesc)\s+(\d+)")
+RAM_SECTIONS = re.compile(r"^\.(?:dram0\.data|dram0\.bss|noinit)\s+(\d+)")
+
+
+def section_totals(elf):
+    output = subprocess.run([env.subst("$SIZETOOL"), "-A", elf], capture_output=True,
+                            text=True, check=True).stdout
+    flash = ram = 0
+    for line in output.splitlines():
+        match = FLASH_SECTIONS.match(line)
+        if match:
+            flash += int(match.group(1))
+        match = RAM_SECTIONS.match(line)
+        if match:
+            ram += int(match.group(1))
+    return flash, ram
+
+
+def within(label, used, budget):
+    print(f"  {label:6s} {used:>9d} / {budget:>9d} bytes ({used / budget:6.1%})"
+          f"{'  OVER BUDGET' if used > budget else ''}")
+    return used <= budget
+
+
+def check_budget(source, target, env):
+    if "QEMU_BUILD" in str(env.get("CPPDEFINES", [])):
+        return 0  # Emulator image: radio stacks are stubbed out, sizes say nothing
+
+    name = env.subst("$PIOENV")
+    flash, ram = section_totals(str(target[0]))
+    with open(os.path.join(env.subst("$BUILD_DIR"), "size.json"), "w", encoding="utf-8") as out:
+        json.dump({"flash_bytes": flash, "ram_bytes": ram}, out)
+
+    with open(os.path.join(env.subst("$PROJECT_DIR"), "budgets.json"), encoding="utf-8") as budgets:
+        budget = json.load(budgets).get(name)
+    print(f"Size budget for {name}:")
+    if budget is None:
+        print(f"  flash {flash} bytes, RAM {ram} bytes (no entry in budgets.json)")
+        return 0
+    ok = within("flash", flash, budget["flash_bytes"])
+    ok = within("RAM", ram, budget["ram_bytes"]) and ok
+    if not ok:
+        print(f"✗ {name} exceeds its size budget (budgets.json)")
+        return 1
+    return 0
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_budget)  # noqa: F821
@@ -0,0 +1,68 @@
+#include "adaptive_sampler.h"
+#include <math.h>
+
+void AdaptiveSampler::configure(uint32_t minInterval, uint32_t maxInterval, float tempBand,
+                                float humBand, float maxRatePerMinute) {
+  minIntervalMs = minInterval;
+  maxIntervalMs = maxInterval < minInterval ? minInterval : maxInterval;
+  temperatureBand = tempBand;
+  humidityBand = humBand;
+  rateLimit = maxRatePerMinute;
+  if (primed && (intervalMs < minIntervalMs || intervalMs > maxIntervalMs)) {
+    intervalMs = minIntervalMs;
+  }
+}
+
+void AdaptiveSampler::reset() {
+  primed = false;
+  intervalMs = minIntervalMs;
+}
+
+float AdaptiveSampler::getStdDev() const {
+  return sqrtf(varianceTemperature);
+}
+
+uint32_t AdaptiveSampler::update(float temperature, float humidity, uint64_t sampledMs) {
+  if (!primed) {
+    primed = true;
+    intervalMs = minIntervalMs;
+    referenceTemperature = temperature;
+    referenceHumidity = humidity;
+    lastTemperature = temperature;
+    lastSampleMs = sampledMs;
+    meanTemperature = temperature;
+    varianceTemperature = 0.0f;
+    slope = 0.0f;
+    return intervalMs;
+  }
+
+  // Smoothed first derivative, per minute actually elapsed; a clock that did
+  // not move falls back to the interval the sample was scheduled at
+  uint64_t elapsedMs = sampledMs > lastSampleMs ? sampledMs - lastSampleMs : intervalMs;
+  float minutes = elapsedMs / 60000.0f;
+  float rate = (temperature - lastTemperature) / minutes;
+  slope += SMOOTHING * (rate - slope);
+  lastTemperature = temperature;
+  lastSampleMs = sampledMs;
+
+  // Exponentially weighted variance
+  float delta = temperature - meanTemperature;
+  meanTemperature += SMOOTHING * delta;
+  varianceTemperature = (1.0f - SMOOTHING) * (varianceTemperature + SMOOTHING * delta * delta);
+
+  bool outOfBand = fabsf(temperature - referenceTemperature) > temperatureBand ||
+                   fabsf(humidity - referenceHumidity) > humidityBand;
+  bool unsettled = fabsf(slope) > rateLimit || getStdDev() > temperatureBand / 2.0f;
+
+  if (outOfBand) {
+    // Step change: sample at full rate around the new level
+    intervalMs = minIntervalMs;
+    referenceTemperature = temperature;
+    referenceHumidity = humidity;
+  } else if (unsettled) {
+    intervalMs = intervalMs / 2 < minIntervalMs ? minIntervalMs : intervalMs / 2;
+  } else {
+    intervalMs = intervalMs * 2 > maxIntervalMs ? maxIntervalMs : intervalMs * 2;
+  }
+  return intervalMs;
+}
@@ -0,0 +1,130 @@
+#include "alert_monitor.h"
+#include <math.h>
+
+static uint8_t maskOf(AlertType type) {
+  return static_cast<uint8_t>(1u << static_cast<uint8_t>(type));
+}
+
+void AlertMonitor::configure(const AlertThresholds& newThresholds) {
+  thresholds = newThresholds;
+}
+
+bool AlertMonitor::isActive(AlertType type) const {
+  return (activeMask & maskOf(type)) != 0;
+}
+
+bool AlertMonitor::isPending(AlertType type) const {
+  return (pendingMask & maskOf(type)) != 0;
+}
+
+uint64_t AlertMonitor::getDetectedMs(AlertType type) const {
+  return detectedMs[static_cast<uint8_t>(type)];
+}
+
+void AlertMonitor::updateLevel(AlertType type, bool breached, bool cleared, uint64_t timeMs,
+                               AlertType* raised) {
+  if (!isActive(type) && breached) {
+    activeMask |= maskOf(type);
+    if (!isPending(type)) {
+      // A re-raise before the first one went out keeps the original detection time
+      pendingMask |= maskOf(type);
+      detectedMs[static_cast<uint8_t>(type)] = timeMs;
+    }
+    if (*raised == AlertType::None) {
+      *raised = type;
+    }
+  } else if (isActive(type) && cleared) {
+    activeMask &= ~maskOf(type);
+  }
+}
+
+AlertType AlertMonitor::evaluate(float temperature, float humidity, uint64_t timeMs) {
+  AlertType raised = AlertType::None;
+  const float h = thresholds.hysteresis;
+  lastTemperature = temperature;
+  lastHumidity = humidity;
+
+  updateLevel(AlertType::HighTemperature, temperature > thresholds.highTemperature,
+              temperature < thresholds.highTemperature - h, timeMs, &raised);
+  updateLevel(AlertType::LowTemperature, temperature < thresholds.lowTemperature,
+              temperature > thresholds.lowTemperature + h, timeMs, &raised);
+  updateLevel(AlertType::HighHumidity, humidity > thresholds.highHumidity,
+              humidity < thresholds.highHumidity - h, timeMs, &raised);
+  updateLevel(AlertType::LowHumidity, humidity < thresholds.lowHumidity,
+              humidity > thresholds.lowHumidity + h, timeMs, &raised);
+
+  // Rate over a window rather than between consecutive checks, so sensor
+  // quantization (1 °C on a DHT11) does not read as a fast change
+  if (!primed) {
+    primed = true;
+    rateReferenceTemperature = temperature;
+    rateReferenceMs = timeMs;
+    lastRate = 0.0f;
+  } else if (timeMs - rateReferenceMs >= thresholds.rateWindowMs) {
+    float minutes = (timeMs - rateReferenceMs) / 60000.0f;
+    lastRate = (temperature - rateReferenceTemperature) / minutes;
+    rateReferenceTemperature = temperature;
+    rateReferenceMs = timeMs;
+    updateLevel(AlertType::RateOfChange, fabsf(lastRate) > thresholds.maxRatePerMinute,
+                fabsf(lastRate) < thresholds.maxRatePerMinute / 2.0f, timeMs, &raised);
+  }
+
+  // Nothing new: hand back the oldest alarm whose publish has not gone out
+  if (raised == AlertType::None && pendingMask != 0) {
+    uint64_t oldestMs = UINT64_MAX;
+    for (uint8_t i = 1; i < ALERT_TYPE_COUNT; i++) {
+      AlertType type = static_cast<AlertType>(i);
+      if (isPending(type) && detectedMs[i] < oldestMs) {
+        oldestMs = detectedMs[i];
+        raised = type;
+      }
+    }
+  }
+  return raised;
+}
+
+bool AlertMonitor::isNearThreshold(float margin) const {
+  if (!primed || activeMask != 0) {
+    return true;
+  }
+  return fabsf(lastTemperature - thresholds.highTemperature) <= margin ||
+         fabsf(lastTemperature - thresholds.lowTemperature) <= margin ||
+         fabsf(lastHumidity - thresholds.highHumidity) <= margin ||
+         fabsf(lastHumidity - thresholds.lowHumidity) <= margin;
+}
+
+void AlertMonitor::acknowledge(AlertType type, uint64_t publishedMs) {
+  if (!isPending(type)) {
+    return;
+  }
+  pendingMask &= ~maskOf(type);
+  uint64_t raisedMs = getDetectedMs(type);
+  uint32_t latency = publishedMs > raisedMs ? static_cast<uint32_t>(publishedMs - raisedMs) : 0;
+  alarmCount++;
+  lastLatencyMs = latency;
+  totalLatencyMs += latency;
+  if (latency > maxLatencyMs) {
+    maxLatencyMs = latency;
+  }
+}
+
+uint32_t AlertMonitor::getMeanLatencyMs() const {
+  return alarmCount ? static_cast<uint32_t>(totalLatencyMs / alarmCount) : 0;
+}
+
+const char* AlertMonitor::describe(AlertType type) {
+  switch (type) {
+    case AlertType::HighTemperature:
+      return "High temperature";
+    case AlertType::LowTemperature:
+      return "Low temperature";
+    case AlertType::HighHumidity:
+      return "High humidity";
+    case AlertType::LowHumidity:
+      return "Low humidity";
+    case AlertType::RateOfChange:
+      return "Rapid temperature change";
+    default:
+      return "None";
+  }
+}
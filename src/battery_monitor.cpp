@@ -0,0 +1,83 @@
+#include "battery_monitor.h"
+#include "config.h"
+#include "hal.h"
+
+// Resting voltage of a single Li-ion/LiPo cell against state of charge
+// (typical 0.2C discharge curve); linear between points
+struct CurvePoint {
+  uint16_t millivolts;
+  uint8_t percent;
+};
+
+static const CurvePoint DISCHARGE_CURVE[] = {
+  { 3000, 0 },  { 3450, 5 },  { 3680, 10 }, { 3740, 20 }, { 3770, 30 }, { 3790, 40 },
+  { 3820, 50 }, { 3870, 60 }, { 3920, 70 }, { 3980, 80 }, { 4060, 90 }, { 4200, 100 },
+};
+static const uint8_t CURVE_POINTS = sizeof(DISCHARGE_CURVE) / sizeof(DISCHARGE_CURVE[0]);
+
+void BatteryMonitor::reset() {
+  filteredMv = 0;
+  lastMv = 0;
+}
+
+bool BatteryMonitor::measure() {
+  uint32_t sum = 0;
+  uint32_t lowest = UINT32_MAX;
+  uint32_t highest = 0;
+  for (uint8_t i = 0; i < BATTERY_ADC_SAMPLES; i++) {
+    uint32_t reading = Hal::bus().analogReadMillivolts(BATTERY_ADC_PIN);
+    sum += reading;
+    lowest = reading < lowest ? reading : lowest;
+    highest = reading > highest ? reading : highest;
+  }
+  // Trimmed mean: one outlier on either side does not count
+  uint32_t pinMv = BATTERY_ADC_SAMPLES > 2 ? (sum - lowest - highest) / (BATTERY_ADC_SAMPLES - 2)
+                                           : sum / BATTERY_ADC_SAMPLES;
+
+  lastMv = cellMillivolts(pinMv);
+  if (lastMv < MIN_PRESENT_MV) {
+    filteredMv = 0;
+    return false;
+  }
+  filteredMv = filteredMv == 0 ? lastMv
+                               : (uint16_t)(filteredMv + SMOOTHING * ((float)lastMv - filteredMv) + 0.5f);
+  return true;
+}
+
+uint16_t BatteryMonitor::cellMillivolts(uint32_t pinMillivolts) {
+  float cell = BATTERY_CAL_GAIN * (pinMillivolts * BATTERY_DIVIDER_RATIO) + BATTERY_CAL_OFFSET_MV;
+  if (cell <= 0.0f) {
+    return 0;
+  }
+  return cell >= UINT16_MAX ? UINT16_MAX : (uint16_t)(cell + 0.5f);
+}
+
+uint8_t BatteryMonitor::stateOfCharge(uint16_t cellMv) {
+  if (cellMv <= DISCHARGE_CURVE[0].millivolts) {
+    return 0;
+  }
+  for (uint8_t i = 1; i < CURVE_POINTS; i++) {
+    const CurvePoint& upper = DISCHARGE_CURVE[i];
+    if (cellMv < upper.millivolts) {
+      const CurvePoint& lower = DISCHARGE_CURVE[i - 1];
+      return lower.percent + (uint8_t)((uint32_t)(cellMv - lower.millivolts) * (upper.percent - lower.percent) /
+                                       (upper.millivolts - lower.millivolts));
+    }
+  }
+  return 100;
+}
+
+uint16_t BatteryMonitor::restingMillivolts(float percent) {
+  if (percent <= 0.0f) {
+    return DISCHARGE_CURVE[0].millivolts;
+  }
+  for (uint8_t i = 1; i < CURVE_POINTS; i++) {
+    const CurvePoint& upper = DISCHARGE_CURVE[i];
+    if (percent < upper.percent) {
+      const CurvePoint& lower = DISCHARGE_CURVE[i - 1];
+      return lower.millivolts + (uint16_t)((percent - lower.percent) * (upper.millivolts - lower.millivolts) /
+                                           (upper.percent - lower.percent));
+    }
+  }
+  return DISCHARGE_CURVE[CURVE_POINTS - 1].millivolts;
+}
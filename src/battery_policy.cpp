@@ -0,0 +1,62 @@
+#include "battery_policy.h"
+
+static const char* TIER_NAMES[BATTERY_TIER_COUNT] = { "normal", "conserve", "low", "critical" };
+
+void BatteryPolicy::configure(const uint8_t tierStartPercent[BATTERY_TIER_COUNT], uint8_t hysteresisPercent,
+                              const BatteryTierSettings tierSettings[BATTERY_TIER_COUNT]) {
+  for (uint8_t i = 0; i < BATTERY_TIER_COUNT; i++) {
+    tierStart[i] = tierStartPercent[i];
+    settings[i] = tierSettings[i];
+    if (settings[i].sleepMultiplier == 0) {
+      settings[i].sleepMultiplier = 1;
+    }
+    if (settings[i].publishEvery == 0) {
+      settings[i].publishEvery = 1;
+    }
+  }
+  hysteresis = hysteresisPercent;
+  if ((uint8_t)tier >= BATTERY_TIER_COUNT) {
+    reset(); // RTC memory held garbage
+  }
+}
+
+void BatteryPolicy::reset() {
+  tier = BatteryTier::Normal;
+  readingsSincePublish = 0;
+}
+
+BatteryTier BatteryPolicy::tierFor(int stateOfCharge) const {
+  uint8_t index = 0;
+  for (uint8_t i = 1; i < BATTERY_TIER_COUNT; i++) {
+    if (stateOfCharge < tierStart[i]) {
+      index = i;
+    }
+  }
+  return (BatteryTier)index;
+}
+
+bool BatteryPolicy::update(uint8_t stateOfCharge) {
+  BatteryTier previous = tier;
+  BatteryTier down = tierFor(stateOfCharge);
+  BatteryTier up = tierFor((int)stateOfCharge - hysteresis);
+
+  if (down > tier) {
+    tier = down;
+  } else if (up < tier) {
+    tier = up;
+  }
+  return tier != previous;
+}
+
+bool BatteryPolicy::takePublishSlot() {
+  readingsSincePublish++;
+  if (readingsSincePublish < getSettings().publishEvery) {
+    return false;
+  }
+  readingsSincePublish = 0;
+  return true;
+}
+
+const char* BatteryPolicy::tierName(BatteryTier tier) {
+  return (uint8_t)tier < BATTERY_TIER_COUNT ? TIER_NAMES[(uint8_t)tier] : "unknown";
+}
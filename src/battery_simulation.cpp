@@ -0,0 +1,78 @@
+#ifndef ARDUINO
+
+#include "battery_simulation.h"
+#include <stdio.h>
+#include "battery_monitor.h"
+#include "blynk_pins.h"
+#include "config.h"
+#include "energy_model.h"
+#include "hal_fake.h"
+
+static const double MICROS_PER_DAY = 86400e6;
+
+void BatterySimulation::begin() {
+  usedMah = 0.0f;
+  lastTotalMicros = FakeHal::clock().totalMicros();
+  lastSleepMicros = FakeHal::power().sleepMicros();
+  lastRadioMicros = FakeHal::network().radioOnMicros() + FakeHal::peers().radioOnMicros();
+  lastTier = BatteryTier::Normal;
+  step();
+  printLine("start");
+}
+
+void BatterySimulation::step() {
+  uint64_t totalMicros = FakeHal::clock().totalMicros();
+  uint64_t sleepMicros = FakeHal::power().sleepMicros();
+  uint64_t radioMicros = FakeHal::network().radioOnMicros() + FakeHal::peers().radioOnMicros();
+
+  uint64_t elapsed = totalMicros - lastTotalMicros;
+  uint64_t slept = sleepMicros - lastSleepMicros;
+  uint64_t awake = elapsed > slept ? elapsed - slept : 0;
+  uint64_t radio = radioMicros - lastRadioMicros;
+  uint64_t cpuOnly = awake > radio ? awake - radio : 0;
+
+  // Radio time is a subset of awake time, as in EnergyModel::energyMillijoules()
+  float cpuMa = EnergyModel::cpuCurrentMa(FakeHal::power().cpuFrequencyMhz());
+  usedMah += (EnergyModel::RADIO_CURRENT_MA * radio + cpuMa * cpuOnly +
+              EnergyModel::DEEP_SLEEP_CURRENT_MA * slept) / 3600e6f;
+
+  lastTotalMicros = totalMicros;
+  lastSleepMicros = sleepMicros;
+  lastRadioMicros = radioMicros;
+
+  // Invert the divider and the board calibration the monitor applies
+  float cellMv = BatteryMonitor::restingMillivolts(stateOfCharge());
+  float pinMv = (cellMv - BATTERY_CAL_OFFSET_MV) / BATTERY_CAL_GAIN / BATTERY_DIVIDER_RATIO;
+  FakeHal::bus().setAnalogMillivolts(BATTERY_ADC_PIN, pinMv > 0.0f ? (uint32_t)(pinMv + 0.5f) : 0);
+}
+
+void BatterySimulation::observeTier(BatteryTier tier) {
+  if (tier != lastTier) {
+    lastTier = tier;
+    printLine(BatteryPolicy::tierName(tier));
+  }
+}
+
+float BatterySimulation::stateOfCharge() const {
+  float remaining = capacityMah > 0.0f ? 100.0f * (capacityMah - usedMah) / capacityMah : 0.0f;
+  return remaining > 0.0f ? remaining : 0.0f;
+}
+
+void BatterySimulation::printLine(const char* event) const {
+  printf("  day %7.2f  %5.1f%%  %4u mV  %s\n", FakeHal::clock().totalMicros() / MICROS_PER_DAY,
+         stateOfCharge(), BatteryMonitor::restingMillivolts(stateOfCharge()), event);
+}
+
+void BatterySimulation::printReport() const {
+  double days = FakeHal::clock().totalMicros() / MICROS_PER_DAY;
+  printLine(empty() ? "empty" : "end of run");
+  printf("=== Discharge Report ===\n");
+  printf("Capacity: %.0f mAh, used %.1f mAh\n", capacityMah, usedMah);
+  printf("%s %.2f days\n", empty() ? "Battery life:" : "Still running after", days);
+  printf("Average current: %.3f mA\n", days > 0.0 ? usedMah / (days * 24.0) : 0.0);
+  printf("Publishes (Blynk): %lu\n", FakeHal::blynk().writeCount(BLYNK_VIRTUAL_PIN_TEMP));
+  printf("Publishes (HomeKit): %lu\n", FakeHal::homekit().updateCount() / 2);
+  printf("METRIC battery_life_days=%.2f\n", days);
+}
+
+#endif // ARDUINO
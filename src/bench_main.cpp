@@ -0,0 +1,235 @@
+#ifdef BENCHMARK_BUILD
+
+// Entry point for the bench_native and bench_esp32 environments: runs every
+// hot-kernel benchmark once and prints one JSON line per kernel.
+
+#include <Arduino.h>
+#include "config.h"
+#include "benchmark.h"
+#include "climate_manager.h"
+#include "blynk_manager.h"
+#include "trace.h"
+#include "adaptive_sampler.h"
+#include "gateway_node.h"
+#include "http_request.h"
+#include "metrics_server.h"
+#include "rolling_stats.h"
+
+#ifndef ARDUINO
+#include "hal_fake.h"
+#endif
+
+static ClimateManager* benchSensor = nullptr;
+
+#if BLYNK_ENABLED && !defined(ARDUINO)
+// Needs a live session, which only the host fakes provide offline
+static BlynkManager benchBlynk;
+#endif
+
+static void benchHeatIndex(uint32_t iterations) {
+  float sum = 0.0f;
+  for (uint32_t i = 0; i < iterations; i++) {
+    float temperature = 20.0f + (i % 200) * 0.1f; // Covers both formula branches
+    float humidity = 30.0f + (i % 60);
+    sum += ClimateManager::calculateHeatIndex(temperature, humidity);
+  }
+  Benchmark::consume(sum);
+}
+
+static void benchSensorRead(uint32_t iterations) {
+  sensors_event_t tempEvent, humidityEvent;
+  float sum = 0.0f;
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchSensor->getTemperatureEvent(&tempEvent);
+    benchSensor->getHumidityEvent(&humidityEvent);
+    sum += tempEvent.temperature + humidityEvent.relative_humidity;
+  }
+  Benchmark::consume(sum);
+}
+
+static void benchTraceParse(uint32_t iterations) {
+  TraceEvent event;
+  uint32_t parsed = 0;
+  for (uint32_t i = 0; i < iterations; i++) {
+    parsed += parseTraceLine("12:00:00.123 > TRACE,86400000,S,21.37,45.20", &event);
+  }
+  Benchmark::consume(parsed);
+}
+
+static void benchAdaptiveSampler(uint32_t iterations) {
+  AdaptiveSampler sampler{};
+  sampler.configure(60000, 900000, 0.3f, 2.0f, 0.02f);
+  uint32_t sum = 0;
+  uint64_t sampledMs = 0;
+  for (uint32_t i = 0; i < iterations; i++) {
+    sampledMs += sampler.getIntervalMs();
+    sum += sampler.update(21.0f + (i % 16) * 0.05f, 45.0f, sampledMs);
+  }
+  Benchmark::consume(sum);
+}
+
+// One sample into all six windows, at a 10 s cadence so buckets roll over
+static void benchRollingStatsAdd(uint32_t iterations) {
+  static RollingStats stats;
+  stats.configure();
+  for (uint32_t i = 0; i < iterations; i++) {
+    stats.add(i * 10000ULL, 21.0f + (i % 16) * 0.05f, 45.0f + (i % 7));
+  }
+  Benchmark::consume(stats.getStats(2, RollingQuantity::Temperature, iterations * 10000ULL).mean);
+}
+
+// Typical Prometheus scrape request
+static const char SCRAPE_REQUEST[] =
+  "GET /metrics HTTP/1.1\r\n"
+  "Host: 192.168.4.2:9100\r\n"
+  "User-Agent: Prometheus/2.53.0\r\n"
+  "Accept: application/openmetrics-text;version=1.0.0;q=0.5,text/plain;version=0.0.4;q=0.3,*/*;q=0.1\r\n"
+  "Accept-Encoding: gzip\r\n"
+  "X-Prometheus-Scrape-Timeout-Seconds: 10\r\n"
+  "\r\n";
+
+static void benchHttpParse(uint32_t iterations) {
+  HttpRequestParser parser;
+  uint32_t complete = 0;
+  for (uint32_t i = 0; i < iterations; i++) {
+    parser.reset();
+    complete += parser.feed((const uint8_t*)SCRAPE_REQUEST, sizeof(SCRAPE_REQUEST) - 1) ==
+                HttpParseStatus::Complete;
+  }
+  Benchmark::consume(complete);
+}
+
+static void benchMetricsRender(uint32_t iterations) {
+  static char buffer[METRICS_RESPONSE_SIZE];
+  MetricsSnapshot snapshot = {};
+  snapshot.readingValid = true;
+  snapshot.humidity = 45.0f;
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < iterations; i++) {
+    snapshot.temperature = 21.0f + (i % 10) * 0.1f;
+    snapshot.heatIndex = snapshot.temperature;
+    snapshot.readings = i;
+    total += MetricsServer::render(snapshot, buffer, sizeof(buffer));
+  }
+  Benchmark::consume(total);
+}
+
+#ifndef ARDUINO
+// Scrape load: back-to-back clients through the fake listener, request
+// delivered in 64-byte segments, one service() call per loop pass
+static void benchMetricsScrape(uint32_t iterations) {
+  unsigned long before = FakeHal::http().closedCount();
+  for (uint32_t i = 0; i < iterations; i++) {
+    FakeHal::http().queueRequest(SCRAPE_REQUEST);
+    while (FakeHal::http().closedCount() - before <= i) {
+      MetricsServer::service();
+    }
+  }
+  Benchmark::consume((uint32_t)FakeHal::http().bytesWritten());
+}
+
+// Leaf frames through the in-process loopback into the gateway queue and aggregator
+static void benchGatewayLoopback(uint32_t iterations) {
+  GatewayNode::aggregator().reset();
+  uint8_t mac[6] = { 0x24, 0x0A, 0xC4, 0x00, 0x01, 0x00 };
+  uint8_t payload[SAMPLE_FRAME_SIZE];
+  SampleFrame frame = {};
+  uint32_t published = 0;
+
+  for (uint32_t i = 0; i < iterations; i++) {
+    mac[5] = i % GATEWAY_MAX_LEAVES;
+    FakeHal::peers().setLocalMac(mac);
+    frame.sequence = i / GATEWAY_MAX_LEAVES + 1;
+    frame.temperature = 21.0f + (i % 10) * 0.1f;
+    frame.humidity = 45.0f;
+    size_t length = encodeSampleFrame(frame, payload, sizeof(payload));
+    Hal::peers().send(mac, payload, length);
+
+    if (i % GATEWAY_MAX_LEAVES == GATEWAY_MAX_LEAVES - 1) {
+      GatewayNode::poll();
+      while (GatewayNode::aggregator().takePending() >= 0) {
+        published++;
+      }
+    }
+  }
+  Benchmark::consume(published);
+}
+#endif
+
+#if BLYNK_ENABLED && !defined(ARDUINO)
+static void benchBlynkSendSensorData(uint32_t iterations) {
+  Serial.setEcho(false);
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchBlynk.sendSensorData(21.0f + (i % 10) * 0.1f, 45.0f, 21.5f);
+  }
+  Serial.setEcho(true);
+}
+#endif
+
+static const BenchmarkCase BENCHMARKS[] = {
+  { "heat_index", benchHeatIndex, 1000 },
+  { "sensor_read", benchSensorRead, 20 },
+  { "trace_parse", benchTraceParse, 1000 },
+  { "adaptive_sampler_update", benchAdaptiveSampler, 1000 },
+  { "rolling_stats_add", benchRollingStatsAdd, 1000 },
+  { "http_parse", benchHttpParse, 1000 },
+  { "metrics_render", benchMetricsRender, 200 },
+#ifndef ARDUINO
+  { "gateway_loopback", benchGatewayLoopback, 1000 },
+  { "metrics_scrape", benchMetricsScrape, 200 },
+#endif
+#if BLYNK_ENABLED && !defined(ARDUINO)
+  { "blynk_send_sensor_data", benchBlynkSendSensorData, 200 },
+#endif
+};
+
+static void runBenchmarks() {
+  benchSensor = createClimateSensor();
+  benchSensor->begin();
+
+#ifndef ARDUINO
+  Serial.setEcho(false);
+  GatewayNode::begin();
+  FakeHal::network().begin(WIFI_SSID, WIFI_PASSWORD);
+  FakeHal::clock().delay(5000);
+  MetricsServer::begin(nullptr);
+  Serial.setEcho(true);
+#endif
+
+#if BLYNK_ENABLED && !defined(ARDUINO)
+  Serial.setEcho(false);
+  benchBlynk.begin();
+  Serial.setEcho(true);
+#endif
+
+  Serial.println("# benchmarks begin");
+  for (const BenchmarkCase& benchmark : BENCHMARKS) {
+    Benchmark::run(benchmark);
+  }
+  Serial.println("# benchmarks end");
+}
+
+#ifdef ARDUINO
+
+void setup() {
+  Serial.begin(SERIAL_BAUD_RATE);
+  delay(1000);
+  runBenchmarks();
+}
+
+void loop() {
+  delay(1000);
+}
+
+#else
+
+int main() {
+  FakeHal::reset();
+  runBenchmarks();
+  Serial.flush();
+  return 0;
+}
+
+#endif // ARDUINO
+
+#endif // BENCHMARK_BUILD
@@ -0,0 +1,67 @@
+#include "benchmark.h"
+#include <math.h>
+
+#ifndef ARDUINO
+#include <chrono>
+#endif
+
+volatile float Benchmark::floatSink = 0.0f;
+volatile uint32_t Benchmark::intSink = 0;
+
+uint32_t Benchmark::ticks() {
+#ifdef ARDUINO
+  return ESP.getCycleCount();
+#else
+  using namespace std::chrono;
+  return static_cast<uint32_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+const char* Benchmark::unit() {
+#ifdef ARDUINO
+  return "cycles";
+#else
+  return "ns";
+#endif
+}
+
+void Benchmark::run(const BenchmarkCase& benchmark) {
+  float samples[REPETITIONS];
+
+  benchmark.function(benchmark.iterations); // Warm-up: caches, lazy init
+
+  for (uint8_t rep = 0; rep < REPETITIONS; rep++) {
+    uint32_t start = ticks();
+    benchmark.function(benchmark.iterations);
+    uint32_t elapsed = ticks() - start; // Unsigned math handles one wrap
+    samples[rep] = static_cast<float>(elapsed) / benchmark.iterations;
+  }
+
+  // Insertion sort; REPETITIONS is tiny
+  for (uint8_t i = 1; i < REPETITIONS; i++) {
+    float value = samples[i];
+    int8_t j = i - 1;
+    while (j >= 0 && samples[j] > value) {
+      samples[j + 1] = samples[j];
+      j--;
+    }
+    samples[j + 1] = value;
+  }
+
+  float mean = 0.0f;
+  for (uint8_t rep = 0; rep < REPETITIONS; rep++) {
+    mean += samples[rep];
+  }
+  mean /= REPETITIONS;
+
+  float variance = 0.0f;
+  for (uint8_t rep = 0; rep < REPETITIONS; rep++) {
+    variance += (samples[rep] - mean) * (samples[rep] - mean);
+  }
+  variance /= REPETITIONS - 1;
+
+  Serial.printf("{\"bench\":\"%s\",\"unit\":\"%s\",\"iters\":%u,\"reps\":%u,"
+                "\"median\":%.2f,\"mean\":%.2f,\"stddev\":%.2f,\"min\":%.2f,\"max\":%.2f}\n",
+                benchmark.name, unit(), (unsigned)benchmark.iterations, (unsigned)REPETITIONS,
+                samples[REPETITIONS / 2], mean, sqrtf(variance), samples[0], samples[REPETITIONS - 1]);
+}
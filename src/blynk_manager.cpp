@@ -2,65 +2,27 @@
 
 #if BLYNK_ENABLED
 
-// Comment this out to disable prints and save space
-#define BLYNK_PRINT Serial
-
-#include <BlynkSimpleEsp32.h>
-
 BlynkManager* blynkManagerInstance = nullptr;
 
-// Blynk callbacks
-BLYNK_CONNECTED() {
-  if (blynkManagerInstance) {
-    BlynkManager::onConnected();
-  }
-}
-
-BLYNK_DISCONNECTED() {
-  if (blynkManagerInstance) {
-    BlynkManager::onDisconnected();
-  }
-}
-
-// Blynk App requests for current values
-BLYNK_READ(BLYNK_VIRTUAL_PIN_TEMP) {
-  // This will be called when Blynk app requests temperature value
-  // The actual value will be sent via sendSensorData()
-}
-
-BLYNK_READ(BLYNK_VIRTUAL_PIN_HUMIDITY) {
-  // This will be called when Blynk app requests humidity value
-  // The actual value will be sent via sendSensorData()
-}
-
-BLYNK_READ(BLYNK_VIRTUAL_PIN_HEAT_INDEX) {
-  // This will be called when Blynk app requests heat index value
-  // The actual value will be sent via sendSensorData()
-}
-
-BLYNK_READ(BLYNK_VIRTUAL_PIN_STATUS) {
-  // This will be called when Blynk app requests status
-  // The actual status will be sent via sendStatus()
-}
-
 // BlynkManager Implementation
-BlynkManager::BlynkManager() : initialized(false), lastConnectionCheck(0) {
+BlynkManager::BlynkManager() : initialized(false), lastConnectionCheck(0), reconnects(0) {
   blynkManagerInstance = this;
 }
 
 bool BlynkManager::begin() {
-  if (!WiFi.isConnected()) {
+  if (!Hal::network().isConnected()) {
     Serial.println("✗ Blynk disabled - WiFi required");
     return false;
   }
 
   Serial.println("✓ Initializing Blynk...");
+  Hal::blynk().setConnectionCallbacks(BlynkManager::onConnected, BlynkManager::onDisconnected);
   
   // Connect to Blynk server using the auth token from config
-  Blynk.begin(BLYNK_AUTH_TOKEN, WIFI_SSID, WIFI_PASSWORD);
+  Hal::blynk().begin(BLYNK_AUTH_TOKEN, WIFI_SSID, WIFI_PASSWORD);
   
   // Check if connected
-  if (Blynk.connected()) {
+  if (Hal::blynk().connected()) {
     Serial.println("✓ Connected to Blynk server!");
     initialized = true;
     
@@ -89,8 +51,8 @@ bool BlynkManager::begin() {
 }
 
 void BlynkManager::run() {
-  if (initialized && WiFi.isConnected()) {
-    Blynk.run();
+  if (initialized && Hal::network().isConnected()) {
+    Hal::blynk().run();
     
     // Periodic connection check
     unsigned long currentMillis = millis();
@@ -104,13 +66,13 @@ void BlynkManager::run() {
 void BlynkManager::sendSensorData(float temperature, float humidity, float heatIndex) {
   if (initialized && isConnected()) {
     // Send temperature
-    Blynk.virtualWrite(BLYNK_VIRTUAL_PIN_TEMP, temperature);
+    Hal::blynk().virtualWrite(BLYNK_VIRTUAL_PIN_TEMP, temperature);
     
     // Send humidity  
-    Blynk.virtualWrite(BLYNK_VIRTUAL_PIN_HUMIDITY, humidity);
+    Hal::blynk().virtualWrite(BLYNK_VIRTUAL_PIN_HUMIDITY, humidity);
     
     // Send heat index
-    Blynk.virtualWrite(BLYNK_VIRTUAL_PIN_HEAT_INDEX, heatIndex);
+    Hal::blynk().virtualWrite(BLYNK_VIRTUAL_PIN_HEAT_INDEX, heatIndex);
     
 #if SERIAL_DEBUG_VERBOSE
     Serial.println("📱 Data sent to Blynk");
@@ -130,7 +92,7 @@ void BlynkManager::sendSensorData(float temperature, float humidity, float heatI
 void BlynkManager::sendStatus(const String& sensorName, bool isOnline) {
   if (initialized && isConnected()) {
     String status = isOnline ? "Online" : "Offline";
-    Blynk.virtualWrite(BLYNK_VIRTUAL_PIN_STATUS, status);
+    Hal::blynk().virtualWrite(BLYNK_VIRTUAL_PIN_STATUS, status.c_str());
     
 #if SERIAL_DEBUG_VERBOSE
     Serial.print("📱 Status sent to Blynk: ");
@@ -139,12 +101,56 @@ void BlynkManager::sendStatus(const String& sensorName, bool isOnline) {
   }
 }
 
+void BlynkManager::sendAlert(const char* description, float temperature, float humidity, float heatIndex) {
+  if (initialized && isConnected()) {
+    sendSensorData(temperature, humidity, heatIndex);
+    Hal::blynk().logEvent(BLYNK_ALERT_EVENT_CODE, description);
+    
+    Serial.print("📱 Alert event sent to Blynk: ");
+    Serial.println(description);
+  }
+}
+
+void BlynkManager::sendLeafData(uint8_t leaf, float temperature, float humidity, float heatIndex) {
+  if (initialized && isConnected() && leaf < GATEWAY_MAX_LEAVES) {
+    int basePin = GATEWAY_BLYNK_PIN_BASE + leaf * LEAF_PIN_COUNT;
+    Hal::blynk().virtualWrite(basePin, temperature);
+    Hal::blynk().virtualWrite(basePin + 1, humidity);
+    Hal::blynk().virtualWrite(basePin + 2, heatIndex);
+  }
+}
+
+void BlynkManager::writeWindowStats(int basePin, const WindowStats& stats) {
+  if (stats.count == 0) {
+    return; // Nothing in the window yet: leave the widgets as they are
+  }
+  Hal::blynk().virtualWrite(basePin, stats.mean);
+  Hal::blynk().virtualWrite(basePin + 1, stats.min);
+  Hal::blynk().virtualWrite(basePin + 2, stats.max);
+  Hal::blynk().virtualWrite(basePin + 3, stats.stddev);
+}
+
+void BlynkManager::sendWindowStats(uint8_t window, const WindowStats& temperature, const WindowStats& humidity) {
+  if (initialized && isConnected()) {
+    int basePin = ROLLING_STATS_PIN_BASE + window * WINDOW_PIN_COUNT;
+    writeWindowStats(basePin, temperature);
+    writeWindowStats(basePin + 4, humidity);
+  }
+}
+
+void BlynkManager::sendBattery(uint8_t percent, float volts) {
+  if (initialized && isConnected()) {
+    Hal::blynk().virtualWrite(BLYNK_VIRTUAL_PIN_BATTERY_LEVEL, (float)percent);
+    Hal::blynk().virtualWrite(BLYNK_VIRTUAL_PIN_BATTERY_VOLTAGE, volts);
+  }
+}
+
 bool BlynkManager::isConnected() {
-  return initialized && Blynk.connected();
+  return initialized && Hal::blynk().connected();
 }
 
 void BlynkManager::checkConnection() {
-  if (initialized && WiFi.isConnected() && !Blynk.connected()) {
+  if (initialized && Hal::network().isConnected() && !Hal::blynk().connected()) {
 #if SERIAL_DEBUG_VERBOSE
     Serial.println("⚠️  Blynk connection lost! Attempting to reconnect...");
 #else
@@ -152,9 +158,10 @@ void BlynkManager::checkConnection() {
 #endif
     
     // Try to reconnect using begin() again
-    Blynk.begin(BLYNK_AUTH_TOKEN, WIFI_SSID, WIFI_PASSWORD);
+    reconnects++;
+    Hal::blynk().begin(BLYNK_AUTH_TOKEN, WIFI_SSID, WIFI_PASSWORD);
     
-    if (Blynk.connected()) {
+    if (Hal::blynk().connected()) {
       Serial.println("✓ Blynk reconnected!");
     } else {
       Serial.println("✗ Blynk reconnection failed");
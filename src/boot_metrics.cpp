@@ -0,0 +1,57 @@
+#include "boot_metrics.h"
+
+unsigned long BootMetrics::setupMs = 0;
+unsigned long BootMetrics::firstSampleMs = 0;
+unsigned long BootMetrics::firstPublishMs = 0;
+bool BootMetrics::setupMarked = false;
+bool BootMetrics::sampleMarked = false;
+bool BootMetrics::publishMarked = false;
+
+void BootMetrics::reset() {
+  setupMs = 0;
+  firstSampleMs = 0;
+  firstPublishMs = 0;
+  setupMarked = false;
+  sampleMarked = false;
+  publishMarked = false;
+}
+
+void BootMetrics::markSetupComplete() {
+  if (!setupMarked) {
+    setupMs = millis();
+    setupMarked = true;
+    Serial.print("METRIC boot_setup_ms=");
+    Serial.println(setupMs);
+  }
+}
+
+void BootMetrics::markFirstSample() {
+  if (!sampleMarked) {
+    firstSampleMs = millis();
+    sampleMarked = true;
+  }
+}
+
+void BootMetrics::markFirstPublish() {
+  if (!publishMarked) {
+    firstPublishMs = millis();
+    publishMarked = true;
+    report();
+  }
+}
+
+void BootMetrics::report() {
+  if (sampleMarked) {
+    Serial.print("METRIC boot_to_first_sample_ms=");
+    Serial.println(firstSampleMs);
+  }
+  if (publishMarked) {
+    Serial.print("METRIC boot_to_first_publish_ms=");
+    Serial.println(firstPublishMs);
+    Serial.print("METRIC boot_to_first_publish_target_ms=");
+    Serial.println(FAST_BOOT_TARGET_FIRST_PUBLISH_MS);
+    if (firstPublishMs > FAST_BOOT_TARGET_FIRST_PUBLISH_MS) {
+      Serial.println("⚠️  Boot-to-first-publish exceeded target");
+    }
+  }
+}
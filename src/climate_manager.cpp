@@ -1,4 +1,17 @@
 #include "climate_manager.h"
+#include "hal.h"
+
+RTC_DATA_ATTR uint32_t ClimateManager::sequenceCounter = 0;
+
+void ClimateManager::markAcquired(uint64_t acquiredMs) {
+  lastStamp.acquiredMs = acquiredMs;
+  lastStamp.rtcUs = Hal::clock().rtcMicros();
+}
+
+const SampleStamp& ClimateManager::stamp() {
+  lastStamp.sequence = ++sequenceCounter;
+  return lastStamp;
+}
 
 // Static heat index calculation
 float ClimateManager::calculateHeatIndex(float temperature, float humidity) {
@@ -19,7 +32,10 @@ float ClimateManager::calculateHeatIndex(float temperature, float humidity) {
   return hi;
 }
 
-#if SENSOR_TYPE == SENSOR_TYPE_DHT11 || SENSOR_TYPE == SENSOR_TYPE_DHT22
+#if CLIMATE_SENSOR_SIMULATED
+#include "simulated_climate_manager.h"
+
+#elif SENSOR_TYPE == SENSOR_TYPE_DHT11 || SENSOR_TYPE == SENSOR_TYPE_DHT22
 #include <DHT.h>
 #include <DHT_U.h>
 
@@ -28,6 +44,10 @@ private:
   DHT_Unified dht;
   sensor_t temperature_sensor;
   sensor_t humidity_sensor;
+#if FAST_BOOT_ENABLED
+  static const unsigned long DHT_READY_TIMEOUT = 2500;      // milliseconds
+  static const unsigned long DHT_READY_POLL_INTERVAL = 100; // milliseconds
+#endif
   
 public:
   DHTClimateManager() : dht(DHT_PIN, DHT_TYPE) {}
@@ -40,6 +60,20 @@ public:
     dht.humidity().getSensor(&humidity_sensor);
     
     Serial.println("DHT Unified Sensor initialized");
+    
+#if FAST_BOOT_ENABLED
+    // Poll until the sensor answers instead of a fixed settle time; the
+    // library paces retries at its 2 s minimum read interval
+    sensors_event_t event;
+    unsigned long start = millis();
+    while (!dht.temperature().getEvent(&event) || isnan(event.temperature)) {
+      if (millis() - start >= DHT_READY_TIMEOUT) {
+        Serial.println("Error: DHT temperature sensor not responding");
+        return false;
+      }
+      delay(DHT_READY_POLL_INTERVAL);
+    }
+#else
     delay(2000); // DHT sensors need time to stabilize
     
     // Test sensor functionality
@@ -48,6 +82,7 @@ public:
       Serial.println("Error: DHT temperature sensor not responding");
       return false;
     }
+#endif
     
     return true;
   }
@@ -106,18 +141,36 @@ public:
 
 #include <Wire.h>
 #include <Adafruit_SHT4x.h>
+#include "hal.h"
+#include "i2c_recovery.h"
 
 class SHT41ClimateManager : public ClimateManager {
 private:
   Adafruit_SHT4x sht4x;
   sensor_t temperature_sensor;
   sensor_t humidity_sensor;
+  MeasurementPrecision precision = MeasurementPrecision::High;
+  // One conversion yields both channels: the humidity half of the reading
+  // taken by getTemperatureEvent(), handed out by the next getHumidityEvent()
+  sensors_event_t pendingHumidity;
+  bool humidityPending = false;
+
+  static sht4x_precision_t modeFor(MeasurementPrecision precision) {
+    switch (precision) {
+      case MeasurementPrecision::Low:
+        return SHT4X_LOW_PRECISION;
+      case MeasurementPrecision::Medium:
+        return SHT4X_MED_PRECISION;
+      default:
+        return SHT4X_HIGH_PRECISION;
+    }
+  }
   
 public:
   SHT41ClimateManager() {}
   
   bool begin() override {
-    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
+    Hal::bus().i2cBegin(I2C_SDA_PIN, I2C_SCL_PIN);
     
     if (!sht4x.begin()) {
       Serial.println("Couldn't find SHT4x sensor!");
@@ -127,9 +180,10 @@ public:
     Serial.print("Found SHT4x sensor with serial number 0x");
     Serial.println(sht4x.readSerial(), HEX);
     
-    // Configure sensor
-    sht4x.setPrecision(SHT4X_HIGH_PRECISION);
+    // Configure sensor; the precision is chosen per reading (setPrecision())
+    sht4x.setPrecision(modeFor(precision));
     sht4x.setHeater(SHT4X_NO_HEATER);
+    humidityPending = false;
     
     // Get sensor details
     sht4x.temperature().getSensor(&temperature_sensor);
@@ -140,14 +194,35 @@ public:
   }
   
   bool getTemperatureEvent(sensors_event_t* event) override {
-    sensors_event_t humidity_event; // Required by SHT4x getEvent
-    return sht4x.getEvent(event, &humidity_event);
+    humidityPending = sht4x.getEvent(event, &pendingHumidity);
+    return humidityPending;
   }
   
   bool getHumidityEvent(sensors_event_t* event) override {
+    if (humidityPending) {
+      humidityPending = false;
+      *event = pendingHumidity;
+      return true;
+    }
     sensors_event_t temp_event; // Required by SHT4x getEvent
     return sht4x.getEvent(&temp_event, event);
   }
+
+  void setPrecision(MeasurementPrecision newPrecision) override {
+    precision = newPrecision;
+    sht4x.setPrecision(modeFor(precision));
+  }
+
+  bool pulseHeater() override {
+    // The heater runs for the pulse, then the sensor measures the heated die:
+    // that reading is discarded
+    sensors_event_t temp_event, humidity_event;
+    sht4x.setHeater(SHT41_HEATER_MODE);
+    bool pulsed = sht4x.getEvent(&temp_event, &humidity_event);
+    sht4x.setHeater(SHT4X_NO_HEATER);
+    humidityPending = false;
+    return pulsed;
+  }
   
   void getTemperatureSensor(sensor_t* sensor) override {
     *sensor = temperature_sensor;
@@ -156,6 +231,11 @@ public:
   void getHumiditySensor(sensor_t* sensor) override {
     *sensor = humidity_sensor;
   }
+
+  bool recoverBus() override {
+    // begin() re-attaches Wire and soft-resets the sensor
+    return recoverI2cBus(I2C_SDA_PIN, I2C_SCL_PIN);
+  }
   
   String getSensorName() override {
     return "SHT41";
@@ -167,8 +247,8 @@ public:
     Serial.print("SDA Pin: "); Serial.println(I2C_SDA_PIN);
     Serial.print("SCL Pin: "); Serial.println(I2C_SCL_PIN);
     Serial.println("Protocol: I2C");
-    Serial.println("Precision: High");
-    Serial.println("Heater: Disabled");
+    Serial.print("Precision: "); Serial.println(MeasurementPolicy::precisionName(precision));
+    Serial.print("Heater: pulses above "); Serial.print(SHT41_HEATER_HUMIDITY); Serial.println(" %RH");
     
     Serial.println("\n--- Temperature Sensor ---");
     Serial.print("Name: "); Serial.println(temperature_sensor.name);
@@ -195,7 +275,9 @@ public:
 
 // Factory function implementation
 ClimateManager* createClimateSensor() {
-#if SENSOR_TYPE == SENSOR_TYPE_DHT11 || SENSOR_TYPE == SENSOR_TYPE_DHT22
+#if CLIMATE_SENSOR_SIMULATED
+  return new SimulatedClimateManager();
+#elif SENSOR_TYPE == SENSOR_TYPE_DHT11 || SENSOR_TYPE == SENSOR_TYPE_DHT22
   return new DHTClimateManager();
 #elif SENSOR_TYPE == SENSOR_TYPE_SHT41
   return new SHT41ClimateManager();
@@ -0,0 +1,78 @@
+#ifndef ARDUINO
+
+#include "drift_simulation.h"
+#include <math.h>
+#include <stdio.h>
+#include "config.h"
+#include "hal_fake.h"
+
+#if TIME_SYNC_ENABLED
+#include "time_service.h"
+#endif
+
+static const double MICROS_PER_DAY = 86400e6;
+
+void DriftSimulation::begin() {
+  FakeHal::clock().setRtcDrift(offsetPpm);
+  lastTotalMicros = FakeHal::clock().totalMicros();
+  printLine("start");
+}
+
+void DriftSimulation::step() {
+#if TIME_SYNC_ENABLED
+  uint64_t totalMicros = FakeHal::clock().totalMicros();
+  double drift = offsetPpm + swingPpm * sin(2.0 * M_PI * totalMicros / MICROS_PER_DAY);
+  FakeHal::clock().setRtcDrift(drift);
+
+  WallTime wall = TimeService::now();
+  if (wall.valid) {
+    uint64_t elapsed = totalMicros - lastTotalMicros;
+    driftSumPpm += drift * elapsed;
+    syncedMicros += elapsed;
+
+    int64_t errorMs = (int64_t)wall.unixMs - (int64_t)(FakeHal::timeSync().trueUnixMicros() / 1000);
+    int64_t magnitude = errorMs < 0 ? -errorMs : errorMs;
+    checks++;
+    if (magnitude > (int64_t)wall.errorMs) {
+      violations++;
+    }
+    maxErrorMs = magnitude > maxErrorMs ? magnitude : maxErrorMs;
+    maxBoundMs = wall.errorMs > maxBoundMs ? wall.errorMs : maxBoundMs;
+  }
+  lastTotalMicros = totalMicros;
+
+  if (TimeService::getSyncCount() != lastSyncCount) {
+    lastSyncCount = TimeService::getSyncCount();
+    printLine("sync");
+  }
+#endif
+}
+
+void DriftSimulation::printLine(const char* event) const {
+#if TIME_SYNC_ENABLED
+  printf("  day %7.3f  drift %+9.1f ppm  estimate %+9.1f ppm  correction %+6ld ms  %s\n",
+         FakeHal::clock().totalMicros() / MICROS_PER_DAY,
+         offsetPpm + swingPpm * sin(2.0 * M_PI * FakeHal::clock().totalMicros() / MICROS_PER_DAY),
+         TimeService::getDriftPpm(), (long)TimeService::getLastCorrectionMs(), event);
+#else
+  (void)event;
+#endif
+}
+
+void DriftSimulation::printReport() const {
+  double days = FakeHal::clock().totalMicros() / MICROS_PER_DAY;
+  printf("=== Clock Drift Report ===\n");
+  printf("Simulated: %.2f days, RTC drift %+.0f ppm, daily swing ±%.0f ppm\n", days, offsetPpm, swingPpm);
+  printf("Mean drift while synced: %+.1f ppm\n", syncedMicros ? driftSumPpm / syncedMicros : 0.0);
+  printf("Checks: %llu, outside the error bound: %llu\n", (unsigned long long)checks,
+         (unsigned long long)violations);
+  printf("Max error: %lld ms (largest bound %lu ms)\n", (long long)maxErrorMs, (unsigned long)maxBoundMs);
+  printf("SNTP requests: %lu, answered: %lu\n", FakeHal::timeSync().requestCount(),
+         FakeHal::timeSync().answerCount());
+  printf("Deep sleep wakes: %lu\n", wakes);
+  printf("METRIC time_max_error_ms=%lld\n", (long long)maxErrorMs);
+  printf("METRIC time_bound_violations=%llu\n", (unsigned long long)violations);
+  printf("METRIC time_sntp_requests=%lu\n", FakeHal::timeSync().requestCount());
+}
+
+#endif // ARDUINO
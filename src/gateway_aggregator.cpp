@@ -0,0 +1,71 @@
+#include "gateway_aggregator.h"
+#include <string.h>
+
+GatewayAggregator::GatewayAggregator() {
+  reset();
+}
+
+void GatewayAggregator::reset() {
+  memset(leaves, 0, sizeof(leaves));
+  count = 0;
+  rejected = 0;
+}
+
+int GatewayAggregator::findOrAdd(const uint8_t* mac) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (memcmp(leaves[i].mac, mac, sizeof(leaves[i].mac)) == 0) {
+      return i;
+    }
+  }
+
+  if (count >= GATEWAY_MAX_LEAVES) {
+    return -1;
+  }
+
+  memcpy(leaves[count].mac, mac, sizeof(leaves[count].mac));
+  return count++;
+}
+
+int GatewayAggregator::accept(const uint8_t* mac, const SampleFrame& frame, uint32_t nowMs) {
+  int index = findOrAdd(mac);
+  if (index < 0) {
+    rejected++;
+    return -1;
+  }
+
+  LeafRecord& leaf = leaves[index];
+  if (leaf.frames > 0) {
+    int16_t delta = (int16_t)(frame.sequence - leaf.lastSequence);
+    bool restarted = (frame.flags & SAMPLE_FLAG_COLD_BOOT) || delta <= -DUPLICATE_WINDOW;
+
+    if (delta == 0 || (delta < 0 && !restarted)) {
+      // Lost ACK made the leaf send again, or a stale frame arrived late
+      leaf.duplicates++;
+      return -1;
+    }
+    if (delta > 1 && !restarted) {
+      leaf.missed += delta - 1;
+    }
+  }
+
+  leaf.lastSequence = frame.sequence;
+  leaf.sensorError = frame.flags & SAMPLE_FLAG_SENSOR_ERROR;
+  if (!leaf.sensorError) {
+    leaf.temperature = frame.temperature;
+    leaf.humidity = frame.humidity;
+  }
+  leaf.lastSeenMs = nowMs;
+  leaf.frames++;
+  leaf.pending = true;
+  return index;
+}
+
+int GatewayAggregator::takePending() {
+  for (uint8_t i = 0; i < count; i++) {
+    if (leaves[i].pending) {
+      leaves[i].pending = false;
+      return i;
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,98 @@
+#include "gateway_node.h"
+#include <string.h>
+
+// Static member initialization
+GatewayNode::RawFrame GatewayNode::queue[GatewayNode::QUEUE_SIZE];
+std::atomic<uint8_t> GatewayNode::head(0);
+std::atomic<uint8_t> GatewayNode::tail(0);
+uint32_t GatewayNode::overflows = 0;
+std::atomic<uint32_t> GatewayNode::malformed(0);
+GatewayAggregator GatewayNode::leafAggregator;
+
+bool GatewayNode::begin() {
+  // Modem sleep would miss frames sent while the radio naps
+  Hal::network().setModemSleep(false);
+
+  Hal::peers().setReceiveCallback(GatewayNode::onReceive);
+  if (!Hal::peers().begin(ESPNOW_CHANNEL)) {
+    Serial.println("✗ ESP-NOW initialization failed - leaves cannot report");
+    return false;
+  }
+
+  Serial.println("✓ Gateway listening for leaf nodes");
+#if SERIAL_DEBUG_VERBOSE
+  Serial.print("Gateway MAC (set as ESPNOW_GATEWAY_MAC on leaves): ");
+  Serial.println(Hal::network().macAddress());
+  Serial.print("Leaf capacity: ");
+  Serial.print(GATEWAY_MAX_LEAVES);
+  Serial.print(" (");
+  Serial.print(GATEWAY_HOMEKIT_LEAVES);
+  Serial.println(" bridged to HomeKit)");
+#endif
+  return true;
+}
+
+void GatewayNode::onReceive(const uint8_t* mac, const uint8_t* data, size_t length) {
+  uint8_t currentHead = head.load(std::memory_order_relaxed);
+  uint8_t next = (currentHead + 1) % QUEUE_SIZE;
+  if (next == tail.load(std::memory_order_acquire)) {
+    overflows++;
+    return;
+  }
+  if (length != SAMPLE_FRAME_SIZE) {
+    malformed.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  RawFrame& slot = queue[currentHead];
+  memcpy(slot.mac, mac, sizeof(slot.mac));
+  memcpy(slot.data, data, length);
+  slot.length = length;
+  head.store(next, std::memory_order_release);
+}
+
+int GatewayNode::poll() {
+  int newSamples = 0;
+  uint8_t currentTail = tail.load(std::memory_order_relaxed);
+
+  while (currentTail != head.load(std::memory_order_acquire)) {
+    const RawFrame& slot = queue[currentTail];
+    SampleFrame frame;
+    if (decodeSampleFrame(slot.data, slot.length, &frame)) {
+      if (leafAggregator.accept(slot.mac, frame, millis()) >= 0) {
+        newSamples++;
+      }
+    } else {
+      malformed.fetch_add(1, std::memory_order_relaxed);
+    }
+    currentTail = (currentTail + 1) % QUEUE_SIZE;
+    tail.store(currentTail, std::memory_order_release);
+  }
+  return newSamples;
+}
+
+void GatewayNode::printStats() {
+  Serial.println("=== Leaf Nodes ===");
+  for (uint8_t i = 0; i < leafAggregator.leafCount(); i++) {
+    const LeafRecord& leaf = leafAggregator.leaf(i);
+    Serial.print("Leaf ");
+    Serial.print(i + 1);
+    Serial.print(": seq ");
+    Serial.print(leaf.lastSequence);
+    Serial.print(", frames ");
+    Serial.print(leaf.frames);
+    Serial.print(", duplicates ");
+    Serial.print(leaf.duplicates);
+    Serial.print(", missed ");
+    Serial.print(leaf.missed);
+    Serial.print(", last seen ");
+    Serial.print((millis() - leaf.lastSeenMs) / 1000);
+    Serial.println(" s ago");
+  }
+  Serial.print("Rejected (table full): ");
+  Serial.print(leafAggregator.rejectedCount());
+  Serial.print(", malformed: ");
+  Serial.print(malformed.load(std::memory_order_relaxed));
+  Serial.print(", queue overflows: ");
+  Serial.println(overflows);
+}
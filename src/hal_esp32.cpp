@@ -0,0 +1,379 @@
+#ifdef ARDUINO
+
+#include "hal.h"
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <Wire.h>
+#include <esp_sleep.h>
+#include <esp_bt.h>
+#include <esp_pm.h>
+#include <esp_idf_version.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <esp_sntp.h>
+#include <lwip/sockets.h>
+#include <sys/time.h>
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#include <esp_private/esp_clk.h>
+#else
+#include <esp32/clk.h>
+#endif
+
+class Esp32Clock : public HalClock {
+public:
+  unsigned long millis() override { return ::millis(); }
+  unsigned long micros() override { return ::micros(); }
+  void delay(unsigned long ms) override { ::delay(ms); }
+  void delayMicros(unsigned long us) override { ::delayMicroseconds(us); }
+  uint64_t rtcMicros() override { return esp_clk_rtc_time(); }
+};
+
+class Esp32Power : public HalPower {
+public:
+  WakeCause wakeCause() override {
+    switch (esp_sleep_get_wakeup_cause()) {
+      case ESP_SLEEP_WAKEUP_EXT0:
+        return WakeCause::ExternalRtcIo;
+      case ESP_SLEEP_WAKEUP_EXT1:
+        return WakeCause::ExternalRtcCntl;
+      case ESP_SLEEP_WAKEUP_TIMER:
+        return WakeCause::Timer;
+      case ESP_SLEEP_WAKEUP_TOUCHPAD:
+        return WakeCause::Touchpad;
+      case ESP_SLEEP_WAKEUP_ULP:
+        return WakeCause::Ulp;
+      default:
+        return WakeCause::PowerOn;
+    }
+  }
+
+  void enableTimerWakeup(uint64_t microseconds) override {
+    esp_sleep_enable_timer_wakeup(microseconds);
+  }
+
+  void deepSleep() override {
+    esp_bt_controller_disable();
+    esp_deep_sleep_start();
+  }
+
+  uint32_t freeHeap() override { return ESP.getFreeHeap(); }
+  uint32_t minFreeHeap() override { return ESP.getMinFreeHeap(); }
+  uint32_t cpuFrequencyMhz() override { return ESP.getCpuFreqMHz(); }
+  void setCpuFrequencyMhz(uint32_t mhz) override { ::setCpuFrequencyMhz(mhz); }
+
+  bool configurePowerManagement(uint32_t maxMhz, uint32_t minMhz, bool lightSleep) override {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_pm_config_t config = {};
+#else
+    esp_pm_config_esp32_t config = {};
+#endif
+    config.max_freq_mhz = maxMhz;
+    config.min_freq_mhz = minMhz;
+    config.light_sleep_enable = lightSleep;
+    // Fails with ESP_ERR_NOT_SUPPORTED unless the SDK was built with
+    // CONFIG_PM_ENABLE (and CONFIG_FREERTOS_USE_TICKLESS_IDLE for light sleep)
+    return esp_pm_configure(&config) == ESP_OK;
+  }
+
+  void holdCpuFrequency(bool hold) override {
+    if (!cpuLock && esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "phase", &cpuLock) != ESP_OK) {
+      return;
+    }
+    if (hold == cpuLockHeld) {
+      return;
+    }
+    if (hold) {
+      esp_pm_lock_acquire(cpuLock);
+    } else {
+      esp_pm_lock_release(cpuLock);
+    }
+    cpuLockHeld = hold;
+  }
+
+private:
+  esp_pm_lock_handle_t cpuLock = nullptr;
+  bool cpuLockHeld = false;
+};
+
+#ifndef QEMU_BUILD
+// The emulator has no radio: hal_qemu.cpp provides the network-facing pieces
+
+class Esp32Network : public HalNetwork {
+public:
+  void begin(const char* ssid, const char* password) override { WiFi.begin(ssid, password); }
+  void reconnect() override { WiFi.begin(); }
+  bool isConnected() override { return WiFi.status() == WL_CONNECTED; }
+
+  void shutdown() override {
+    WiFi.disconnect();
+    WiFi.mode(WIFI_OFF);
+  }
+
+  void setModemSleep(bool enabled) override { WiFi.setSleep(enabled ? WIFI_PS_MIN_MODEM : WIFI_PS_NONE); }
+
+  long rssi() override { return WiFi.RSSI(); }
+  String localIP() override { return WiFi.localIP().toString(); }
+  String macAddress() override { return WiFi.macAddress(); }
+};
+
+#endif // QEMU_BUILD
+
+class Esp32Bus : public HalBus {
+public:
+  void pinMode(uint8_t pin, HalPinMode mode) override {
+    switch (mode) {
+      case HalPinMode::Input:           ::pinMode(pin, INPUT); break;
+      case HalPinMode::InputPullup:     ::pinMode(pin, INPUT_PULLUP); break;
+      case HalPinMode::Output:          ::pinMode(pin, OUTPUT); break;
+      case HalPinMode::OutputOpenDrain: ::pinMode(pin, OUTPUT_OPEN_DRAIN); break;
+    }
+  }
+
+  void digitalWrite(uint8_t pin, bool high) override { ::digitalWrite(pin, high ? HIGH : LOW); }
+  bool digitalRead(uint8_t pin) override { return ::digitalRead(pin) == HIGH; }
+  void i2cBegin(int sda, int scl) override { Wire.begin(sda, scl); }
+  void i2cEnd() override { Wire.end(); }
+  uint32_t analogReadMillivolts(uint8_t pin) override { return ::analogReadMilliVolts(pin); }
+};
+
+#ifndef QEMU_BUILD
+
+static HalPeerLink::ReceiveCallback peerReceiveCallback = nullptr;
+static volatile int peerSendStatus = -1;
+
+static void onPeerSent(const uint8_t* mac, esp_now_send_status_t status) {
+  (void)mac;
+  peerSendStatus = status;
+}
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+static void onPeerReceived(const esp_now_recv_info_t* info, const uint8_t* data, int length) {
+  if (peerReceiveCallback && length > 0) {
+    peerReceiveCallback(info->src_addr, data, length);
+  }
+}
+#else
+static void onPeerReceived(const uint8_t* mac, const uint8_t* data, int length) {
+  if (peerReceiveCallback && length > 0) {
+    peerReceiveCallback(mac, data, length);
+  }
+}
+#endif
+
+class Esp32PeerLink : public HalPeerLink {
+private:
+  static const unsigned long SEND_TIMEOUT_MS = 50; // MAC-level ACK normally arrives within 1-2 ms
+  bool started = false;
+
+public:
+  bool begin(uint8_t channel) override {
+    if (started) {
+      return true;
+    }
+    if (WiFi.getMode() == WIFI_OFF) {
+      WiFi.mode(WIFI_STA);
+    }
+    if (WiFi.status() != WL_CONNECTED) {
+      // Not associated: tune to the gateway's channel ourselves
+      esp_wifi_set_promiscuous(true);
+      esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
+      esp_wifi_set_promiscuous(false);
+    }
+    if (esp_now_init() != ESP_OK) {
+      return false;
+    }
+    esp_now_register_send_cb(onPeerSent);
+    esp_now_register_recv_cb(onPeerReceived);
+    started = true;
+    return true;
+  }
+
+  bool send(const uint8_t* peerMac, const uint8_t* data, size_t length) override {
+    if (!started) {
+      return false;
+    }
+    if (!esp_now_is_peer_exist(peerMac)) {
+      esp_now_peer_info_t peer = {};
+      memcpy(peer.peer_addr, peerMac, ESP_NOW_ETH_ALEN);
+      peer.channel = 0; // Current channel
+      peer.encrypt = false;
+      if (esp_now_add_peer(&peer) != ESP_OK) {
+        return false;
+      }
+    }
+
+    peerSendStatus = -1;
+    if (esp_now_send(peerMac, data, length) != ESP_OK) {
+      return false;
+    }
+    unsigned long start = ::millis();
+    while (peerSendStatus < 0 && ::millis() - start < SEND_TIMEOUT_MS) {
+      ::delay(1);
+    }
+    return peerSendStatus == ESP_NOW_SEND_SUCCESS;
+  }
+
+  void setReceiveCallback(ReceiveCallback onReceive) override { peerReceiveCallback = onReceive; }
+
+  void end() override {
+    if (started) {
+      esp_now_deinit();
+      started = false;
+    }
+  }
+};
+
+class Esp32HttpLink : public HalHttpLink {
+private:
+  WiFiServer server;
+  WiFiClient client;
+  bool listening = false;
+
+public:
+  bool begin(uint16_t port) override {
+    if (!listening) {
+      server.begin(port);
+      server.setNoDelay(true);
+      listening = true;
+    }
+    return listening;
+  }
+
+  bool accept() override {
+    if (!listening) {
+      return false;
+    }
+    if (!client.connected()) {
+      client = server.available(); // Non-blocking accept
+    }
+    return client.connected();
+  }
+
+  size_t read(uint8_t* buffer, size_t capacity) override {
+    int waiting = client.available();
+    if (waiting <= 0) {
+      return 0;
+    }
+    int count = client.read(buffer, (size_t)waiting < capacity ? waiting : capacity);
+    return count > 0 ? count : 0;
+  }
+
+  size_t write(const uint8_t* data, size_t length) override {
+    // WiFiClient::write() retries until the client has acknowledged enough to
+    // take everything; the socket call only queues what fits
+    if (!client.connected()) {
+      return 0;
+    }
+    int sent = ::send(client.fd(), data, length, MSG_DONTWAIT);
+    return sent > 0 ? (size_t)sent : 0;
+  }
+
+  void closeClient() override { client.stop(); }
+
+  void end() override {
+    client.stop();
+    server.end();
+    listening = false;
+  }
+};
+
+class Esp32DatagramLink : public HalDatagramLink {
+private:
+  WiFiUDP udp;
+  bool bound = false;
+
+public:
+  bool begin(uint16_t localPort) override {
+    if (!bound) {
+      bound = udp.begin(localPort) == 1;
+    }
+    return bound;
+  }
+
+  bool sendTo(const char* host, uint16_t port, const uint8_t* data, size_t length) override {
+    if (!bound || !udp.beginPacket(host, port)) {
+      return false;
+    }
+    udp.write(data, length);
+    return udp.endPacket() == 1;
+  }
+
+  size_t receive(uint8_t* buffer, size_t capacity) override {
+    if (!bound || udp.parsePacket() <= 0) {
+      return 0;
+    }
+    int count = udp.read(buffer, capacity);
+    udp.flush(); // Drop whatever did not fit
+    return count > 0 ? count : 0;
+  }
+
+  void end() override {
+    udp.stop();
+    bound = false;
+  }
+};
+
+// Set from the lwIP task once SNTP has stepped the system clock
+static volatile bool sntpSynced = false;
+
+static void onSntpSync(struct timeval* tv) {
+  (void)tv;
+  sntpSynced = true;
+}
+
+class Esp32TimeSync : public HalTimeSync {
+private:
+  bool active = false;
+
+public:
+  bool request(const char* server) override {
+    end();
+    sntpSynced = false;
+    sntp_set_time_sync_notification_cb(onSntpSync);
+    configTime(0, 0, server); // UTC; (re)starts the SNTP client
+    active = true;
+    return true;
+  }
+
+  bool poll(uint64_t& unixMicros) override {
+    if (!active || !sntpSynced) {
+      return false;
+    }
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    unixMicros = (uint64_t)now.tv_sec * 1000000ULL + now.tv_usec;
+    end(); // One exchange per request: no background polling while asleep
+    return true;
+  }
+
+  void end() override {
+    if (active) {
+      sntp_stop();
+      active = false;
+    }
+  }
+};
+
+static Esp32Network esp32Network;
+static Esp32PeerLink esp32PeerLink;
+static Esp32HttpLink esp32HttpLink;
+static Esp32DatagramLink esp32DatagramLink;
+static Esp32TimeSync esp32TimeSync;
+
+HalNetwork& Hal::network() { return esp32Network; }
+HalPeerLink& Hal::peers() { return esp32PeerLink; }
+HalHttpLink& Hal::http() { return esp32HttpLink; }
+HalDatagramLink& Hal::datagram() { return esp32DatagramLink; }
+HalTimeSync& Hal::timeSync() { return esp32TimeSync; }
+
+#endif // QEMU_BUILD
+
+static Esp32Clock esp32Clock;
+static Esp32Power esp32Power;
+static Esp32Bus esp32Bus;
+
+HalClock& Hal::clock() { return esp32Clock; }
+HalPower& Hal::power() { return esp32Power; }
+HalBus& Hal::bus() { return esp32Bus; }
+
+#endif // ARDUINO
@@ -0,0 +1,272 @@
+// Emulator builds link the stand-ins in hal_qemu.cpp instead
+#if defined(ARDUINO) && !defined(QEMU_BUILD)
+
+#include "hal.h"
+#include "config.h"
+
+#if BLYNK_ENABLED
+
+// Comment this out to disable prints and save space
+#define BLYNK_PRINT Serial
+
+#include <BlynkSimpleEsp32.h>
+
+static void (*blynkConnectedCallback)() = nullptr;
+static void (*blynkDisconnectedCallback)() = nullptr;
+
+// Blynk callbacks
+BLYNK_CONNECTED() {
+  if (blynkConnectedCallback) {
+    blynkConnectedCallback();
+  }
+}
+
+BLYNK_DISCONNECTED() {
+  if (blynkDisconnectedCallback) {
+    blynkDisconnectedCallback();
+  }
+}
+
+// Blynk App requests for current values
+BLYNK_READ(BLYNK_VIRTUAL_PIN_TEMP) {
+  // This will be called when Blynk app requests temperature value
+  // The actual value will be sent via sendSensorData()
+}
+
+BLYNK_READ(BLYNK_VIRTUAL_PIN_HUMIDITY) {
+  // This will be called when Blynk app requests humidity value
+  // The actual value will be sent via sendSensorData()
+}
+
+BLYNK_READ(BLYNK_VIRTUAL_PIN_HEAT_INDEX) {
+  // This will be called when Blynk app requests heat index value
+  // The actual value will be sent via sendSensorData()
+}
+
+BLYNK_READ(BLYNK_VIRTUAL_PIN_STATUS) {
+  // This will be called when Blynk app requests status
+  // The actual status will be sent via sendStatus()
+}
+
+class Esp32BlynkLink : public HalBlynkLink {
+public:
+  void begin(const char* authToken, const char* ssid, const char* password) override {
+    if (WiFi.status() == WL_CONNECTED) {
+      // Already associated: skip Blynk.begin()'s own WiFi.begin() round trip
+      Blynk.config(authToken);
+      Blynk.connect();
+    } else {
+      Blynk.begin(authToken, ssid, password);
+    }
+  }
+
+  bool connected() override { return Blynk.connected(); }
+  void run() override { Blynk.run(); }
+  void virtualWrite(int pin, float value) override { Blynk.virtualWrite(pin, value); }
+  void virtualWrite(int pin, const char* value) override { Blynk.virtualWrite(pin, value); }
+  void logEvent(const char* eventCode, const char* description) override {
+    Blynk.logEvent(eventCode, description);
+  }
+
+  void setConnectionCallbacks(void (*onConnected)(), void (*onDisconnected)()) override {
+    blynkConnectedCallback = onConnected;
+    blynkDisconnectedCallback = onDisconnected;
+  }
+};
+
+static Esp32BlynkLink esp32BlynkLink;
+
+HalBlynkLink& Hal::blynk() { return esp32BlynkLink; }
+
+#endif // BLYNK_ENABLED
+
+#if MQTT_ENABLED
+
+#include <WiFi.h>
+#include <PubSubClient.h>
+
+class Esp32MqttLink : public HalMqttLink {
+private:
+  WiFiClient socket;
+  PubSubClient client;
+
+public:
+  Esp32MqttLink() : client(socket) {}
+
+  bool connect(const char* host, uint16_t port, const char* clientId, const char* username,
+               const char* password, uint16_t keepAliveSeconds) override {
+    client.setServer(host, port);
+    client.setKeepAlive(keepAliveSeconds);
+    client.setBufferSize(MQTT_PAYLOAD_SIZE + 64); // Room for the fixed header and topic
+    bool anonymous = username == nullptr || username[0] == '\0';
+    return client.connect(clientId, anonymous ? nullptr : username, anonymous ? nullptr : password,
+                          nullptr, 0, false, nullptr, true); // No will, clean session
+  }
+
+  bool connected() override { return client.connected(); }
+
+  bool publish(const char* topic, const uint8_t* payload, size_t length) override {
+    return client.publish(topic, payload, length, false); // PubSubClient publishes at QoS 0
+  }
+
+  void disconnect() override {
+    client.disconnect();
+    socket.stop();
+  }
+};
+
+static Esp32MqttLink esp32MqttLink;
+
+HalMqttLink& Hal::mqtt() { return esp32MqttLink; }
+
+#endif // MQTT_ENABLED
+
+#if HOMEKIT_ENABLED
+
+#include "HomeSpan.h"
+
+// HomeSpan Temperature Sensor Service
+struct TemperatureSensor : Service::TemperatureSensor {
+  SpanCharacteristic *temp;
+
+  TemperatureSensor() : Service::TemperatureSensor() {
+    temp = new Characteristic::CurrentTemperature(20.0);
+    temp->setRange(-40, 100);
+  }
+
+  void updateTemperature(float newTemp) { temp->setVal(newTemp); }
+};
+
+// HomeSpan Humidity Sensor Service
+struct HumiditySensor : Service::HumiditySensor {
+  SpanCharacteristic *humidity;
+
+  HumiditySensor() : Service::HumiditySensor() {
+    humidity = new Characteristic::CurrentRelativeHumidity(50.0);
+    humidity->setRange(0, 100);
+  }
+
+  void updateHumidity(float newHumidity) { humidity->setVal(newHumidity); }
+};
+
+// HomeSpan Battery Service (cell level and low-battery flag)
+struct BatteryService : Service::BatteryService {
+  SpanCharacteristic *level;
+  SpanCharacteristic *lowBattery;
+
+  BatteryService() : Service::BatteryService() {
+    level = new Characteristic::BatteryLevel(100);
+    new Characteristic::ChargingState(0); // Not charging
+    lowBattery = new Characteristic::StatusLowBattery(0);
+  }
+
+  void updateLevel(uint8_t percent, bool low) {
+    level->setVal(percent);
+    lowBattery->setVal(low ? 1 : 0);
+  }
+};
+
+class Esp32HomeKitLink : public HalHomeKitLink {
+private:
+  static const uint8_t MAX_LEAVES = GATEWAY_MAX_LEAVES;
+
+  TemperatureSensor *tempSensor = nullptr;
+  HumiditySensor *humSensor = nullptr;
+  BatteryService *battery = nullptr;
+  TemperatureSensor *leafTempSensors[MAX_LEAVES] = {};
+  HumiditySensor *leafHumSensors[MAX_LEAVES] = {};
+
+  static void addAccessoryInformation(const char* name) {
+    new Service::AccessoryInformation();
+    new Characteristic::Name(name);
+    new Characteristic::Manufacturer(HOMEKIT_DEVICE_MANUFACTURER);
+    new Characteristic::SerialNumber(HOMEKIT_DEVICE_SERIAL);
+    new Characteristic::Model(HOMEKIT_DEVICE_MODEL);
+    new Characteristic::FirmwareRevision("1.0.0");
+    new Characteristic::Identify();
+  }
+
+  void start(const char* deviceName, uint8_t leafCount) {
+    homeSpan.begin(leafCount > 0 ? Category::Bridges : Category::Sensors, deviceName);
+
+    // Set WiFi credentials for HomeSpan
+    homeSpan.setWifiCredentials(WIFI_SSID, WIFI_PASSWORD);
+
+    // Enable factory reset - hold down boot button (GPIO0) for 10+ seconds
+    homeSpan.setControlPin(0); // Use GPIO0 (boot button) for factory reset
+
+#if SERIAL_DEBUG_VERBOSE
+    // Optional: Set custom network settings for setup mode
+    homeSpan.setHostNameSuffix("-Climate");
+    homeSpan.setApSSID("ESP32-Climate-Setup");
+    homeSpan.setPairingCode(HOMEKIT_SETUP_CODE);
+    homeSpan.setApPassword(HOMEKIT_PASSWORD);
+    homeSpan.setApTimeout(300); // 5 minutes timeout for setup mode
+#endif
+
+    // Enable Over-The-Air updates
+    homeSpan.enableOTA();
+
+    if (leafCount > 0) {
+      // A bridge's first accessory describes the bridge itself
+      new SpanAccessory();
+      addAccessoryInformation(HOMEKIT_DEVICE_NAME " Gateway");
+    }
+
+    new SpanAccessory();
+    addAccessoryInformation(HOMEKIT_DEVICE_NAME);
+    tempSensor = new TemperatureSensor();
+    humSensor = new HumiditySensor();
+#if BATTERY_MONITOR_ENABLED
+    battery = new BatteryService();
+#endif
+
+    for (uint8_t leaf = 0; leaf < leafCount && leaf < MAX_LEAVES; leaf++) {
+      char name[16];
+      snprintf(name, sizeof(name), "Leaf %u", leaf + 1);
+      new SpanAccessory();
+      addAccessoryInformation(name);
+      leafTempSensors[leaf] = new TemperatureSensor();
+      leafHumSensors[leaf] = new HumiditySensor();
+    }
+  }
+
+public:
+  void begin(const char* deviceName) override { start(deviceName, 0); }
+  void beginBridge(const char* deviceName, uint8_t leafCount) override { start(deviceName, leafCount); }
+
+  void poll() override { homeSpan.poll(); }
+
+  void setTemperature(float temperature) override {
+    if (tempSensor) {
+      tempSensor->updateTemperature(temperature);
+    }
+  }
+
+  void setHumidity(float humidity) override {
+    if (humSensor) {
+      humSensor->updateHumidity(humidity);
+    }
+  }
+
+  void setLeafReading(uint8_t leaf, float temperature, float humidity) override {
+    if (leaf < MAX_LEAVES && leafTempSensors[leaf] && leafHumSensors[leaf]) {
+      leafTempSensors[leaf]->updateTemperature(temperature);
+      leafHumSensors[leaf]->updateHumidity(humidity);
+    }
+  }
+
+  void setBatteryLevel(uint8_t percent, bool low) override {
+    if (battery) {
+      battery->updateLevel(percent, low);
+    }
+  }
+};
+
+static Esp32HomeKitLink esp32HomeKitLink;
+
+HalHomeKitLink& Hal::homekit() { return esp32HomeKitLink; }
+
+#endif // HOMEKIT_ENABLED
+
+#endif // ARDUINO
@@ -0,0 +1,613 @@
+#ifndef ARDUINO
+
+#include "hal_fake.h"
+#include <string.h>
+
+static FakeClock fakeClock;
+static FakePower fakePower;
+static FakeNetwork fakeNetwork;
+static FakeBus fakeBus;
+static FakePeerLink fakePeerLink;
+static FakeBlynkLink fakeBlynkLink;
+static FakeMqttLink fakeMqttLink;
+static FakeHttpLink fakeHttpLink;
+static FakeDatagramLink fakeDatagramLink;
+static FakeTimeSync fakeTimeSync;
+static FakeHomeKitLink fakeHomeKitLink;
+
+HalClock& Hal::clock() { return fakeClock; }
+HalPower& Hal::power() { return fakePower; }
+HalNetwork& Hal::network() { return fakeNetwork; }
+HalBus& Hal::bus() { return fakeBus; }
+HalPeerLink& Hal::peers() { return fakePeerLink; }
+HalBlynkLink& Hal::blynk() { return fakeBlynkLink; }
+HalMqttLink& Hal::mqtt() { return fakeMqttLink; }
+HalHttpLink& Hal::http() { return fakeHttpLink; }
+HalDatagramLink& Hal::datagram() { return fakeDatagramLink; }
+HalTimeSync& Hal::timeSync() { return fakeTimeSync; }
+HalHomeKitLink& Hal::homekit() { return fakeHomeKitLink; }
+
+FakeClock& FakeHal::clock() { return fakeClock; }
+FakePower& FakeHal::power() { return fakePower; }
+FakeNetwork& FakeHal::network() { return fakeNetwork; }
+FakeBus& FakeHal::bus() { return fakeBus; }
+FakePeerLink& FakeHal::peers() { return fakePeerLink; }
+FakeBlynkLink& FakeHal::blynk() { return fakeBlynkLink; }
+FakeMqttLink& FakeHal::mqtt() { return fakeMqttLink; }
+FakeHttpLink& FakeHal::http() { return fakeHttpLink; }
+FakeDatagramLink& FakeHal::datagram() { return fakeDatagramLink; }
+FakeTimeSync& FakeHal::timeSync() { return fakeTimeSync; }
+FakeHomeKitLink& FakeHal::homekit() { return fakeHomeKitLink; }
+
+void FakeHal::reset() {
+  fakeClock.reset();
+  fakePower.reset();
+  fakeNetwork.reset();
+  fakeBus.reset();
+  fakePeerLink.reset();
+  fakeBlynkLink.reset();
+  fakeMqttLink.reset();
+  fakeHttpLink.reset();
+  fakeDatagramLink.reset();
+  fakeTimeSync.reset();
+  fakeHomeKitLink.reset();
+}
+
+// FakePower
+
+void FakePower::wakeFromDeepSleep() {
+  fakeClock.advanceMicros(timerWakeupMicros);
+  sleptMicros += timerWakeupMicros;
+  fakeClock.reboot();
+  fakeNetwork.shutdown();
+  fakePeerLink.end();
+  fakeBlynkLink.powerCycle();
+  fakeMqttLink.powerCycle();
+  fakeHttpLink.end();
+  fakeDatagramLink.end();
+  fakeTimeSync.end();
+  cause = WakeCause::Timer;
+  sleepRequested = false;
+  pmConfigured = false; // Power management configuration does not survive the reset
+  cpuHeld = false;
+  cpuMhz = 240; // Boot frequency
+  heapLowWater = heap; // The heap is fresh after the reset
+}
+
+uint32_t FakePower::cpuFrequencyMhz() {
+  if (!pmConfigured) {
+    return cpuMhz;
+  }
+  return cpuHeld ? pmMaxMhz : pmMinMhz;
+}
+
+bool FakePower::configurePowerManagement(uint32_t maxMhz, uint32_t minMhz, bool enableLightSleep) {
+  if ((enableLightSleep && !lightSleepSupported) || minMhz > maxMhz) {
+    return false;
+  }
+  pmConfigured = true;
+  pmMaxMhz = maxMhz;
+  pmMinMhz = minMhz;
+  lightSleep = enableLightSleep;
+  return true;
+}
+
+void FakePower::reset() {
+  cause = WakeCause::PowerOn;
+  timerWakeupMicros = 0;
+  sleepRequested = false;
+  sleptMicros = 0;
+  heap = 200000;
+  heapLowWater = 200000;
+  cpuMhz = 240;
+  pmConfigured = false;
+  pmMaxMhz = 240;
+  pmMinMhz = 240;
+  lightSleep = false;
+  lightSleepSupported = true;
+  cpuHeld = false;
+}
+
+// FakeNetwork
+
+void FakeNetwork::begin(const char* ssid, const char* password) {
+  (void)ssid;
+  (void)password;
+  reconnect();
+}
+
+void FakeNetwork::reconnect() {
+  if (!radioOn) {
+    radioOn = true;
+    connectStartedMicros = fakeClock.totalMicros();
+  }
+}
+
+void FakeNetwork::shutdown() {
+  if (radioOn) {
+    accumulatedRadioMicros += fakeClock.totalMicros() - connectStartedMicros;
+    radioOn = false;
+  }
+}
+
+uint64_t FakeNetwork::radioOnMicros() const {
+  uint64_t current = radioOn ? fakeClock.totalMicros() - connectStartedMicros : 0;
+  return accumulatedRadioMicros + current;
+}
+
+bool FakeNetwork::isConnected() {
+  if (!radioOn || !accessPointAvailable) {
+    return false;
+  }
+  return fakeClock.totalMicros() - connectStartedMicros >= associationDelayMs * 1000ULL;
+}
+
+void FakeNetwork::reset() {
+  accessPointAvailable = true;
+  associationDelayMs = 1500;
+  radioOn = false;
+  modemSleep = false;
+  connectStartedMicros = 0;
+  accumulatedRadioMicros = 0;
+}
+
+// FakeBus
+
+void FakeBus::pinMode(uint8_t pin, HalPinMode mode) {
+  if (pin < PIN_COUNT) {
+    modes[pin] = mode;
+    if (mode == HalPinMode::InputPullup) {
+      levels[pin] = true;
+    }
+  }
+}
+
+void FakeBus::digitalWrite(uint8_t pin, bool high) {
+  if (pin >= PIN_COUNT) {
+    return;
+  }
+  if (pin == clockPin && high && !levels[pin]) {
+    clockPulses++;
+    if (pulsesUntilRelease > 0) {
+      pulsesUntilRelease--;
+    }
+  }
+  levels[pin] = high;
+}
+
+bool FakeBus::digitalRead(uint8_t pin) {
+  if (pin == heldPin && pulsesUntilRelease != 0) {
+    return false;
+  }
+  return pin < PIN_COUNT && levels[pin];
+}
+
+void FakeBus::holdLineLow(uint8_t dataPin, uint8_t clock, int releaseAfterPulses) {
+  heldPin = dataPin;
+  clockPin = clock;
+  pulsesUntilRelease = releaseAfterPulses;
+}
+
+void FakeBus::i2cBegin(int sda, int scl) {
+  setLevel(sda, true);
+  setLevel(scl, true);
+  i2cBeginCount++;
+}
+
+void FakeBus::reset() {
+  for (uint8_t pin = 0; pin < PIN_COUNT; pin++) {
+    levels[pin] = false;
+    modes[pin] = HalPinMode::Input;
+  }
+  i2cBeginCount = 0;
+  i2cEndCount = 0;
+  heldPin = PIN_COUNT;
+  clockPin = PIN_COUNT;
+  pulsesUntilRelease = 0;
+  clockPulses = 0;
+  for (uint8_t pin = 0; pin < PIN_COUNT; pin++) {
+    analogMillivolts[pin] = 0;
+  }
+}
+
+// FakePeerLink
+
+bool FakePeerLink::begin(uint8_t channel) {
+  (void)channel;
+  if (!started) {
+    started = true;
+    startedMicros = fakeClock.totalMicros();
+  }
+  return true;
+}
+
+bool FakePeerLink::send(const uint8_t* peerMac, const uint8_t* data, size_t length) {
+  (void)peerMac;
+  if (!started) {
+    return false;
+  }
+  sent++;
+  if (!peerAvailable) {
+    return false;
+  }
+  delivered++;
+  if (receiveCallback) {
+    receiveCallback(localMac, data, length);
+  }
+  return true;
+}
+
+void FakePeerLink::end() {
+  if (started) {
+    accumulatedRadioMicros += fakeClock.totalMicros() - startedMicros;
+    started = false;
+  }
+}
+
+void FakePeerLink::setLocalMac(const uint8_t* mac) {
+  memcpy(localMac, mac, sizeof(localMac));
+}
+
+uint64_t FakePeerLink::radioOnMicros() const {
+  uint64_t current = started ? fakeClock.totalMicros() - startedMicros : 0;
+  return accumulatedRadioMicros + current;
+}
+
+void FakePeerLink::reset() {
+  started = false;
+  peerAvailable = true;
+  const uint8_t defaultMac[6] = { 0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01 };
+  setLocalMac(defaultMac);
+  receiveCallback = nullptr;
+  sent = 0;
+  delivered = 0;
+  startedMicros = 0;
+  accumulatedRadioMicros = 0;
+}
+
+// FakeBlynkLink
+
+void FakeBlynkLink::begin(const char* authToken, const char* ssid, const char* password) {
+  (void)authToken;
+  (void)ssid;
+  (void)password;
+  if (!sessionOpen && serverAvailable && fakeNetwork.isConnected()) {
+    fakeClock.advanceMicros(loginLatencyMs * 1000ULL);
+    sessionOpen = true;
+    if (connectedCallback) {
+      connectedCallback();
+    }
+  }
+}
+
+bool FakeBlynkLink::connected() {
+  if (sessionOpen && (!serverAvailable || !fakeNetwork.isConnected())) {
+    sessionOpen = false;
+    if (disconnectedCallback) {
+      disconnectedCallback();
+    }
+  }
+  return sessionOpen;
+}
+
+void FakeBlynkLink::setConnectionCallbacks(void (*onConnected)(), void (*onDisconnected)()) {
+  connectedCallback = onConnected;
+  disconnectedCallback = onDisconnected;
+}
+
+void FakeBlynkLink::record(int pin, const String& value) {
+  if (!connected()) {
+    return;
+  }
+  // 5 byte header + "vw\0" + pin + "\0" + value
+  bytes += 5 + 3 + String(pin).length() + 1 + value.length();
+  writes++;
+  pinWrites[pin]++;
+  lastValues[pin] = value;
+}
+
+void FakeBlynkLink::logEvent(const char* eventCode, const char* description) {
+  if (!connected()) {
+    return;
+  }
+  // 5 byte header + "logEvent\0" + code + "\0" + description
+  bytes += 5 + 9 + String(eventCode).length() + 1 + String(description).length();
+  events++;
+}
+
+unsigned long FakeBlynkLink::writeCount(int pin) const {
+  auto it = pinWrites.find(pin);
+  return it != pinWrites.end() ? it->second : 0;
+}
+
+String FakeBlynkLink::lastValue(int pin) const {
+  auto it = lastValues.find(pin);
+  return it != lastValues.end() ? it->second : String();
+}
+
+void FakeBlynkLink::reset() {
+  serverAvailable = true;
+  sessionOpen = false;
+  loginLatencyMs = 350;
+  writes = 0;
+  events = 0;
+  bytes = 0;
+  lastValues.clear();
+  pinWrites.clear();
+}
+
+// FakeMqttLink
+
+// Bytes needed for an MQTT "remaining length" field
+static unsigned long mqttLengthBytes(unsigned long remaining) {
+  unsigned long count = 1;
+  while (remaining >= 128) {
+    remaining /= 128;
+    count++;
+  }
+  return count;
+}
+
+bool FakeMqttLink::connect(const char* host, uint16_t port, const char* clientId, const char* username,
+                           const char* password, uint16_t keepAliveSeconds) {
+  (void)host;
+  (void)port;
+  if (!fakeNetwork.isConnected() || !brokerAvailable) {
+    return false;
+  }
+  fakeClock.advanceMicros(connectLatencyMs * 1000ULL);
+
+  // Variable header (10) + client ID + optional credentials
+  unsigned long remaining = 10 + 2 + strlen(clientId);
+  if (username && username[0]) {
+    remaining += 2 + strlen(username) + 2 + (password ? strlen(password) : 0);
+  }
+  bytes += 1 + mqttLengthBytes(remaining) + remaining;
+  keepAlive = keepAliveSeconds;
+  sessionOpen = true;
+  sessions++;
+  return true;
+}
+
+bool FakeMqttLink::connected() {
+  if (sessionOpen && (!brokerAvailable || !fakeNetwork.isConnected())) {
+    sessionOpen = false;
+  }
+  return sessionOpen;
+}
+
+bool FakeMqttLink::publish(const char* topic, const uint8_t* payload, size_t length) {
+  if (!connected()) {
+    return false;
+  }
+  // QoS 0: no packet identifier
+  unsigned long remaining = 2 + strlen(topic) + length;
+  bytes += 1 + mqttLengthBytes(remaining) + remaining;
+  publishes++;
+  lastTopicValue = topic;
+  lastPayloadValue = String(std::string((const char*)payload, length));
+  return true;
+}
+
+void FakeMqttLink::disconnect() {
+  if (sessionOpen) {
+    bytes += 2;
+    sessionOpen = false;
+  }
+}
+
+void FakeMqttLink::reset() {
+  brokerAvailable = true;
+  sessionOpen = false;
+  connectLatencyMs = 40;
+  sessions = 0;
+  publishes = 0;
+  bytes = 0;
+  keepAlive = 0;
+  lastTopicValue = String();
+  lastPayloadValue = String();
+}
+
+// FakeHttpLink
+
+bool FakeHttpLink::begin(uint16_t port) {
+  listening = true; // Bound to any address; clients arrive once associated
+  listenPort = port;
+  return true;
+}
+
+bool FakeHttpLink::accept() {
+  if (!clientOpen && listening && pendingCount > 0 && fakeNetwork.isConnected()) {
+    request = pending[0];
+    for (uint8_t i = 1; i < pendingCount; i++) {
+      pending[i - 1] = pending[i];
+    }
+    pendingCount--;
+    requestOffset = 0;
+    response = String();
+    clientOpen = true;
+  }
+  sendBufferFree = sendBufferBytes;
+  return clientOpen;
+}
+
+size_t FakeHttpLink::read(uint8_t* buffer, size_t capacity) {
+  if (!clientOpen) {
+    return 0;
+  }
+  size_t remaining = request.length() - requestOffset;
+  size_t count = remaining < chunkBytes ? remaining : chunkBytes;
+  if (count > capacity) {
+    count = capacity;
+  }
+  memcpy(buffer, request.c_str() + requestOffset, count);
+  requestOffset += count;
+  return count;
+}
+
+size_t FakeHttpLink::write(const uint8_t* data, size_t length) {
+  if (!clientOpen) {
+    return 0;
+  }
+  length = length < sendBufferFree ? length : sendBufferFree;
+  sendBufferFree -= length;
+  response += String(std::string((const char*)data, length));
+  written += length;
+  return length;
+}
+
+void FakeHttpLink::closeClient() {
+  if (clientOpen) {
+    lastResponseValue = response;
+    clientOpen = false;
+    served++;
+  }
+}
+
+void FakeHttpLink::end() {
+  closeClient();
+  listening = false;
+  pendingCount = 0;
+}
+
+bool FakeHttpLink::queueRequest(const char* raw) {
+  if (pendingCount >= MAX_PENDING) {
+    return false;
+  }
+  pending[pendingCount++] = String(raw);
+  return true;
+}
+
+void FakeHttpLink::reset() {
+  end();
+  listenPort = 0;
+  chunkBytes = 64;
+  sendBufferBytes = SIZE_MAX;
+  sendBufferFree = SIZE_MAX;
+  request = String();
+  response = String();
+  lastResponseValue = String();
+  served = 0;
+  written = 0;
+}
+
+// FakeDatagramLink
+
+bool FakeDatagramLink::begin(uint16_t localPort) {
+  (void)localPort;
+  bound = true;
+  return true;
+}
+
+void FakeDatagramLink::queueEcho(const String& payload) {
+  if (inFlightCount < MAX_IN_FLIGHT) {
+    inFlight[inFlightCount++] = { payload, fakeClock.totalMicros() + echoDelayMs * 1000ULL };
+  }
+}
+
+bool FakeDatagramLink::sendTo(const char* host, uint16_t port, const uint8_t* data, size_t length) {
+  (void)host;
+  (void)port;
+  if (!bound || !fakeNetwork.isConnected()) {
+    return false;
+  }
+  sent++;
+  if (dropEvery > 0 && sent % dropEvery == 0) {
+    return true; // Lost on the way: the sender cannot tell
+  }
+  String payload(std::string((const char*)data, length));
+  queueEcho(payload);
+  if (duplicateEvery > 0 && sent % duplicateEvery == 0) {
+    queueEcho(payload);
+  }
+  return true;
+}
+
+size_t FakeDatagramLink::receive(uint8_t* buffer, size_t capacity) {
+  if (!bound || inFlightCount == 0 || inFlight[0].dueMicros > fakeClock.totalMicros()) {
+    return 0;
+  }
+  size_t count = inFlight[0].payload.length() < capacity ? inFlight[0].payload.length() : capacity;
+  memcpy(buffer, inFlight[0].payload.c_str(), count);
+  for (uint8_t i = 1; i < inFlightCount; i++) {
+    inFlight[i - 1] = inFlight[i];
+  }
+  inFlightCount--;
+  echoed++;
+  return count;
+}
+
+void FakeDatagramLink::end() {
+  bound = false;
+  inFlightCount = 0; // Echoes still in flight are lost with the socket
+}
+
+void FakeDatagramLink::reset() {
+  end();
+  echoDelayMs = 20;
+  dropEvery = 0;
+  duplicateEvery = 0;
+  sent = 0;
+  echoed = 0;
+}
+
+// FakeTimeSync
+
+bool FakeTimeSync::request(const char* server) {
+  (void)server;
+  requests++;
+  pending = serverAvailable && fakeNetwork.isConnected();
+  answerDueMicros = fakeClock.totalMicros() + roundTripMs * 1000ULL;
+  return pending;
+}
+
+bool FakeTimeSync::poll(uint64_t& unixMicros) {
+  if (!pending || fakeClock.totalMicros() < answerDueMicros) {
+    return false;
+  }
+  pending = false;
+  answers++;
+  unixMicros = trueUnixMicros() + answerErrorMs * 1000LL;
+  return true;
+}
+
+uint64_t FakeTimeSync::trueUnixMicros() const {
+  return EPOCH_MICROS + fakeClock.totalMicros();
+}
+
+void FakeTimeSync::reset() {
+  pending = false;
+  roundTripMs = 40;
+  answerErrorMs = 0;
+  serverAvailable = true;
+  requests = 0;
+  answers = 0;
+}
+
+// FakeHomeKitLink
+
+void FakeHomeKitLink::beginBridge(const char* deviceName, uint8_t leafCount) {
+  begin(deviceName);
+  bridgedLeaves = leafCount;
+}
+
+void FakeHomeKitLink::setLeafReading(uint8_t leaf, float leafTemperature, float leafHumidity) {
+  (void)leafTemperature;
+  (void)leafHumidity;
+  if (leaf < bridgedLeaves) {
+    leafUpdates++;
+  }
+}
+
+void FakeHomeKitLink::reset() {
+  started = false;
+  bridgedLeaves = 0;
+  leafUpdates = 0;
+  temperature = 20.0f;
+  humidity = 50.0f;
+  updates = 0;
+  batteryPercent = -1;
+  batteryLow = false;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,266 @@
+#if defined(ARDUINO) && defined(QEMU_BUILD)
+
+// Network stand-ins for the ESP32 QEMU machine (env:qemu_esp32). The emulator
+// has no WiFi or Bluetooth radio, so association, the Blynk session, the MQTT
+// broker, the echo server, SNTP and HomeKit are answered locally: every cloud
+// call succeeds after a fixed delay and nothing leaves the chip. Clock, power
+// and bus stay on the real implementations in hal_esp32.cpp.
+
+#include "hal.h"
+#include "config.h"
+
+class QemuNetwork : public HalNetwork {
+private:
+  static const unsigned long ASSOCIATION_MS = 200; // Typical scan-to-IP on a known AP
+  bool radioOn = false;
+  unsigned long startedMs = 0;
+
+public:
+  void begin(const char* ssid, const char* password) override {
+    (void)ssid;
+    (void)password;
+    reconnect();
+  }
+
+  void reconnect() override {
+    radioOn = true;
+    startedMs = ::millis();
+  }
+
+  bool isConnected() override { return radioOn && ::millis() - startedMs >= ASSOCIATION_MS; }
+  void shutdown() override { radioOn = false; }
+  void setModemSleep(bool enabled) override { (void)enabled; }
+  long rssi() override { return isConnected() ? -55 : 0; }
+  String localIP() override { return isConnected() ? "10.0.2.15" : "0.0.0.0"; }
+
+  String macAddress() override {
+    uint64_t mac = ESP.getEfuseMac();
+    char text[18];
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", (uint8_t)mac, (uint8_t)(mac >> 8),
+             (uint8_t)(mac >> 16), (uint8_t)(mac >> 24), (uint8_t)(mac >> 32), (uint8_t)(mac >> 40));
+    return text;
+  }
+};
+
+static QemuNetwork qemuNetwork;
+
+// No ESP-NOW without a radio
+class QemuPeerLink : public HalPeerLink {
+public:
+  bool begin(uint8_t channel) override {
+    (void)channel;
+    return false;
+  }
+  bool send(const uint8_t* peerMac, const uint8_t* data, size_t length) override {
+    (void)peerMac;
+    (void)data;
+    (void)length;
+    return false;
+  }
+  void setReceiveCallback(ReceiveCallback onReceive) override { (void)onReceive; }
+  void end() override {}
+};
+
+// Listens but never accepts: the emulated chip has no IP stack to reach
+class QemuHttpLink : public HalHttpLink {
+public:
+  bool begin(uint16_t port) override {
+    (void)port;
+    return true;
+  }
+  bool accept() override { return false; }
+  size_t read(uint8_t* buffer, size_t capacity) override {
+    (void)buffer;
+    (void)capacity;
+    return 0;
+  }
+  size_t write(const uint8_t* data, size_t length) override {
+    (void)data;
+    return length;
+  }
+  void closeClient() override {}
+  void end() override {}
+};
+
+// Echoes every datagram straight back, like a stand-in echo server on the LAN
+class QemuDatagramLink : public HalDatagramLink {
+private:
+  static const size_t MAX_DATAGRAM = 64;
+  uint8_t echo[MAX_DATAGRAM];
+  size_t echoLength = 0;
+  bool bound = false;
+
+public:
+  bool begin(uint16_t localPort) override {
+    (void)localPort;
+    bound = true;
+    return true;
+  }
+
+  bool sendTo(const char* host, uint16_t port, const uint8_t* data, size_t length) override {
+    (void)host;
+    (void)port;
+    if (!bound || !qemuNetwork.isConnected()) {
+      return false;
+    }
+    echoLength = length < MAX_DATAGRAM ? length : MAX_DATAGRAM;
+    memcpy(echo, data, echoLength);
+    return true;
+  }
+
+  size_t receive(uint8_t* buffer, size_t capacity) override {
+    size_t count = echoLength < capacity ? echoLength : capacity;
+    memcpy(buffer, echo, count);
+    echoLength = 0;
+    return count;
+  }
+
+  void end() override {
+    bound = false;
+    echoLength = 0;
+  }
+};
+
+// Answers at once with a fixed date advanced by the RTC timer
+class QemuTimeSync : public HalTimeSync {
+private:
+  static const uint64_t EPOCH_MICROS = 1767225600ULL * 1000000ULL; // 2026-01-01T00:00:00Z
+  bool pending = false;
+
+public:
+  bool request(const char* server) override {
+    (void)server;
+    pending = qemuNetwork.isConnected();
+    return pending;
+  }
+
+  bool poll(uint64_t& unixMicros) override {
+    if (!pending) {
+      return false;
+    }
+    pending = false;
+    unixMicros = EPOCH_MICROS + Hal::clock().rtcMicros();
+    return true;
+  }
+
+  void end() override { pending = false; }
+};
+
+// Session opens at once on an associated network and follows it down
+class QemuBlynkLink : public HalBlynkLink {
+private:
+  bool sessionOpen = false;
+  void (*connectedCallback)() = nullptr;
+  void (*disconnectedCallback)() = nullptr;
+
+public:
+  void begin(const char* authToken, const char* ssid, const char* password) override {
+    (void)authToken;
+    if (!qemuNetwork.isConnected()) {
+      qemuNetwork.begin(ssid, password);
+      ::delay(250);
+    }
+    sessionOpen = qemuNetwork.isConnected();
+    if (sessionOpen && connectedCallback) {
+      connectedCallback();
+    }
+  }
+
+  bool connected() override {
+    if (sessionOpen && !qemuNetwork.isConnected()) {
+      sessionOpen = false;
+      if (disconnectedCallback) {
+        disconnectedCallback();
+      }
+    }
+    return sessionOpen;
+  }
+
+  void run() override { connected(); }
+  void virtualWrite(int pin, float value) override {
+    (void)pin;
+    (void)value;
+  }
+  void virtualWrite(int pin, const char* value) override {
+    (void)pin;
+    (void)value;
+  }
+  void logEvent(const char* eventCode, const char* description) override {
+    (void)eventCode;
+    (void)description;
+  }
+
+  void setConnectionCallbacks(void (*onConnected)(), void (*onDisconnected)()) override {
+    connectedCallback = onConnected;
+    disconnectedCallback = onDisconnected;
+  }
+};
+
+class QemuMqttLink : public HalMqttLink {
+private:
+  bool sessionOpen = false;
+
+public:
+  bool connect(const char* host, uint16_t port, const char* clientId, const char* username,
+               const char* password, uint16_t keepAliveSeconds) override {
+    (void)host;
+    (void)port;
+    (void)clientId;
+    (void)username;
+    (void)password;
+    (void)keepAliveSeconds;
+    sessionOpen = qemuNetwork.isConnected();
+    return sessionOpen;
+  }
+
+  bool connected() override { return sessionOpen && qemuNetwork.isConnected(); }
+
+  bool publish(const char* topic, const uint8_t* payload, size_t length) override {
+    (void)topic;
+    (void)payload;
+    (void)length;
+    return connected();
+  }
+
+  void disconnect() override { sessionOpen = false; }
+};
+
+class QemuHomeKitLink : public HalHomeKitLink {
+public:
+  void begin(const char* deviceName) override { (void)deviceName; }
+  void beginBridge(const char* deviceName, uint8_t leafCount) override {
+    (void)deviceName;
+    (void)leafCount;
+  }
+  void poll() override {}
+  void setTemperature(float temperature) override { (void)temperature; }
+  void setHumidity(float humidity) override { (void)humidity; }
+  void setLeafReading(uint8_t leaf, float temperature, float humidity) override {
+    (void)leaf;
+    (void)temperature;
+    (void)humidity;
+  }
+  void setBatteryLevel(uint8_t percent, bool low) override {
+    (void)percent;
+    (void)low;
+  }
+};
+
+static QemuPeerLink qemuPeerLink;
+static QemuHttpLink qemuHttpLink;
+static QemuDatagramLink qemuDatagramLink;
+static QemuTimeSync qemuTimeSync;
+static QemuBlynkLink qemuBlynkLink;
+static QemuMqttLink qemuMqttLink;
+static QemuHomeKitLink qemuHomeKitLink;
+
+HalNetwork& Hal::network() { return qemuNetwork; }
+HalPeerLink& Hal::peers() { return qemuPeerLink; }
+HalHttpLink& Hal::http() { return qemuHttpLink; }
+HalDatagramLink& Hal::datagram() { return qemuDatagramLink; }
+HalTimeSync& Hal::timeSync() { return qemuTimeSync; }
+HalBlynkLink& Hal::blynk() { return qemuBlynkLink; }
+HalMqttLink& Hal::mqtt() { return qemuMqttLink; }
+HalHomeKitLink& Hal::homekit() { return qemuHomeKitLink; }
+
+#endif // ARDUINO && QEMU_BUILD
@@ -1,47 +1,58 @@
 #include "homekit_manager.h"
 
 // WiFi Manager Implementation
+unsigned long WiFiManager::reconnects = 0;
+
 void WiFiManager::connect() {
+  beginConnect();
+  waitForConnection(WIFI_CONNECT_TIMEOUT);
+}
+
+void WiFiManager::beginConnect() {
   Serial.println();
   Serial.print("Connecting to WiFi: ");
   Serial.println(WIFI_SSID);
 
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  Hal::network().begin(WIFI_SSID, WIFI_PASSWORD);
+}
 
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
+bool WiFiManager::waitForConnection(unsigned long timeoutMs) {
+  // Poll for association instead of sleeping a fixed amount
+  unsigned long start = millis();
+  while (!isConnected() && millis() - start < timeoutMs) {
+    delay(CONNECT_POLL_INTERVAL);
   }
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println();
+  if (isConnected()) {
     Serial.println("✓ WiFi connected!");
 #if SERIAL_DEBUG_VERBOSE
     Serial.print("IP address: ");
-    Serial.println(WiFi.localIP());
+    Serial.println(Hal::network().localIP());
     Serial.print("Signal strength (RSSI): ");
-    Serial.print(WiFi.RSSI());
+    Serial.print(Hal::network().rssi());
     Serial.println(" dBm");
+    Serial.print("Connect wait: ");
+    Serial.print(millis() - start);
+    Serial.println(" ms");
 #endif
   } else {
-    Serial.println();
     Serial.println("✗ WiFi connection failed!");
 #if SERIAL_DEBUG_VERBOSE
     Serial.println("Continuing without WiFi connection...");
 #endif
   }
   Serial.println();
+  return isConnected();
 }
 
 void WiFiManager::checkStatus() {
-  if (WiFi.status() != WL_CONNECTED) {
+  if (!isConnected()) {
 #if SERIAL_DEBUG_VERBOSE
     Serial.println("WiFi connection lost! Attempting to reconnect...");
 #else
     Serial.println("WiFi reconnecting...");
 #endif
+    reconnects++;
     connect();
   }
 }
@@ -49,9 +60,17 @@ void WiFiManager::checkStatus() {
 #if HOMEKIT_ENABLED
 
 // HomeKit Manager Implementation
-HomeKitManager::HomeKitManager() : tempSensor(nullptr), humSensor(nullptr), initialized(false) {}
+HomeKitManager::HomeKitManager() : initialized(false) {}
 
 bool HomeKitManager::begin(const String& deviceName) {
+  return start(deviceName, 0);
+}
+
+bool HomeKitManager::beginBridge(const String& deviceName, uint8_t leafCount) {
+  return start(deviceName, leafCount);
+}
+
+bool HomeKitManager::start(const String& deviceName, uint8_t leafCount) {
   if (!WiFiManager::isConnected()) {
     Serial.println("✗ HomeKit disabled - WiFi required");
     return false;
@@ -59,37 +78,11 @@ bool HomeKitManager::begin(const String& deviceName) {
 
   Serial.println("✓ Initializing HomeSpan...");
 
-  homeSpan.begin(Category::Sensors, deviceName.c_str());
-
-  // Set WiFi credentials for HomeSpan
-  homeSpan.setWifiCredentials(WIFI_SSID, WIFI_PASSWORD);
-
-  // Enable factory reset - hold down boot button (GPIO0) for 10+ seconds
-  homeSpan.setControlPin(0); // Use GPIO0 (boot button) for factory reset
-
-#if SERIAL_DEBUG_VERBOSE
-  // Optional: Set custom network settings for setup mode
-  homeSpan.setHostNameSuffix("-Climate");
-  homeSpan.setApSSID("ESP32-Climate-Setup");
-  homeSpan.setPairingCode(HOMEKIT_SETUP_CODE);
-  homeSpan.setApPassword(HOMEKIT_PASSWORD);
-  homeSpan.setApTimeout(300); // 5 minutes timeout for setup mode
-#endif
-
-  // Enable Over-The-Air updates
-  homeSpan.enableOTA();
-
-  new SpanAccessory();
-  new Service::AccessoryInformation();
-  new Characteristic::Name(HOMEKIT_DEVICE_NAME);
-  new Characteristic::Manufacturer(HOMEKIT_DEVICE_MANUFACTURER);
-  new Characteristic::SerialNumber(HOMEKIT_DEVICE_SERIAL);
-  new Characteristic::Model(HOMEKIT_DEVICE_MODEL);
-  new Characteristic::FirmwareRevision("1.0.0");
-  new Characteristic::Identify();
-
-  tempSensor = new TemperatureSensor();
-  humSensor = new HumiditySensor();
+  if (leafCount > 0) {
+    Hal::homekit().beginBridge(deviceName.c_str(), leafCount);
+  } else {
+    Hal::homekit().begin(deviceName.c_str());
+  }
 
   initialized = true;
 
@@ -105,14 +98,26 @@ bool HomeKitManager::begin(const String& deviceName) {
 
 void HomeKitManager::poll() {
   if (initialized) {
-    homeSpan.poll();
+    Hal::homekit().poll();
   }
 }
 
 void HomeKitManager::updateSensorData(float temperature, float humidity) {
-  if (initialized && WiFiManager::isConnected() && tempSensor && humSensor) {
-    tempSensor->updateTemperature(temperature);
-    humSensor->updateHumidity(humidity);
+  if (initialized && WiFiManager::isConnected()) {
+    Hal::homekit().setTemperature(temperature);
+    Hal::homekit().setHumidity(humidity);
+  }
+}
+
+void HomeKitManager::updateLeafData(uint8_t leaf, float temperature, float humidity) {
+  if (initialized && WiFiManager::isConnected()) {
+    Hal::homekit().setLeafReading(leaf, temperature, humidity);
+  }
+}
+
+void HomeKitManager::updateBattery(uint8_t percent, bool low) {
+  if (initialized && WiFiManager::isConnected()) {
+    Hal::homekit().setBatteryLevel(percent, low);
   }
 }
 
@@ -0,0 +1,91 @@
+#include "http_request.h"
+#include <string.h>
+
+HttpRequestParser::HttpRequestParser() {
+  reset();
+}
+
+void HttpRequestParser::reset() {
+  lineLength = 0;
+  headerBytes = 0;
+  lineDone = false;
+  atLineStart = false;
+  status = HttpParseStatus::Incomplete;
+  requestMethod = HttpMethod::Other;
+  requestPath = "";
+  line[0] = '\0';
+}
+
+HttpParseStatus HttpRequestParser::feed(const uint8_t* data, size_t length) {
+  for (size_t i = 0; i < length && status == HttpParseStatus::Incomplete; i++) {
+    char c = (char)data[i];
+
+    if (!lineDone) {
+      if (c == '\r' || c == '\n') {
+        if (lineLength == 0) {
+          continue; // Tolerate blank lines ahead of the request line (RFC 9112 2.2)
+        }
+        if (c == '\n') {
+          line[lineLength] = '\0';
+          lineDone = true;
+          atLineStart = true;
+          status = parseRequestLine();
+        }
+        continue;
+      }
+      if (lineLength + 1 >= MAX_REQUEST_LINE) {
+        status = HttpParseStatus::TooLarge;
+        break;
+      }
+      line[lineLength++] = c;
+      continue;
+    }
+
+    if (++headerBytes > MAX_HEADER_BYTES) {
+      status = HttpParseStatus::TooLarge;
+      break;
+    }
+    if (c == '\n') {
+      if (atLineStart) {
+        status = HttpParseStatus::Complete; // Blank line ends the header block
+        break;
+      }
+      atLineStart = true;
+    } else if (c != '\r') {
+      atLineStart = false;
+    }
+  }
+  return status;
+}
+
+HttpParseStatus HttpRequestParser::parseRequestLine() {
+  // method SP request-target SP HTTP-version
+  char* target = strchr(line, ' ');
+  if (!target) {
+    return HttpParseStatus::Malformed;
+  }
+  *target++ = '\0';
+  char* version = strchr(target, ' ');
+  if (!version || target == version) {
+    return HttpParseStatus::Malformed;
+  }
+  *version++ = '\0';
+  if (strncmp(version, "HTTP/1.", 7) != 0 || target[0] != '/') {
+    return HttpParseStatus::Malformed;
+  }
+
+  char* query = strchr(target, '?');
+  if (query) {
+    *query = '\0';
+  }
+
+  if (strcmp(line, "GET") == 0) {
+    requestMethod = HttpMethod::Get;
+  } else if (strcmp(line, "HEAD") == 0) {
+    requestMethod = HttpMethod::Head;
+  } else {
+    requestMethod = HttpMethod::Other;
+  }
+  requestPath = target;
+  return HttpParseStatus::Incomplete; // Headers follow
+}
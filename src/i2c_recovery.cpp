@@ -0,0 +1,48 @@
+#include "i2c_recovery.h"
+#include "config.h"
+#include "hal.h"
+
+static const unsigned long HALF_PERIOD_US = 5;       // 100 kHz standard mode
+static const unsigned long CLOCK_STRETCH_LIMIT_US = 1000;
+
+static void releaseClock(uint8_t sclPin) {
+  HalBus& bus = Hal::bus();
+  bus.digitalWrite(sclPin, true);
+  // A slave may hold SCL low (clock stretching); give it a bounded wait
+  unsigned long waited = 0;
+  while (!bus.digitalRead(sclPin) && waited < CLOCK_STRETCH_LIMIT_US) {
+    Hal::clock().delayMicros(HALF_PERIOD_US);
+    waited += HALF_PERIOD_US;
+  }
+  Hal::clock().delayMicros(HALF_PERIOD_US);
+}
+
+bool recoverI2cBus(uint8_t sdaPin, uint8_t sclPin) {
+  HalBus& bus = Hal::bus();
+  bus.i2cEnd();
+
+  bus.pinMode(sdaPin, HalPinMode::InputPullup);
+  bus.digitalWrite(sclPin, true);
+  bus.pinMode(sclPin, HalPinMode::OutputOpenDrain);
+  Hal::clock().delayMicros(HALF_PERIOD_US);
+
+  for (uint8_t pulse = 0; pulse < I2C_RECOVERY_PULSES && !bus.digitalRead(sdaPin); pulse++) {
+    bus.digitalWrite(sclPin, false);
+    Hal::clock().delayMicros(HALF_PERIOD_US);
+    releaseClock(sclPin);
+  }
+
+  // STOP: SDA rises while SCL is high
+  bus.digitalWrite(sclPin, false);
+  Hal::clock().delayMicros(HALF_PERIOD_US);
+  bus.digitalWrite(sdaPin, false);
+  bus.pinMode(sdaPin, HalPinMode::OutputOpenDrain);
+  Hal::clock().delayMicros(HALF_PERIOD_US);
+  releaseClock(sclPin);
+  bus.digitalWrite(sdaPin, true);
+  Hal::clock().delayMicros(HALF_PERIOD_US);
+
+  bus.pinMode(sdaPin, HalPinMode::InputPullup);
+  bus.pinMode(sclPin, HalPinMode::InputPullup);
+  return bus.digitalRead(sdaPin);
+}
@@ -0,0 +1,80 @@
+#include "latency_trace.h"
+
+// Sub-second for live sinks up to minutes for backlogs replayed after a
+// deep sleep or an outage
+const uint32_t LatencyHistogram::BOUNDS_MS[BUCKETS] = {
+  50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000, 60000, 300000
+};
+
+void LatencyHistogram::reset() {
+  for (uint8_t i = 0; i <= BUCKETS; i++) {
+    counts[i] = 0;
+  }
+  total = 0;
+  sumMs = 0;
+  maxMs = 0;
+}
+
+void LatencyHistogram::record(uint32_t ms) {
+  uint8_t bucket = 0;
+  while (bucket < BUCKETS && ms > BOUNDS_MS[bucket]) {
+    bucket++;
+  }
+  counts[bucket]++;
+  total++;
+  sumMs += ms;
+  if (ms > maxMs) {
+    maxMs = ms;
+  }
+}
+
+uint32_t LatencyHistogram::getCumulativeCount(uint8_t bucket) const {
+  uint32_t cumulative = 0;
+  for (uint8_t i = 0; i <= bucket && i <= BUCKETS; i++) {
+    cumulative += counts[i];
+  }
+  return cumulative;
+}
+
+uint32_t LatencyHistogram::getQuantileMs(float quantile) const {
+  if (total == 0) {
+    return 0;
+  }
+  uint32_t rank = (uint32_t)(quantile * total + 0.5f);
+  if (rank < 1) {
+    rank = 1;
+  }
+
+  uint32_t cumulative = 0;
+  for (uint8_t i = 0; i < BUCKETS; i++) {
+    cumulative += counts[i];
+    if (cumulative >= rank) {
+      return BOUNDS_MS[i] < maxMs ? BOUNDS_MS[i] : maxMs;
+    }
+  }
+  return maxMs;
+}
+
+void SequenceTracker::reset() {
+  last = 0;
+  primed = false;
+  gaps = 0;
+  duplicates = 0;
+}
+
+bool SequenceTracker::observe(uint32_t sequence) {
+  if (primed) {
+    int32_t delta = (int32_t)(sequence - last);
+    bool restarted = delta <= -RESTART_WINDOW;
+    if (delta <= 0 && !restarted) {
+      duplicates++;
+      return false;
+    }
+    if (delta > 1) {
+      gaps += delta - 1;
+    }
+  }
+  last = sequence;
+  primed = true;
+  return true;
+}
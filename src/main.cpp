@@ -1,13 +1,34 @@
 #include <Arduino.h>
 #include <Adafruit_Sensor.h>
 #include "config.h"
+#include "feature_settings.h"
+#include "hal.h"
 #include "climate_manager.h"
 #include "homekit_manager.h"
 #include "blynk_manager.h"
+#include "mqtt_manager.h"
+#include "publish_dispatcher.h"
 #include "power_manager.h"
+#include "trace.h"
+#include "boot_metrics.h"
+#include "runtime_metrics.h"
+#include "adaptive_sampler.h"
+#include "alert_monitor.h"
+#include "sample_frame.h"
+#include "gateway_node.h"
+#include "metrics_server.h"
+#include "rolling_stats.h"
+#include "sensor_supervisor.h"
+#include "battery_monitor.h"
+#include "battery_policy.h"
+#include "time_service.h"
 
 // Climate sensor instance using Unified Sensor interface
 ClimateManager* climateSensor = nullptr;
+// Every read goes through the supervisor, which restarts a stuck sensor
+SensorSupervisor sensorSupervisor;
+// Precision per reading and heater schedule; conversion statistics survive deep sleep in RTC memory
+RTC_DATA_ATTR MeasurementPolicy measurementPolicy;
 
 #if HOMEKIT_ENABLED
 HomeKitManager homekit;
@@ -17,23 +38,162 @@ HomeKitManager homekit;
 BlynkManager blynkManager;
 #endif
 
+#if MQTT_ENABLED
+MqttManager mqttManager;
+#endif
+
+// Every regular reading fans out to these sinks through per-sink queues
+PublishDispatcher publishers;
+#if HOMEKIT_ENABLED
+HomeKitPublisher homekitPublisher(homekit);
+#endif
+#if BLYNK_ENABLED
+BlynkPublisher blynkPublisher(blynkManager);
+#endif
+#if MQTT_ENABLED
+MqttPublisher mqttPublisher(mqttManager);
+#endif
+#if SERIAL_CSV_ENABLED
+SerialCsvPublisher csvPublisher;
+#endif
+#if ECHO_SINK_ENABLED
+EchoPublisher echoPublisher;
+#endif
+
 // Timing variables
 unsigned long previousMillis = 0;
-const long interval = SENSOR_READ_INTERVAL;
+unsigned long interval = SENSOR_READ_INTERVAL;
+
+#if ADAPTIVE_SAMPLING_ENABLED
+// Kept in RTC memory so the policy's history survives deep sleep
+RTC_DATA_ATTR AdaptiveSampler sampler;
+#endif
+
+#if ROLLING_STATS_ENABLED
+// Window history survives deep sleep in RTC memory (~2.2 KB)
+RTC_DATA_ATTR RollingStats rollingStats;
+RTC_DATA_ATTR uint64_t lastStatsPublishMs = 0;
+#endif
+
+#if ALERTS_ENABLED
+// Alarm state and last regular publish survive deep sleep in RTC memory
+RTC_DATA_ATTR AlertMonitor alerts;
+RTC_DATA_ATTR uint64_t lastRegularPublishMs = 0;
+#endif
+
+#if BATTERY_MONITOR_ENABLED
+// Smoothing and tier survive deep sleep in RTC memory
+RTC_DATA_ATTR BatteryMonitor battery;
+RTC_DATA_ATTR BatteryPolicy batteryPolicy;
+#endif
+
+// Fast boot overlaps WiFi association with sensor bring-up on quick wakes,
+// unless alert checks or the battery policy need the reading first to decide
+// whether to power the radio at all
+#define QUICK_WAKE_EARLY_WIFI (FAST_BOOT_ENABLED && !ALERTS_ENABLED && !BATTERY_MONITOR_ENABLED)
+
+#if NODE_ROLE == NODE_ROLE_LEAF
+RTC_DATA_ATTR uint16_t leafSequence = 0;
+#endif
+
+#if METRICS_SERVER_ENABLED
+// Kept current as readings happen; copied by the endpoint at scrape time
+MetricsSnapshot metrics = {};
+#endif
 
 // Function declarations
 void initializeSystem();
+void registerPublishers();
+void configureMeasurementPolicy();
+bool takeReading(MeasurementPurpose purpose, sensors_event_t* temperatureEvent, sensors_event_t* humidityEvent);
+void serviceHeater(float humidity);
 void performQuickSensorRead();
 void performSensorReading();
+void applySamplingPolicy(float temperature, float humidity, uint64_t sampledMs);
+bool isHomeKitAllowed();
+#if HOMEKIT_ENABLED
+void startHomeKit();
+#endif
+#if BATTERY_MONITOR_ENABLED
+void configureBatteryPolicy();
+bool updateBatteryPolicy();
+bool isRadioAllowed();
+bool batchReading(float temperature, float humidity, float heatIndex);
+void publishBattery();
+#endif
+#if NODE_ROLE == NODE_ROLE_LEAF
+void performLeafCycle();
+#endif
+#if NODE_ROLE == NODE_ROLE_GATEWAY
+void publishLeafUpdates();
+#endif
+#if ALERTS_ENABLED
+void performAlertCheck();
+bool publishAlert(AlertType alert, float temperature, float humidity);
+bool isRegularPublishDue();
+MeasurementPurpose checkPurpose();
+#endif
+#if METRICS_SERVER_ENABLED
+void collectMetrics(MetricsSnapshot& snapshot);
+#endif
+#if ROLLING_STATS_ENABLED
+void publishRollingStats();
+#endif
 
 void setup() {
   // Initialize serial communication
   Serial.begin(SERIAL_BAUD_RATE);
+#if !FAST_BOOT_ENABLED
   delay(1000);    // Give serial time to stabilize
+#endif
   Serial.flush(); // Clear any garbage in buffer
+  BootMetrics::reset();
+  RuntimeMetrics::reset();
+#if SERIAL_DEBUG_VERBOSE
+  Serial.print("Firmware variant: ");
+  Serial.println(Features::VARIANT);
+#endif
+
+#if ADAPTIVE_SAMPLING_ENABLED
+  sampler.configure(ADAPTIVE_MIN_INTERVAL, ADAPTIVE_MAX_INTERVAL, ADAPTIVE_TEMP_BAND,
+                    ADAPTIVE_HUMIDITY_BAND, ADAPTIVE_RATE_LIMIT);
+  interval = sampler.getIntervalMs();
+  PowerManager::setSleepDuration(interval / 1000);
+#endif
+
+#if ALERTS_ENABLED
+  AlertThresholds thresholds = { ALERT_TEMP_HIGH, ALERT_TEMP_LOW, ALERT_HUMIDITY_HIGH,
+                                 ALERT_HUMIDITY_LOW, ALERT_RATE_LIMIT, ALERT_HYSTERESIS,
+                                 ALERT_RATE_WINDOW };
+  alerts.configure(thresholds);
+  PowerManager::setCheckInterval(ALERT_SLEEP_CHECK_INTERVAL);
+#endif
+
+#if ROLLING_STATS_ENABLED
+  rollingStats.configure();
+#endif
+
+  configureMeasurementPolicy();
 
   // Initialize power management system
   PowerManager::begin();
+#if TIME_SYNC_ENABLED
+  TimeService::begin();
+#endif
+
+#if BATTERY_MONITOR_ENABLED
+  // Measured before any radio is on: the charge estimate needs a resting cell
+  configureBatteryPolicy();
+  updateBatteryPolicy();
+#endif
+
+#if NODE_ROLE == NODE_ROLE_LEAF
+  // Leaves never associate: sample, send one frame, sleep
+  performLeafCycle();
+  return;
+#endif
+
+  registerPublishers();
 
   // Check if waking from deep sleep - if so, perform quick operations
   if (PowerManager::isWakeupFromDeepSleep()) {
@@ -44,9 +204,15 @@ void setup() {
 
   // Normal boot initialization
   initializeSystem();
+  BootMetrics::markSetupComplete();
 }
 
 void initializeSystem() {
+#if FAST_BOOT_ENABLED
+  // Start WiFi association now so it overlaps sensor bring-up
+  WiFiManager::beginConnect();
+#endif
+
   // Create and initialize climate sensor using factory pattern
   climateSensor = createClimateSensor();
   if (!climateSensor) {
@@ -58,72 +224,216 @@ void initializeSystem() {
   Serial.print(climateSensor->getSensorName());
   Serial.println(" sensor...");
   
-  if (climateSensor->begin()) {
+  if (sensorSupervisor.begin(climateSensor, PowerManager::getMonotonicMillis())) {
     Serial.println("✓ Sensor initialized successfully!");
     climateSensor->printSensorInfo();
   } else {
-    Serial.println("✗ Sensor initialization failed!");
-    return;
+    // Keep going: publishers report the outage and the supervisor retries
+    Serial.println("✗ Sensor initialization failed! Retrying in the background...");
   }
+#if BLYNK_ENABLED
+  blynkPublisher.setSensorName(climateSensor->getSensorName());
+#endif
+#if MQTT_ENABLED
+  mqttManager.setSensorName(climateSensor->getSensorName());
+#endif
 
   // Connect to WiFi
+#if FAST_BOOT_ENABLED
+  WiFiManager::waitForConnection(WIFI_CONNECT_TIMEOUT);
+#else
   WiFiManager::connect();
+#endif
 
 #if HOMEKIT_ENABLED
-  if (WiFiManager::isConnected()) {
-    String deviceName = String(HOMEKIT_DEVICE_NAME) + " (" + climateSensor->getSensorName() + ")";
-    homekit.begin(deviceName);
-  }
+  startHomeKit();
 #endif
 
 #if BLYNK_ENABLED
   if (WiFiManager::isConnected()) {
     blynkManager.begin();
     // Send initial status
-    blynkManager.sendStatus(climateSensor->getSensorName(), true);
+    blynkManager.sendStatus(climateSensor->getSensorName(), sensorSupervisor.isOnline());
   }
 #endif
 
+#if NODE_ROLE == NODE_ROLE_GATEWAY
+  GatewayNode::begin();
+#endif
+
+#if METRICS_SERVER_ENABLED
+  MetricsServer::begin(collectMetrics);
+#endif
+
   Serial.println("✓ System ready! Reading sensors every 60 seconds...");
-#if SERIAL_DEBUG_VERBOSE
+#if FAST_BOOT_ENABLED
+  // Publish the first reading now instead of one interval after boot
+  previousMillis = millis();
+  performSensorReading();
+#elif SERIAL_DEBUG_VERBOSE
   delay(2000);
 #else
   delay(1000);
 #endif
 }
 
+void registerPublishers() {
+  publishers.reset(); // Sinks are registered once per boot
+
+  // HomeKit only shows the current value: keep the latest sample, no retries.
+  // HomeSpan is not started on quick wakes; battery tiers without HomeKit
+  // disable the sink, and a tier that allows it again starts HomeSpan if the
+  // boot did not and re-enables the sink.
+#if HOMEKIT_ENABLED
+  if (!PowerManager::isWakeupFromDeepSleep()) {
+    publishers.addSink(homekitPublisher, { 1, QueuePolicy::Overwrite, 0, 0 });
+    publishers.setSinkEnabled(homekitPublisher, isHomeKitAllowed());
+  }
+#endif
+  // Blynk timestamps on arrival: replay a short backlog, oldest dropped first
+#if BLYNK_ENABLED
+  publishers.addSink(blynkPublisher, { PUBLISH_QUEUE_DEPTH, QueuePolicy::Overwrite,
+                                       PUBLISH_RETRY_BUDGET, PUBLISH_RETRY_BACKOFF });
+#endif
+  // MqttManager buffers in RTC memory and retries with its next flush; keep arrival order
+#if MQTT_ENABLED
+  publishers.addSink(mqttPublisher, { PUBLISH_QUEUE_DEPTH, QueuePolicy::DropNewest, 0, 0 });
+#endif
+#if SERIAL_CSV_ENABLED
+  publishers.addSink(csvPublisher, { 1, QueuePolicy::Overwrite, 0, 0 });
+#endif
+  // Latency probe: every sample in order, no retries (a resend would look like a duplicate)
+#if ECHO_SINK_ENABLED
+  publishers.addSink(echoPublisher, { PUBLISH_QUEUE_DEPTH, QueuePolicy::DropNewest, 0, 0 });
+#endif
+}
+
 void performQuickSensorRead() {
+#if QUICK_WAKE_EARLY_WIFI
+  // Start WiFi association now so it overlaps sensor bring-up
+  Hal::network().reconnect();
+#endif
+
   // Initialize sensor for quick read
   climateSensor = createClimateSensor();
-  if (!climateSensor || !climateSensor->begin()) {
+  if (!climateSensor || !sensorSupervisor.begin(climateSensor, PowerManager::getMonotonicMillis())) {
     Serial.println("✗ Quick sensor initialization failed!");
     PowerManager::enterDeepSleep();
     return;
   }
 
-  // Allow sensor to stabilize
+#if !FAST_BOOT_ENABLED
+  // Allow sensor to stabilize (fast boot relies on begin()'s readiness check)
   delay(SENSOR_STABILIZATION_DELAY);
+#endif
+
+  if (measurementPolicy.isCoolingDown(PowerManager::getMonotonicMillis())) {
+    // The heater pulse left the die warm; a due publish is taken on the next wake
+    Serial.println("Sensor heater cooling down - skipping reading, returning to deep sleep");
+    PowerManager::enterDeepSleep();
+    return;
+  }
+
+#if ALERTS_ENABLED
+  // Check-only wakes read at the cheap precision unless an alert is close
+  MeasurementPurpose purpose = isRegularPublishDue() ? MeasurementPurpose::Publish : checkPurpose();
+#else
+  MeasurementPurpose purpose = MeasurementPurpose::Publish;
+#endif
+
+  // Read sensor data
+  sensors_event_t tempEvent, humidityEvent;
+  bool readingValid = takeReading(purpose, &tempEvent, &humidityEvent);
+  float temperature = tempEvent.temperature;
+  float humidity = humidityEvent.relative_humidity;
+
+  if (readingValid) {
+    BootMetrics::markFirstSample();
+#if TRACE_RECORD_ENABLED
+    TraceRecorder::recordSample(tempEvent, humidityEvent);
+#endif
+#if ROLLING_STATS_ENABLED
+    rollingStats.add(PowerManager::getMonotonicMillis(), temperature, humidity);
+#endif
+  }
 
+#if ALERTS_ENABLED
+  uint64_t acquiredMs = PowerManager::getMonotonicMillis();
+  AlertType alert = readingValid ? alerts.evaluate(temperature, humidity, acquiredMs) : AlertType::None;
+  if (alert == AlertType::None && !isRegularPublishDue()) {
+    // Sensor-only check: nothing to report, so never power the radio
+    Serial.println("Check-only wake - no alert, returning to deep sleep");
+    PowerManager::enterDeepSleep();
+    return;
+  }
+  lastRegularPublishMs = acquiredMs;
+#endif
+
+  // Only wakes that publish feed the sampler: check wakes would pin the sleep
+  // timer to their own cadence
+  if (readingValid) {
+    applySamplingPolicy(temperature, humidity, climateSensor->getLastStamp().acquiredMs);
+  }
+
+#if BATTERY_MONITOR_ENABLED
+  float heatIndex = ClimateManager::calculateHeatIndex(temperature, humidity);
+  if (!isRadioAllowed()) {
+    Serial.println("⚠️ Battery below radio cutoff - radio stays off");
+    if (readingValid) {
+      batchReading(temperature, humidity, heatIndex);
+    }
+    PowerManager::enterDeepSleep();
+    return;
+  }
+#if ALERTS_ENABLED
+  bool batchable = alert == AlertType::None; // Alarms always go out
+#else
+  bool batchable = true;
+#endif
+  if (readingValid && batchable && batchReading(temperature, humidity, heatIndex)) {
+    Serial.println("Reading batched for a later wake - returning to deep sleep");
+    PowerManager::enterDeepSleep();
+    return;
+  }
+#endif
+
+  if (readingValid) {
+#if BLYNK_ENABLED
+    blynkPublisher.setSensorName(climateSensor->getSensorName());
+#endif
+#if MQTT_ENABLED
+    mqttManager.setSensorName(climateSensor->getSensorName());
+#endif
+    // Queued before connecting: sinks that buffer offline (MQTT) keep it even if WiFi fails
+    const SampleStamp& stamp = climateSensor->stamp();
+    PublishSample sample = { stamp.acquiredMs, stamp.sequence, stamp.rtcUs, temperature, humidity,
+                             ClimateManager::calculateHeatIndex(temperature, humidity) };
+    publishers.submit(sample);
+  }
+
+#if !QUICK_WAKE_EARLY_WIFI
   // Connect to WiFi quickly
-  WiFi.begin();
+  Hal::network().reconnect();
+#endif
+
   unsigned long wifiStart = millis();
-  while (WiFi.status() != WL_CONNECTED && millis() - wifiStart < 10000) { // 10 second timeout
+  while (!WiFiManager::isConnected() && millis() - wifiStart < 10000) { // 10 second timeout
     delay(100);
   }
 
-  if (WiFi.status() == WL_CONNECTED) {
+  if (WiFiManager::isConnected()) {
     Serial.println("✓ WiFi connected for quick read");
+#if TRACE_RECORD_ENABLED
+    TraceRecorder::observeLink(true);
+#endif
+#if TIME_SYNC_ENABLED
+    // Most wakes skip the round trip: the RTC timer carries UTC until its error bound grows too large
+    if (TimeService::isSyncDue()) {
+      TimeService::syncNow(TIME_SYNC_TIMEOUT);
+    }
+#endif
 
-    // Read sensor data
-    sensors_event_t tempEvent, humidityEvent;
-    if (climateSensor->getTemperatureEvent(&tempEvent) && 
-        climateSensor->getHumidityEvent(&humidityEvent) &&
-        !isnan(tempEvent.temperature) && !isnan(humidityEvent.relative_humidity)) {
-      
-      float temperature = tempEvent.temperature;
-      float humidity = humidityEvent.relative_humidity;
-      float heatIndex = ClimateManager::calculateHeatIndex(temperature, humidity);
-
+    if (readingValid) {
       Serial.print("Quick read - Temp: ");
       Serial.print(temperature, 1);
       Serial.print("°C, Humidity: ");
@@ -131,13 +441,21 @@ void performQuickSensorRead() {
       Serial.println("%");
 
 #if BLYNK_ENABLED
-      // Send data to Blynk quickly
+      // Open the Blynk session for the publishers
       blynkManager.begin();
-      if (blynkManager.isConnected()) {
-        blynkManager.sendSensorData(temperature, humidity, heatIndex);
-        blynkManager.sendStatus(climateSensor->getSensorName(), true);
-        Serial.println("✓ Data sent to Blynk");
+#endif
+#if BATTERY_MONITOR_ENABLED
+      publishBattery();
+#endif
+#if BLYNK_ENABLED
+#if ALERTS_ENABLED
+      if (publishAlert(alert, temperature, humidity)) {
+        BootMetrics::markFirstPublish();
       }
+#endif
+#endif
+#if ROLLING_STATS_ENABLED
+      publishRollingStats();
 #endif
     } else {
       Serial.println("✗ Quick sensor read failed");
@@ -146,6 +464,34 @@ void performQuickSensorRead() {
     Serial.println("✗ WiFi connection failed for quick read");
   }
 
+  uint8_t delivered = publishers.drain(PUBLISH_DRAIN_TIMEOUT);
+  if (delivered > 0) {
+    BootMetrics::markFirstPublish();
+    Serial.println("✓ Data published");
+  }
+#if ALERTS_ENABLED && !BLYNK_ENABLED
+  // HomeSpan is not started on quick wakes: without Blynk the delivered
+  // reading is what carries the alarm
+  if (alert != AlertType::None && delivered > 0) {
+    alerts.acknowledge(alert, PowerManager::getMonotonicMillis());
+  }
+#endif
+
+  // Radio off before the heater pulse, so the second it takes is not spent
+  // with WiFi up as well (enterDeepSleep's shutdown is then a no-op)
+  Hal::network().shutdown();
+  if (readingValid) {
+    serviceHeater(humidity);
+  }
+
+#if SERIAL_DEBUG_VERBOSE
+  publishers.printStats();
+#if TIME_SYNC_ENABLED
+  TimeService::printStats();
+#endif
+  measurementPolicy.printStats();
+#endif
+
   // Enter deep sleep immediately after quick operations
   Serial.println("Quick operations complete - returning to deep sleep");
   PowerManager::enterDeepSleep();
@@ -160,6 +506,7 @@ void loop() {
   }
 
   unsigned long currentMillis = millis();
+  RuntimeMetrics::beginPass();
 
 #if HOMEKIT_ENABLED
   // HomeSpan must be polled regularly
@@ -171,6 +518,43 @@ void loop() {
   blynkManager.run();
 #endif
 
+  // Restart the sensor if it went offline (backs off between attempts)
+  sensorSupervisor.service(PowerManager::getMonotonicMillis());
+
+#if TIME_SYNC_ENABLED
+  // Non-blocking; asks SNTP only when the error bound has grown too large
+  TimeService::service();
+#endif
+
+#if METRICS_SERVER_ENABLED
+  // Non-blocking: answers a scrape once its request has fully arrived
+  MetricsServer::service();
+#endif
+
+#if TRACE_RECORD_ENABLED
+  TraceRecorder::observeLink(WiFiManager::isConnected());
+#endif
+
+  // Retries and sinks that were not ready at reading time
+  if (publishers.service(PowerManager::getMonotonicMillis()) > 0) {
+    BootMetrics::markFirstPublish();
+  }
+#if MQTT_ENABLED
+  // Readings the broker missed; the MQTT sink hands over and leaves retries to MqttManager
+  mqttManager.service();
+#endif
+
+#if ROLLING_STATS_ENABLED
+  publishRollingStats();
+#endif
+
+#if NODE_ROLE == NODE_ROLE_GATEWAY
+  // Relay leaf samples as soon as they arrive
+  if (GatewayNode::poll() > 0) {
+    publishLeafUpdates();
+  }
+#endif
+
   // Check WiFi status every 60 seconds
   static unsigned long lastWiFiCheck = 0;
   if (currentMillis - lastWiFiCheck >= WIFI_CHECK_INTERVAL) {
@@ -178,8 +562,20 @@ void loop() {
     lastWiFiCheck = currentMillis;
   }
 
-  // Read sensor every 60 seconds (only in normal mode, not during quick wake)
-  if (currentMillis - previousMillis >= interval) {
+#if ALERTS_ENABLED
+  // Cheap sensor-only check between regular readings
+  static unsigned long lastAlertCheck = 0;
+  if (currentMillis - lastAlertCheck >= ALERT_CHECK_INTERVAL) {
+    lastAlertCheck = currentMillis;
+    performAlertCheck();
+  }
+#endif
+
+  // Read sensor every 60 seconds (only in normal mode, not during quick wake);
+  // battery tiers stretch the interval like they stretch deep sleep. A reading
+  // that falls due while the die cools down from a heater pulse waits for it.
+  if (currentMillis - previousMillis >= interval * PowerManager::getSleepMultiplier() &&
+      !measurementPolicy.isCoolingDown(PowerManager::getMonotonicMillis())) {
     previousMillis = currentMillis;
     performSensorReading();
 
@@ -189,6 +585,8 @@ void loop() {
     }
   }
 
+  RuntimeMetrics::endPass();
+
   if (!PowerManager::isDeepSleepEnabled()) {
     delay(1000);  // 1000ms light sleep - good balance of responsiveness and power savings
   }
@@ -201,19 +599,36 @@ void performSensorReading() {
       delay(100);
     }
 
+    PowerManager::enterPhase(PowerPhase::Sample);
+
+#if BATTERY_MONITOR_ENABLED
+    if (updateBatteryPolicy()) {
+#if HOMEKIT_ENABLED
+      // Booted on a tier without HomeKit: HomeSpan was never started
+      startHomeKit();
+      // The other sinks keep their queues, counters and sequence history
+      publishers.setSinkEnabled(homekitPublisher, isHomeKitAllowed());
+#endif
+    }
+#endif
+
     // Read sensor data using Unified Sensor interface
     sensors_event_t tempEvent, humidityEvent;
-    
-    bool tempValid = climateSensor->getTemperatureEvent(&tempEvent);
-    bool humidityValid = climateSensor->getHumidityEvent(&humidityEvent);
+    bool sensorWasOnline = sensorSupervisor.isOnline();
 
     // Check if readings are valid
-    if (!tempValid || !humidityValid || isnan(tempEvent.temperature) || isnan(humidityEvent.relative_humidity)) {
+    if (!takeReading(MeasurementPurpose::Publish, &tempEvent, &humidityEvent)) {
       Serial.println();
-      Serial.print("ERROR: Failed to read from ");
-      Serial.print(climateSensor->getSensorName());
-      Serial.println(" sensor!");
-      Serial.println("Check sensor wiring and connections.");
+      if (sensorWasOnline) {
+        Serial.print("ERROR: Failed to read from ");
+        Serial.print(climateSensor->getSensorName());
+        Serial.println(" sensor!");
+        Serial.println("Check sensor wiring and connections.");
+      } else {
+        Serial.print("Sensor offline - skipping reading (");
+        Serial.print(sensorSupervisor.getReinitAttempts());
+        Serial.println(" restart attempts so far)");
+      }
       
 #if BLYNK_ENABLED
       // Send error status to Blynk
@@ -221,29 +636,64 @@ void performSensorReading() {
         blynkManager.sendStatus(climateSensor->getSensorName(), false);
       }
 #endif
+      PowerManager::enterPhase(PowerPhase::Idle);
       return;
     }
 
+    BootMetrics::markFirstSample();
+#if TRACE_RECORD_ENABLED
+    TraceRecorder::recordSample(tempEvent, humidityEvent);
+#endif
+
     // Extract values from sensor events
     float temperature = tempEvent.temperature;
     float humidity = humidityEvent.relative_humidity;
     float heatIndex = ClimateManager::calculateHeatIndex(temperature, humidity);
 
-#if HOMEKIT_ENABLED
-    // Update HomeSpan characteristics with new sensor values
-    if (WiFiManager::isConnected() && homekit.isInitialized()) {
-      homekit.updateSensorData(temperature, humidity);
-    }
+    uint64_t acquiredMs = climateSensor->getLastStamp().acquiredMs;
+    applySamplingPolicy(temperature, humidity, acquiredMs);
+#if ROLLING_STATS_ENABLED
+    rollingStats.add(acquiredMs, temperature, humidity);
 #endif
 
-#if BLYNK_ENABLED
-    // Send sensor data to Blynk
-    if (WiFiManager::isConnected() && blynkManager.isConnected()) {
-      blynkManager.sendSensorData(temperature, humidity, heatIndex);
-      blynkManager.sendStatus(climateSensor->getSensorName(), true);
-    }
+#if METRICS_SERVER_ENABLED
+    metrics.readingValid = true;
+    metrics.temperature = temperature;
+    metrics.humidity = humidity;
+    metrics.heatIndex = heatIndex;
+    metrics.readings++;
 #endif
 
+#if ALERTS_ENABLED
+    // Alarms go out first, ahead of the regular publish
+    publishAlert(alerts.evaluate(temperature, humidity, acquiredMs), temperature, humidity);
+    lastRegularPublishMs = acquiredMs;
+#endif
+
+    PowerManager::enterPhase(PowerPhase::Publish);
+
+#if BATTERY_MONITOR_ENABLED
+    bool batched = batchReading(temperature, humidity, heatIndex);
+#else
+    bool batched = false;
+#endif
+    if (!batched) {
+      // Queue for every sink and give each one attempt now; retries run from loop()
+      const SampleStamp& stamp = climateSensor->stamp();
+      PublishSample sample = { stamp.acquiredMs, stamp.sequence, stamp.rtcUs, temperature, humidity,
+                               heatIndex };
+      publishers.submit(sample);
+      // Delivery lag counts from acquisition, so the pass needs the time now (after alerts)
+      if (publishers.service(PowerManager::getMonotonicMillis()) > 0) {
+        BootMetrics::markFirstPublish();
+      }
+#if BATTERY_MONITOR_ENABLED
+      publishBattery();
+#endif
+    }
+    // After the publish, so the pulse never delays a reading going out
+    serviceHeater(humidity);
+
     // Print readings to serial monitor
 #if SERIAL_DEBUG_VERBOSE
     Serial.println();
@@ -263,6 +713,26 @@ void performSensorReading() {
     Serial.print("Timestamp: ");
     Serial.print(tempEvent.timestamp);
     Serial.println(" ms");
+    Serial.print("Sequence: ");
+    if (batched) {
+      Serial.println("- (batched)");
+    } else {
+      Serial.println(climateSensor->getLastStamp().sequence);
+    }
+#if TIME_SYNC_ENABLED
+    WallTime wall = TimeService::toWall(climateSensor->getLastStamp().rtcUs);
+    Serial.print("UTC: ");
+    if (wall.valid) {
+      char utc[32];
+      TimeService::formatUtc(wall.unixMs, utc, sizeof(utc));
+      Serial.print(utc);
+      Serial.print(" ±");
+      Serial.print(wall.errorMs);
+      Serial.println(" ms");
+    } else {
+      Serial.println("not synced yet");
+    }
+#endif
     Serial.print("WiFi Status: ");
     Serial.println(WiFiManager::isConnected() ? "Connected" : "Disconnected");
 
@@ -280,5 +750,468 @@ void performSensorReading() {
     Serial.print(millis() / 1000);
     Serial.println(" seconds");
     Serial.println("======================");
+
+    RuntimeMetrics::report();
+    sensorSupervisor.printStats();
+    measurementPolicy.printStats();
+    publishers.printStats();
+#if TIME_SYNC_ENABLED
+    TimeService::printStats();
+#endif
+#if NODE_ROLE == NODE_ROLE_GATEWAY
+    GatewayNode::printStats();
+#endif
+#if METRICS_SERVER_ENABLED
+    MetricsServer::printStats();
+#endif
+#endif
+
+#if SERIAL_DEBUG_VERBOSE && !DEEP_SLEEP_ENABLED
+    PowerManager::printPhaseStats();
+#endif
+    PowerManager::enterPhase(PowerPhase::Idle);
+}
+
+void configureMeasurementPolicy() {
+  if (!PowerManager::isWakeupFromDeepSleep()) {
+    measurementPolicy.reset();
+  }
+  measurementPolicy.configure((MeasurementPrecision)SHT41_ROUTINE_PRECISION,
+                              (MeasurementPrecision)SHT41_PUBLISH_PRECISION, SHT41_HEATER_HUMIDITY,
+                              SHT41_HEATER_HOLD, SHT41_HEATER_INTERVAL, SHT41_HEATER_COOLDOWN);
+}
+
+// Read through the supervisor at the precision the purpose calls for and
+// account the conversion time to that precision
+bool takeReading(MeasurementPurpose purpose, sensors_event_t* temperatureEvent, sensors_event_t* humidityEvent) {
+  MeasurementPrecision precision = measurementPolicy.select(purpose);
+  climateSensor->setPrecision(precision);
+  unsigned long start = micros();
+  bool valid = sensorSupervisor.read(temperatureEvent, humidityEvent, PowerManager::getMonotonicMillis());
+  if (valid) {
+    measurementPolicy.recordConversion(precision, micros() - start);
+  }
+  return valid;
+}
+
+// Pulse the sensor heater while humidity stays high (condensation)
+void serviceHeater(float humidity) {
+  uint64_t nowMs = PowerManager::getMonotonicMillis();
+  measurementPolicy.observeHumidity(humidity, nowMs);
+  if (!measurementPolicy.isHeaterDue(nowMs)) {
+    return;
+  }
+  unsigned long start = micros();
+  if (climateSensor->pulseHeater()) {
+    measurementPolicy.recordHeaterPulse(nowMs, micros() - start);
+    Serial.println("🔥 Sensor heater pulse (sustained high humidity)");
+  }
+}
+
+void applySamplingPolicy(float temperature, float humidity, uint64_t sampledMs) {
+#if ADAPTIVE_SAMPLING_ENABLED
+  // One policy drives both the loop scheduler and the deep sleep timer
+  interval = sampler.update(temperature, humidity, sampledMs);
+  PowerManager::setSleepDuration(interval / 1000);
+
+#if SERIAL_DEBUG_VERBOSE
+  Serial.print("Next sample in ");
+  Serial.print(interval / 1000);
+  Serial.print(" s (slope ");
+  Serial.print(sampler.getSlope(), 3);
+  Serial.print(" °C/min, stddev ");
+  Serial.print(sampler.getStdDev(), 3);
+  Serial.println(" °C)");
+#endif
+#else
+  (void)temperature;
+  (void)humidity;
+  (void)sampledMs;
+#endif
+}
+
+bool isHomeKitAllowed() {
+#if BATTERY_MONITOR_ENABLED
+  return batteryPolicy.getSettings().homekit;
+#else
+  return true;
+#endif
+}
+
+#if HOMEKIT_ENABLED
+// Start HomeSpan once per boot, when WiFi is up and the battery tier allows it
+void startHomeKit() {
+  if (homekit.isInitialized() || !WiFiManager::isConnected() || !isHomeKitAllowed()) {
+    return;
+  }
+  String deviceName = String(HOMEKIT_DEVICE_NAME) + " (" + climateSensor->getSensorName() + ")";
+#if NODE_ROLE == NODE_ROLE_GATEWAY
+  homekit.beginBridge(deviceName, GATEWAY_HOMEKIT_LEAVES);
+#else
+  homekit.begin(deviceName);
+#endif
+}
+#endif
+
+#if BATTERY_MONITOR_ENABLED
+void configureBatteryPolicy() {
+  static const uint8_t tierStart[BATTERY_TIER_COUNT] = { 100, BATTERY_TIER_CONSERVE, BATTERY_TIER_LOW,
+                                                         BATTERY_TIER_CRITICAL };
+  static const uint8_t sleepMultiplier[BATTERY_TIER_COUNT] = BATTERY_SLEEP_MULTIPLIER;
+  static const uint8_t publishEvery[BATTERY_TIER_COUNT] = BATTERY_PUBLISH_EVERY;
+  static const uint16_t cpuMhz[BATTERY_TIER_COUNT] = BATTERY_CPU_MHZ;
+  static const bool homekit[BATTERY_TIER_COUNT] = BATTERY_HOMEKIT;
+
+  BatteryTierSettings settings[BATTERY_TIER_COUNT];
+  for (uint8_t i = 0; i < BATTERY_TIER_COUNT; i++) {
+    settings[i] = { sleepMultiplier[i], publishEvery[i], cpuMhz[i], homekit[i] };
+  }
+  if (!PowerManager::isWakeupFromDeepSleep()) {
+    battery.reset();
+    batteryPolicy.reset();
+  }
+  batteryPolicy.configure(tierStart, BATTERY_TIER_HYSTERESIS, settings);
+}
+
+// Measure the cell and apply its tier; true when the tier changed
+bool updateBatteryPolicy() {
+  if (!battery.measure()) {
+    // No cell (USB or bench supply): keep the current tier
+    return false;
+  }
+
+  BatteryTier previous = batteryPolicy.getTier();
+  bool changed = batteryPolicy.update(battery.getStateOfCharge());
+  const BatteryTierSettings& settings = batteryPolicy.getSettings();
+  PowerManager::setSleepMultiplier(settings.sleepMultiplier);
+  PowerManager::setCpuCeiling(settings.cpuMhz);
+
+  if (changed) {
+    Serial.print("⚠️ Battery tier ");
+    Serial.print(BatteryPolicy::tierName(previous));
+    Serial.print(" -> ");
+    Serial.print(BatteryPolicy::tierName(batteryPolicy.getTier()));
+    Serial.print(" at ");
+    Serial.print(battery.getStateOfCharge());
+    Serial.println("%");
+  }
+#if SERIAL_DEBUG_VERBOSE
+  Serial.print("METRIC battery_mv=");
+  Serial.println(battery.getMillivolts());
+  Serial.print("METRIC battery_percent=");
+  Serial.println(battery.getStateOfCharge());
+  Serial.print("METRIC battery_tier=");
+  Serial.println((uint8_t)batteryPolicy.getTier());
+#endif
+  return changed;
+}
+
+bool isRadioAllowed() {
+  // Without a cell there is nothing to brown out
+  return !battery.isPresent() || battery.getMillivolts() >= BATTERY_RADIO_CUTOFF_MV;
+}
+
+// Hold back readings between the tier's publish slots; MQTT keeps them in
+// RTC memory and sends them with the next published one. True when held back.
+bool batchReading(float temperature, float humidity, float heatIndex) {
+  if (isRadioAllowed() && batteryPolicy.takePublishSlot()) {
+    return false;
+  }
+#if MQTT_ENABLED
+  const SampleStamp& stamp = climateSensor->getLastStamp();
+  mqttManager.addSample(stamp.acquiredMs, stamp.rtcUs, temperature, humidity, heatIndex);
+#else
+  (void)temperature;
+  (void)humidity;
+  (void)heatIndex;
+#endif
+  return true;
+}
+
+void publishBattery() {
+  if (!battery.isPresent()) {
+    return;
+  }
+  uint8_t percent = battery.getStateOfCharge();
+#if BLYNK_ENABLED
+  if (WiFiManager::isConnected() && blynkManager.isConnected()) {
+    blynkManager.sendBattery(percent, battery.getMillivolts() / 1000.0f);
+  }
+#endif
+#if HOMEKIT_ENABLED
+  if (isHomeKitAllowed()) {
+    homekit.updateBattery(percent, percent < BATTERY_LOW_PERCENT);
+  }
+#endif
+}
+#endif
+
+#if ALERTS_ENABLED
+void performAlertCheck() {
+  if (!climateSensor) {
+    return;
+  }
+
+  if (measurementPolicy.isCoolingDown(PowerManager::getMonotonicMillis())) {
+    return; // The heater pulse left the die warm: the reading would be off
+  }
+
+  PowerManager::enterPhase(PowerPhase::Sample);
+
+  sensors_event_t tempEvent, humidityEvent;
+  if (takeReading(checkPurpose(), &tempEvent, &humidityEvent)) {
+    uint64_t acquiredMs = PowerManager::getMonotonicMillis();
+    AlertType alert = alerts.evaluate(tempEvent.temperature, humidityEvent.relative_humidity, acquiredMs);
+    publishAlert(alert, tempEvent.temperature, humidityEvent.relative_humidity);
+  }
+
+  PowerManager::enterPhase(PowerPhase::Idle);
+}
+
+bool publishAlert(AlertType alert, float temperature, float humidity) {
+  if (alert == AlertType::None) {
+    return false;
+  }
+
+  Serial.print("🚨 ALERT: ");
+  Serial.print(AlertMonitor::describe(alert));
+  Serial.print(" - Temp: ");
+  Serial.print(temperature, 1);
+  Serial.print("°C, Humidity: ");
+  Serial.print(humidity, 1);
+  Serial.println("%");
+
+  bool published = false;
+  PowerManager::enterPhase(PowerPhase::Publish);
+
+#if HOMEKIT_ENABLED
+  if (WiFiManager::isConnected() && homekit.isInitialized()) {
+    homekit.updateSensorData(temperature, humidity);
+    homekit.poll(); // Push the change to controllers now
+    published = true;
+  }
+#endif
+
+#if BLYNK_ENABLED
+  if (WiFiManager::isConnected() && blynkManager.isConnected()) {
+    float heatIndex = ClimateManager::calculateHeatIndex(temperature, humidity);
+    blynkManager.sendAlert(AlertMonitor::describe(alert), temperature, humidity, heatIndex);
+    published = true;
+  }
+#endif
+
+#if !HOMEKIT_ENABLED && !BLYNK_ENABLED
+  published = true; // No alarm sink built in: the line above is the report
+#endif
+
+  if (published) {
+    // Measured from the sample that crossed; the crossing itself happened at
+    // most one check interval earlier
+    alerts.acknowledge(alert, PowerManager::getMonotonicMillis());
+    Serial.print("METRIC alert_latency_ms=");
+    Serial.println(alerts.getLastLatencyMs());
+    Serial.print("METRIC alert_latency_max_ms=");
+    Serial.println(alerts.getMaxLatencyMs());
+    Serial.print("METRIC alert_latency_mean_ms=");
+    Serial.println(alerts.getMeanLatencyMs());
+  } else {
+    Serial.println("✗ Alert not published - no publisher connected, retrying on the next check");
+  }
+  return published;
+}
+
+MeasurementPurpose checkPurpose() {
+  return alerts.isNearThreshold(SHT41_THRESHOLD_MARGIN) ? MeasurementPurpose::Threshold
+                                                        : MeasurementPurpose::Routine;
+}
+
+bool isRegularPublishDue() {
+  // Check wake-ups drift by the time spent awake; allow half a check interval
+  uint64_t periodMs = PowerManager::getSleepDuration() * 1000ULL;
+  uint64_t slackMs = ALERT_SLEEP_CHECK_INTERVAL * 500ULL;
+  return PowerManager::getMonotonicMillis() - lastRegularPublishMs + slackMs >= periodMs;
+}
+#endif
+
+#if NODE_ROLE == NODE_ROLE_LEAF
+void performLeafCycle() {
+  SampleFrame frame = {};
+  frame.sequence = ++leafSequence;
+  if (!PowerManager::isWakeupFromDeepSleep()) {
+    frame.flags |= SAMPLE_FLAG_COLD_BOOT;
+  }
+
+  climateSensor = createClimateSensor();
+  bool readingValid = climateSensor && sensorSupervisor.begin(climateSensor, PowerManager::getMonotonicMillis());
+#if !FAST_BOOT_ENABLED
+  if (readingValid) {
+    delay(SENSOR_STABILIZATION_DELAY);
+  }
+#endif
+
+  sensors_event_t tempEvent, humidityEvent;
+  readingValid = readingValid && takeReading(MeasurementPurpose::Publish, &tempEvent, &humidityEvent);
+
+  if (readingValid) {
+    frame.temperature = tempEvent.temperature;
+    frame.humidity = humidityEvent.relative_humidity;
+    BootMetrics::markFirstSample();
+#if TRACE_RECORD_ENABLED
+    TraceRecorder::recordSample(tempEvent, humidityEvent);
+#endif
+    applySamplingPolicy(frame.temperature, frame.humidity, climateSensor->getLastStamp().acquiredMs);
+  } else {
+    frame.flags |= SAMPLE_FLAG_SENSOR_ERROR;
+    Serial.println("✗ Leaf sensor read failed - reporting error to gateway");
+  }
+
+  uint8_t payload[SAMPLE_FRAME_SIZE];
+  size_t length = encodeSampleFrame(frame, payload, sizeof(payload));
+  static const uint8_t gatewayMac[6] = ESPNOW_GATEWAY_MAC;
+
+#if BATTERY_MONITOR_ENABLED
+  bool radioAllowed = isRadioAllowed();
+#else
+  bool radioAllowed = true;
+#endif
+
+  bool delivered = false;
+  if (!radioAllowed) {
+    Serial.println("⚠️ Battery below radio cutoff - frame not sent");
+  } else if (Hal::peers().begin(ESPNOW_CHANNEL)) {
+    for (uint8_t attempt = 0; attempt < LEAF_SEND_ATTEMPTS && !delivered; attempt++) {
+      delivered = Hal::peers().send(gatewayMac, payload, length);
+    }
+    Hal::peers().end();
+  }
+
+  if (delivered) {
+    BootMetrics::markFirstPublish();
+    Serial.print("✓ Frame ");
+    Serial.print(frame.sequence);
+    Serial.println(" delivered to gateway");
+  } else {
+    Serial.println("✗ Gateway did not acknowledge frame");
+  }
+
+  if (readingValid) {
+    serviceHeater(frame.humidity);
+  }
+  PowerManager::enterDeepSleep();
+}
+#endif
+
+#if NODE_ROLE == NODE_ROLE_GATEWAY
+void publishLeafUpdates() {
+  GatewayAggregator& aggregator = GatewayNode::aggregator();
+  PowerManager::enterPhase(PowerPhase::Publish);
+
+  for (int index = aggregator.takePending(); index >= 0; index = aggregator.takePending()) {
+    const LeafRecord& leaf = aggregator.leaf(index);
+    if (leaf.sensorError) {
+      Serial.print("✗ Leaf ");
+      Serial.print(index + 1);
+      Serial.println(" reported a sensor error");
+      continue;
+    }
+
+#if HOMEKIT_ENABLED
+    homekit.updateLeafData(index, leaf.temperature, leaf.humidity);
+#endif
+#if BLYNK_ENABLED
+    float heatIndex = ClimateManager::calculateHeatIndex(leaf.temperature, leaf.humidity);
+    blynkManager.sendLeafData(index, leaf.temperature, leaf.humidity, heatIndex);
+#endif
+
+#if SERIAL_DEBUG_VERBOSE
+    Serial.print("Leaf ");
+    Serial.print(index + 1);
+    Serial.print(" - Temp: ");
+    Serial.print(leaf.temperature, 1);
+    Serial.print("°C, Humidity: ");
+    Serial.print(leaf.humidity, 1);
+    Serial.println("%");
+#endif
+  }
+
+  PowerManager::enterPhase(PowerPhase::Idle);
+}
+#endif
+
+#if ROLLING_STATS_ENABLED
+// Window aggregates on a slower cadence than the readings themselves
+void publishRollingStats() {
+  uint64_t nowMs = PowerManager::getMonotonicMillis();
+  if (nowMs - lastStatsPublishMs < ROLLING_STATS_PUBLISH_INTERVAL) {
+    return;
+  }
+
+#if BLYNK_ENABLED
+  if (!WiFiManager::isConnected() || !blynkManager.isConnected()) {
+    return; // Retried on the next pass or wake
+  }
+#endif
+
+  for (uint8_t window = 0; window < RollingStats::WINDOW_COUNT; window++) {
+    WindowStats temperature = rollingStats.getStats(window, RollingQuantity::Temperature, nowMs);
+    WindowStats humidity = rollingStats.getStats(window, RollingQuantity::Humidity, nowMs);
+#if BLYNK_ENABLED
+    blynkManager.sendWindowStats(window, temperature, humidity);
+#endif
+
+#if SERIAL_DEBUG_VERBOSE
+    if (temperature.count > 0) {
+      Serial.print("Window ");
+      Serial.print(RollingStats::WINDOW_NAMES[window]);
+      Serial.print(" (");
+      Serial.print(temperature.count);
+      Serial.print(" samples) - Temp: ");
+      Serial.print(temperature.mean, 2);
+      Serial.print("°C [");
+      Serial.print(temperature.min, 1);
+      Serial.print(", ");
+      Serial.print(temperature.max, 1);
+      Serial.print("] sd ");
+      Serial.print(temperature.stddev, 2);
+      Serial.print(", Humidity: ");
+      Serial.print(humidity.mean, 1);
+      Serial.print("% [");
+      Serial.print(humidity.min, 1);
+      Serial.print(", ");
+      Serial.print(humidity.max, 1);
+      Serial.print("] sd ");
+      Serial.println(humidity.stddev, 2);
+    }
+#endif
+  }
+  lastStatsPublishMs = nowMs;
+}
+#endif
+
+#if METRICS_SERVER_ENABLED
+void collectMetrics(MetricsSnapshot& snapshot) {
+  snapshot = metrics;
+  snapshot.readFailures = sensorSupervisor.getFailedReads();
+  snapshot.sensorHealth = (uint8_t)sensorSupervisor.getHealth();
+  snapshot.sensorRecoveries = sensorSupervisor.getRecoveryCount();
+  snapshot.sensorRecoveryMs = sensorSupervisor.getLastRecoveryMs();
+  snapshot.wifiReconnects = WiFiManager::getReconnectCount();
+#if BLYNK_ENABLED
+  snapshot.blynkReconnects = blynkManager.getReconnectCount();
+#endif
+  snapshot.loopMicros = RuntimeMetrics::getLastMicros();
+  snapshot.loopMaxMicros = RuntimeMetrics::getMaxMicros();
+#if BATTERY_MONITOR_ENABLED
+  snapshot.batteryMillivolts = battery.getMillivolts();
+  snapshot.batteryPercent = battery.getStateOfCharge();
+  snapshot.batteryTier = (uint8_t)batteryPolicy.getTier();
+#endif
+#if TIME_SYNC_ENABLED
+  WallTime wall = TimeService::now();
+  snapshot.timeSynced = wall.valid;
+  snapshot.timeErrorMs = wall.errorMs;
+  snapshot.timeDriftPpm = TimeService::getDriftPpm();
+#endif
+  snapshot.publishers = &publishers;
+}
 #endif
-}
\ No newline at end of file
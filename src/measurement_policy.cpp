@@ -0,0 +1,124 @@
+#include "measurement_policy.h"
+#include <Arduino.h>
+
+void MeasurementPolicy::configure(MeasurementPrecision routine, MeasurementPrecision precise,
+                                  float humidityLimit, uint32_t holdMs, uint32_t intervalMs,
+                                  uint32_t heaterCooldownMs) {
+  routinePrecision = routine;
+  precisePrecision = precise;
+  heaterHumidity = humidityLimit;
+  heaterHoldMs = holdMs;
+  heaterIntervalMs = intervalMs;
+  cooldownMs = heaterCooldownMs;
+}
+
+void MeasurementPolicy::reset() {
+  humid = false;
+  humidSinceMs = 0;
+  heated = false;
+  lastPulseMs = 0;
+  for (uint8_t i = 0; i < MEASUREMENT_PRECISION_COUNT; i++) {
+    conversions[i] = 0;
+    conversionMicros[i] = 0;
+    maxConversionMicros[i] = 0;
+  }
+  heaterPulses = 0;
+  heaterMicros = 0;
+}
+
+MeasurementPrecision MeasurementPolicy::select(MeasurementPurpose purpose) const {
+  return purpose == MeasurementPurpose::Routine ? routinePrecision : precisePrecision;
+}
+
+void MeasurementPolicy::observeHumidity(float humidity, uint64_t nowMs) {
+  if (humidity < heaterHumidity) {
+    humid = false;
+  } else if (!humid) {
+    humid = true;
+    humidSinceMs = nowMs;
+  }
+}
+
+bool MeasurementPolicy::isHeaterDue(uint64_t nowMs) const {
+  if (!humid || nowMs - humidSinceMs < heaterHoldMs) {
+    return false;
+  }
+  return !heated || nowMs - lastPulseMs >= heaterIntervalMs;
+}
+
+void MeasurementPolicy::recordHeaterPulse(uint64_t nowMs, uint32_t durationMicros) {
+  heated = true;
+  lastPulseMs = nowMs;
+  heaterPulses++;
+  heaterMicros += durationMicros;
+}
+
+bool MeasurementPolicy::isCoolingDown(uint64_t nowMs) const {
+  return heated && nowMs - lastPulseMs < cooldownMs;
+}
+
+void MeasurementPolicy::recordConversion(MeasurementPrecision precision, uint32_t durationMicros) {
+  uint8_t i = (uint8_t)precision;
+  conversions[i]++;
+  conversionMicros[i] += durationMicros;
+  if (durationMicros > maxConversionMicros[i]) {
+    maxConversionMicros[i] = durationMicros;
+  }
+}
+
+uint32_t MeasurementPolicy::getConversionCount(MeasurementPrecision precision) const {
+  return conversions[(uint8_t)precision];
+}
+
+uint32_t MeasurementPolicy::getMeanConversionMicros(MeasurementPrecision precision) const {
+  uint8_t i = (uint8_t)precision;
+  return conversions[i] ? (uint32_t)(conversionMicros[i] / conversions[i]) : 0;
+}
+
+const char* MeasurementPolicy::precisionName(MeasurementPrecision precision) {
+  switch (precision) {
+    case MeasurementPrecision::Low:
+      return "low";
+    case MeasurementPrecision::Medium:
+      return "medium";
+    case MeasurementPrecision::High:
+      return "high";
+  }
+  return "unknown";
+}
+
+void MeasurementPolicy::printStats() const {
+  Serial.print("Sensor conversions:");
+  for (uint8_t i = 0; i < MEASUREMENT_PRECISION_COUNT; i++) {
+    MeasurementPrecision precision = (MeasurementPrecision)i;
+    Serial.print(" ");
+    Serial.print(precisionName(precision));
+    Serial.print(" ");
+    Serial.print(conversions[i]);
+    Serial.print(" x ");
+    Serial.print(getMeanConversionMicros(precision));
+    Serial.print(" us");
+  }
+  Serial.print(", heater ");
+  Serial.print(heaterPulses);
+  Serial.println(heaterPulses == 1 ? " pulse" : " pulses");
+
+  for (uint8_t i = 0; i < MEASUREMENT_PRECISION_COUNT; i++) {
+    if (conversions[i] == 0) {
+      continue;
+    }
+    MeasurementPrecision precision = (MeasurementPrecision)i;
+    Serial.print("METRIC sensor_read_");
+    Serial.print(precisionName(precision));
+    Serial.print("_us=");
+    Serial.println(getMeanConversionMicros(precision));
+    Serial.print("METRIC sensor_read_");
+    Serial.print(precisionName(precision));
+    Serial.print("_max_us=");
+    Serial.println(maxConversionMicros[i]);
+  }
+  Serial.print("METRIC sensor_heater_pulses=");
+  Serial.println(heaterPulses);
+  Serial.print("METRIC sensor_heater_ms=");
+  Serial.println((unsigned long)(heaterMicros / 1000));
+}
@@ -0,0 +1,284 @@
+#include "metrics_server.h"
+#include "metrics_writer.h"
+#include <stdio.h>
+#include <string.h>
+
+char MetricsServer::body[METRICS_RESPONSE_SIZE];
+char MetricsServer::header[HEADER_SIZE];
+size_t MetricsServer::headerLength = 0;
+const char* MetricsServer::responseBody = nullptr;
+size_t MetricsServer::responseBodyLength = 0;
+size_t MetricsServer::responseOffset = 0;
+bool MetricsServer::responding = false;
+HttpRequestParser MetricsServer::parser;
+MetricsCollector MetricsServer::collector = nullptr;
+bool MetricsServer::started = false;
+bool MetricsServer::clientActive = false;
+unsigned long MetricsServer::clientStartMs = 0;
+unsigned long MetricsServer::scrapes = 0;
+unsigned long MetricsServer::rejected = 0;
+unsigned long MetricsServer::timeouts = 0;
+unsigned long MetricsServer::lastResponseMicros = 0;
+unsigned long MetricsServer::maxResponseMicros = 0;
+
+bool MetricsServer::begin(MetricsCollector collect) {
+  collector = collect;
+  started = Hal::http().begin(METRICS_SERVER_PORT);
+  if (started) {
+    Serial.print("✓ Metrics endpoint: http://");
+    Serial.print(Hal::network().localIP());
+    Serial.print(":");
+    Serial.print(METRICS_SERVER_PORT);
+    Serial.println("/metrics");
+  } else {
+    Serial.println("✗ Metrics endpoint failed to start");
+  }
+  return started;
+}
+
+void MetricsServer::service() {
+  if (!started) {
+    return;
+  }
+
+  if (!Hal::http().accept()) {
+    clientActive = false;
+    return;
+  }
+  if (!clientActive) {
+    clientActive = true;
+    clientStartMs = millis();
+    parser.reset();
+    responding = false;
+  }
+
+  bool sent = false;
+  if (responding) {
+    sent = sendPending();
+  } else {
+    // Bounded work per pass: only bytes that have already arrived
+    uint8_t chunk[READ_CHUNK];
+    for (uint8_t reads = 0; reads < MAX_READS_PER_PASS && parser.getStatus() == HttpParseStatus::Incomplete; reads++) {
+      size_t count = Hal::http().read(chunk, sizeof(chunk));
+      if (count == 0) {
+        break;
+      }
+      parser.feed(chunk, count);
+    }
+
+    if (parser.getStatus() != HttpParseStatus::Incomplete) {
+      // Rendering plus the first write: the longest this endpoint holds up loop()
+      unsigned long start = micros();
+      respond();
+      sent = sendPending();
+      lastResponseMicros = micros() - start;
+      if (lastResponseMicros > maxResponseMicros) {
+        maxResponseMicros = lastResponseMicros;
+      }
+    }
+  }
+
+  if (sent) {
+    // Whole response handed to the socket
+  } else if (millis() - clientStartMs >= METRICS_CLIENT_TIMEOUT) {
+    timeouts++;
+  } else {
+    return; // Keep the client for the next pass
+  }
+
+  Hal::http().closeClient();
+  clientActive = false;
+  responding = false;
+}
+
+void MetricsServer::end() {
+  if (started) {
+    Hal::http().end();
+    started = false;
+    clientActive = false;
+    responding = false;
+  }
+}
+
+void MetricsServer::respond() {
+  static const char NOT_FOUND[] = "Not found; metrics are at /metrics\n";
+
+  switch (parser.getStatus()) {
+    case HttpParseStatus::Malformed:
+      rejected++;
+      sendResponse(400, "Bad Request", "", nullptr, 0, false);
+      return;
+    case HttpParseStatus::TooLarge:
+      rejected++;
+      sendResponse(431, "Request Header Fields Too Large", "", nullptr, 0, false);
+      return;
+    default:
+      break;
+  }
+
+  if (parser.getMethod() == HttpMethod::Other) {
+    rejected++;
+    sendResponse(405, "Method Not Allowed", "Allow: GET, HEAD\r\n", nullptr, 0, false);
+    return;
+  }
+  bool includeBody = parser.getMethod() == HttpMethod::Get;
+  if (strcmp(parser.getPath(), "/metrics") != 0) {
+    rejected++;
+    sendResponse(404, "Not Found", "", NOT_FOUND, sizeof(NOT_FOUND) - 1, includeBody);
+    return;
+  }
+
+  MetricsSnapshot snapshot = {};
+  if (collector) {
+    collector(snapshot);
+  }
+  scrapes++; // Counted before rendering so the scrape sees itself
+  size_t length = render(snapshot, body, sizeof(body));
+  if (length == 0) {
+    sendResponse(500, "Internal Server Error", "", nullptr, 0, false);
+    Serial.println("⚠️  Metrics response does not fit METRICS_RESPONSE_SIZE");
+    return;
+  }
+  sendResponse(200, "OK", "", body, length, includeBody);
+}
+
+void MetricsServer::sendResponse(int status, const char* reason, const char* extraHeaders,
+                                 const char* content, size_t length, bool includeBody) {
+  int printed = snprintf(header, sizeof(header),
+                         "HTTP/1.1 %d %s\r\n"
+                         "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                         "Content-Length: %u\r\n"
+                         "Connection: close\r\n"
+                         "%s\r\n",
+                         status, reason, (unsigned)length, extraHeaders);
+  bool fits = printed > 0 && (size_t)printed < sizeof(header);
+  headerLength = fits ? (size_t)printed : 0; // Closed without an answer otherwise
+  responseBody = fits && includeBody ? content : nullptr;
+  responseBodyLength = responseBody ? length : 0;
+  responseOffset = 0;
+  responding = true;
+}
+
+bool MetricsServer::sendPending() {
+  size_t total = headerLength + responseBodyLength;
+  while (responseOffset < total) {
+    const char* data;
+    size_t remaining;
+    if (responseOffset < headerLength) {
+      data = header + responseOffset;
+      remaining = headerLength - responseOffset;
+    } else {
+      data = responseBody + (responseOffset - headerLength);
+      remaining = total - responseOffset;
+    }
+    size_t count = Hal::http().write((const uint8_t*)data, remaining);
+    responseOffset += count;
+    if (count < remaining) {
+      return false; // Send buffer full: the rest goes out on a later pass
+    }
+  }
+  return true;
+}
+
+size_t MetricsServer::render(const MetricsSnapshot& snapshot, char* buffer, size_t capacity) {
+  MetricsWriter writer(buffer, capacity);
+
+  if (snapshot.readingValid) {
+    writer.gauge("climate_temperature_celsius", "Last temperature reading.", snapshot.temperature);
+    writer.gauge("climate_humidity_percent", "Last relative humidity reading.", snapshot.humidity);
+    writer.gauge("climate_heat_index_celsius", "Heat index of the last reading.", snapshot.heatIndex);
+  }
+  writer.counter("climate_sensor_readings_total", "Successful sensor readings.", snapshot.readings);
+  writer.counter("climate_sensor_read_failures_total", "Failed sensor readings.", snapshot.readFailures);
+  writer.gauge("climate_sensor_health", "0 healthy, 1 degraded, 2 offline, 3 recovering.",
+               snapshot.sensorHealth, 0);
+  writer.counter("climate_sensor_recoveries_total", "Sensor restarts that led to a good reading.",
+                 snapshot.sensorRecoveries);
+  writer.gauge("climate_sensor_recovery_milliseconds", "First failure to first good reading, last outage.",
+               snapshot.sensorRecoveryMs, 0);
+
+  writer.counter("climate_wifi_reconnects_total", "WiFi reconnect attempts.", snapshot.wifiReconnects);
+#if BLYNK_ENABLED
+  writer.counter("climate_blynk_reconnects_total", "Blynk reconnect attempts.", snapshot.blynkReconnects);
+#endif
+  if (Hal::network().isConnected()) {
+    writer.gauge("climate_wifi_rssi_dbm", "WiFi signal strength.", Hal::network().rssi(), 0);
+  }
+
+  writer.gauge("climate_free_heap_bytes", "Free heap.", Hal::power().freeHeap(), 0);
+  writer.gauge("climate_uptime_seconds", "Time since boot.", millis() / 1000.0, 0);
+  writer.gauge("climate_loop_latency_microseconds", "Duration of the last loop pass.",
+               snapshot.loopMicros, 0);
+  writer.gauge("climate_loop_latency_max_microseconds", "Longest loop pass since boot.",
+               snapshot.loopMaxMicros, 0);
+  if (snapshot.batteryMillivolts > 0) {
+    writer.gauge("climate_battery_volts", "Smoothed battery cell voltage.", snapshot.batteryMillivolts / 1000.0, 3);
+    writer.gauge("climate_battery_percent", "Estimated battery state of charge.", snapshot.batteryPercent, 0);
+    writer.gauge("climate_battery_tier", "0 normal, 1 conserve, 2 low, 3 critical.", snapshot.batteryTier, 0);
+  }
+  if (snapshot.timeSynced) {
+    writer.gauge("climate_time_error_milliseconds", "Error bound of the device's UTC estimate.",
+                 snapshot.timeErrorMs, 0);
+    writer.gauge("climate_time_drift_ppm", "Measured RTC timer drift (0 until measured).",
+                 snapshot.timeDriftPpm, 1);
+  }
+
+  const PublishDispatcher* publishers = snapshot.publishers;
+  if (publishers && publishers->getSinkCount() > 0) {
+    writer.family("climate_publish_delivered_total", "Samples delivered per sink.", "counter");
+    for (uint8_t i = 0; i < publishers->getSinkCount(); i++) {
+      writer.labelled("climate_publish_delivered_total", "sink", publishers->getSinkName(i),
+                      publishers->getStats(i).delivered);
+    }
+    writer.family("climate_publish_dropped_total", "Samples dropped per sink (queue full or retries exhausted).", "counter");
+    for (uint8_t i = 0; i < publishers->getSinkCount(); i++) {
+      const SinkStats& stats = publishers->getStats(i);
+      writer.labelled("climate_publish_dropped_total", "sink", publishers->getSinkName(i),
+                      stats.dropped + stats.failed);
+    }
+    writer.family("climate_publish_lag_milliseconds", "Sample to delivery time, last sample.", "gauge");
+    for (uint8_t i = 0; i < publishers->getSinkCount(); i++) {
+      writer.labelled("climate_publish_lag_milliseconds", "sink", publishers->getSinkName(i),
+                      publishers->getStats(i).lastLagMs);
+    }
+    writer.family("climate_publish_sequence_gaps_total", "Readings a sink never got (sequence gaps).", "counter");
+    for (uint8_t i = 0; i < publishers->getSinkCount(); i++) {
+      writer.labelled("climate_publish_sequence_gaps_total", "sink", publishers->getSinkName(i),
+                      publishers->getStats(i).sent.getGaps());
+    }
+    writer.family("climate_publish_latency_milliseconds", "Sample to delivery time.", "histogram");
+    for (uint8_t i = 0; i < publishers->getSinkCount(); i++) {
+      const LatencyHistogram& latency = publishers->getStats(i).publishLatency;
+      const char* sink = publishers->getSinkName(i);
+      for (uint8_t b = 0; b < LatencyHistogram::BUCKETS; b++) {
+        unsigned long bound = LatencyHistogram::BOUNDS_MS[b];
+        writer.bucket("climate_publish_latency_milliseconds_bucket", "sink", sink, &bound,
+                      latency.getCumulativeCount(b));
+      }
+      writer.bucket("climate_publish_latency_milliseconds_bucket", "sink", sink, nullptr, latency.getCount());
+      writer.labelled("climate_publish_latency_milliseconds_sum", "sink", sink, (unsigned long)latency.getSumMs());
+      writer.labelled("climate_publish_latency_milliseconds_count", "sink", sink, latency.getCount());
+    }
+  }
+
+  writer.counter("climate_metrics_scrapes_total", "Scrapes served by this endpoint.", scrapes);
+  writer.counter("climate_metrics_rejected_total", "Requests answered with an error.", rejected);
+
+  return writer.overflowed() ? 0 : writer.length();
+}
+
+void MetricsServer::printStats() {
+  Serial.print("Metrics endpoint: ");
+  Serial.print(scrapes);
+  Serial.print(" scrapes, ");
+  Serial.print(rejected);
+  Serial.print(" rejected, ");
+  Serial.print(timeouts);
+  Serial.print(" timed out, last response ");
+  Serial.print(lastResponseMicros);
+  Serial.println(" us");
+  Serial.print("METRIC metrics_response_us=");
+  Serial.println(lastResponseMicros);
+  Serial.print("METRIC metrics_response_max_us=");
+  Serial.println(maxResponseMicros);
+}
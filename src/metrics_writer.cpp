@@ -0,0 +1,59 @@
+#include "metrics_writer.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+MetricsWriter::MetricsWriter(char* buffer, size_t capacity)
+  : buffer(buffer), capacity(capacity), used(0), overflow(capacity == 0) {
+  if (capacity > 0) {
+    buffer[0] = '\0';
+  }
+}
+
+void MetricsWriter::append(const char* format, ...) {
+  if (overflow) {
+    return;
+  }
+  va_list args;
+  va_start(args, format);
+  int written = vsnprintf(buffer + used, capacity - used, format, args);
+  va_end(args);
+
+  if (written < 0 || (size_t)written >= capacity - used) {
+    overflow = true;
+    buffer[used] = '\0'; // Drop the partial line
+    return;
+  }
+  used += written;
+}
+
+void MetricsWriter::gauge(const char* name, const char* help, double value, uint8_t decimals) {
+  // Header and sample go in one append so a metric is never cut in half
+  if (isnan(value)) {
+    append("# HELP %s %s\n# TYPE %s gauge\n%s NaN\n", name, help, name, name);
+  } else {
+    append("# HELP %s %s\n# TYPE %s gauge\n%s %.*f\n", name, help, name, name, decimals, value);
+  }
+}
+
+void MetricsWriter::counter(const char* name, const char* help, unsigned long value) {
+  append("# HELP %s %s\n# TYPE %s counter\n%s %lu\n", name, help, name, name, value);
+}
+
+void MetricsWriter::family(const char* name, const char* help, const char* type) {
+  append("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+void MetricsWriter::labelled(const char* name, const char* label, const char* labelValue,
+                             unsigned long value) {
+  append("%s{%s=\"%s\"} %lu\n", name, label, labelValue, value);
+}
+
+void MetricsWriter::bucket(const char* name, const char* label, const char* labelValue,
+                           const unsigned long* le, unsigned long value) {
+  if (le) {
+    append("%s{%s=\"%s\",le=\"%lu\"} %lu\n", name, label, labelValue, *le, value);
+  } else {
+    append("%s{%s=\"%s\",le=\"+Inf\"} %lu\n", name, label, labelValue, value);
+  }
+}
@@ -0,0 +1,110 @@
+#include "mqtt_manager.h"
+
+#if MQTT_ENABLED
+#include "power_manager.h"
+#include "time_service.h"
+
+// Static member initialization
+RTC_DATA_ATTR MqttSample MqttManager::backlog[MQTT_BACKLOG_SIZE];
+RTC_DATA_ATTR uint8_t MqttManager::backlogStart = 0;
+RTC_DATA_ATTR uint8_t MqttManager::backlogCount = 0;
+char MqttManager::payload[MQTT_PAYLOAD_SIZE];
+
+MqttManager::MqttManager() : sensorName("unknown"), lastSessionMs(0), lastAttemptMs(0), dropped(0) {}
+
+void MqttManager::addSample(uint64_t acquiredMs, uint64_t rtcUs, float temperature, float humidity,
+                            float heatIndex) {
+  if (backlogCount == MQTT_BACKLOG_SIZE) {
+    // Full: the oldest reading makes room
+    backlogStart = (backlogStart + 1) % MQTT_BACKLOG_SIZE;
+    backlogCount--;
+    dropped++;
+  }
+
+  MqttSample& sample = backlog[(backlogStart + backlogCount) % MQTT_BACKLOG_SIZE];
+  sample.timeMs = acquiredMs;
+  sample.rtcUs = rtcUs;
+  sample.temperature = temperature;
+  sample.humidity = humidity;
+  sample.heatIndex = heatIndex;
+  backlogCount++;
+}
+
+size_t MqttManager::buildPayload(uint64_t nowMs, uint8_t* sampleCount) {
+  int length = snprintf(payload, sizeof(payload), "{\"sensor\":\"%s\",\"samples\":[", sensorName.c_str());
+  *sampleCount = 0;
+
+  // Whatever does not fit in the buffer stays queued for the next flush
+  for (uint8_t i = 0; i < backlogCount; i++) {
+    const MqttSample& sample = backlog[(backlogStart + i) % MQTT_BACKLOG_SIZE];
+    int written = snprintf(payload + length, sizeof(payload) - length, "%s[%lu,%.2f,%.2f,%.2f",
+                           *sampleCount ? "," : "", (unsigned long)(nowMs - sample.timeMs),
+                           sample.temperature, sample.humidity, sample.heatIndex);
+#if TIME_SYNC_ENABLED
+    WallTime wall = TimeService::toWall(sample.rtcUs);
+    if (written > 0 && wall.valid && length + written < (int)sizeof(payload)) {
+      written += snprintf(payload + length + written, sizeof(payload) - length - written, ",%llu,%lu",
+                          (unsigned long long)wall.unixMs, (unsigned long)wall.errorMs);
+    }
+#endif
+    if (written > 0 && length + written < (int)sizeof(payload)) {
+      written += snprintf(payload + length + written, sizeof(payload) - length - written, "]");
+    }
+    if (written < 0 || length + written + 2 >= (int)sizeof(payload)) {
+      break;
+    }
+    length += written;
+    (*sampleCount)++;
+  }
+
+  length += snprintf(payload + length, sizeof(payload) - length, "]}");
+  return length;
+}
+
+bool MqttManager::flush() {
+  if (backlogCount == 0 || !Hal::network().isConnected()) {
+    return false;
+  }
+
+  unsigned long sessionStart = millis();
+  lastAttemptMs = sessionStart;
+  if (!Hal::mqtt().connect(MQTT_HOST, MQTT_PORT, MQTT_CLIENT_ID, MQTT_USERNAME, MQTT_PASSWORD,
+                           MQTT_KEEPALIVE)) {
+    Serial.println("✗ MQTT broker unreachable - keeping readings queued");
+    return false;
+  }
+
+  uint8_t sent = 0;
+  size_t length = buildPayload(PowerManager::getMonotonicMillis(), &sent);
+  bool published = Hal::mqtt().publish(MQTT_TOPIC, (const uint8_t*)payload, length);
+  Hal::mqtt().disconnect();
+  lastSessionMs = millis() - sessionStart;
+
+  if (!published) {
+    Serial.println("✗ MQTT publish failed - keeping readings queued");
+    return false;
+  }
+
+  // QoS 0: handed to the broker connection, nothing further to wait for
+  backlogStart = (backlogStart + sent) % MQTT_BACKLOG_SIZE;
+  backlogCount -= sent;
+
+#if SERIAL_DEBUG_VERBOSE
+  Serial.print("📡 MQTT: ");
+  Serial.print(sent);
+  Serial.print(sent == 1 ? " sample, " : " samples, ");
+  Serial.print(length);
+  Serial.print(" bytes in ");
+  Serial.print(lastSessionMs);
+  Serial.println(" ms session");
+#endif
+  return true;
+}
+
+void MqttManager::service() {
+  if (backlogCount > 0 && Hal::network().isConnected() && millis() - lastAttemptMs >= PUBLISH_RETRY_BACKOFF) {
+    flush();
+  }
+}
+
+#endif // MQTT_ENABLED
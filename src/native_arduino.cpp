@@ -0,0 +1,88 @@
+#ifndef ARDUINO
+
+// Host implementation of the Arduino subset declared in native/include/Arduino.h
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "hal.h"
+
+HardwareSerial Serial;
+
+unsigned long millis() { return Hal::clock().millis(); }
+unsigned long micros() { return Hal::clock().micros(); }
+void delay(unsigned long ms) { Hal::clock().delay(ms); }
+
+static std::string formatUnsigned(unsigned long number, unsigned char base) {
+  if (base < 2 || base > 16) {
+    base = DEC;
+  }
+  const char* digits = "0123456789ABCDEF";
+  char buffer[8 * sizeof(number) + 1];
+  char* end = buffer + sizeof(buffer);
+  char* cursor = end;
+  do {
+    *--cursor = digits[number % base];
+    number /= base;
+  } while (number != 0);
+  return std::string(cursor, end);
+}
+
+String::String(int number, unsigned char base) : String(static_cast<long>(number), base) {}
+
+String::String(unsigned int number, unsigned char base)
+  : String(static_cast<unsigned long>(number), base) {}
+
+String::String(long number, unsigned char base) {
+  if (number < 0 && base == DEC) {
+    value = "-" + formatUnsigned(0UL - static_cast<unsigned long>(number), base);
+  } else {
+    value = formatUnsigned(static_cast<unsigned long>(number), base);
+  }
+}
+
+String::String(unsigned long number, unsigned char base) : value(formatUnsigned(number, base)) {}
+
+String::String(float number, unsigned int decimals) : String(static_cast<double>(number), decimals) {}
+
+String::String(double number, unsigned int decimals) {
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(decimals), number);
+  value = buffer;
+}
+
+long String::toInt() const { return strtol(value.c_str(), nullptr, 10); }
+float String::toFloat() const { return strtof(value.c_str(), nullptr); }
+
+size_t Print::print(const char* text) {
+  size_t length = 0;
+  while (text[length] != '\0') {
+    length++;
+  }
+  return write(text, length);
+}
+
+size_t Print::printf(const char* format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length < 0) {
+    return 0;
+  }
+  return write(buffer, static_cast<size_t>(length) < sizeof(buffer) ? length : sizeof(buffer) - 1);
+}
+
+void HardwareSerial::flush() {
+  fflush(stdout);
+}
+
+size_t HardwareSerial::write(const char* data, size_t length) {
+  if (!echo) {
+    return length;
+  }
+  return fwrite(data, 1, length, stdout);
+}
+
+#endif // ARDUINO
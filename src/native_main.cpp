@@ -0,0 +1,127 @@
+#if !defined(ARDUINO) && !defined(PIO_UNIT_TESTING)
+
+// Host entry point for [env:native]: runs the firmware's setup()/loop()
+// against the HAL fakes on a simulated clock. Unit tests (test/) bring their
+// own main().
+//
+// Usage: program [simulated seconds]      run for a fixed time (default 3600)
+//        program --replay <trace file>    replay a recorded trace and report
+//        program --discharge <mAh> [days] drain a simulated battery through the
+//                                         battery policy (BATTERY_MONITOR_ENABLED)
+//        program --time-drift <ppm> [days] [swing ppm]
+//                                         check the time service against a drifting
+//                                         RTC timer (TIME_SYNC_ENABLED)
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal_fake.h"
+#include "trace_replay.h"
+#include "battery_simulation.h"
+#include "drift_simulation.h"
+#include "config.h"
+
+#if BATTERY_MONITOR_ENABLED
+extern BatteryPolicy batteryPolicy; // main.cpp
+#endif
+
+void setup();
+void loop();
+
+static const uint64_t LOOP_PASS_MICROS = 1000;
+
+int main(int argc, char** argv) {
+  TraceReplay replay;
+  bool replaying = argc > 2 && strcmp(argv[1], "--replay") == 0;
+  bool discharging = argc > 2 && strcmp(argv[1], "--discharge") == 0;
+  BatterySimulation battery(discharging ? strtof(argv[2], nullptr) : 0.0f);
+  bool drifting = argc > 2 && strcmp(argv[1], "--time-drift") == 0;
+  DriftSimulation drift(drifting ? strtod(argv[2], nullptr) : 0.0,
+                        drifting && argc > 4 ? strtod(argv[4], nullptr) : 200.0);
+  uint64_t runMicros = 3600 * 1000000ULL;
+
+  if (replaying) {
+    if (!replay.load(argv[2])) {
+      fprintf(stderr, "No trace events found in %s\n", argv[2]);
+      return 1;
+    }
+    runMicros = replay.durationMs() * 1000ULL;
+  } else if (discharging) {
+#if !BATTERY_MONITOR_ENABLED
+    fprintf(stderr, "--discharge needs BATTERY_MONITOR_ENABLED in config.h\n");
+    return 1;
+#endif
+    runMicros = (argc > 3 ? strtoull(argv[3], nullptr, 10) : 365) * 86400 * 1000000ULL;
+  } else if (drifting) {
+#if !TIME_SYNC_ENABLED
+    fprintf(stderr, "--time-drift needs TIME_SYNC_ENABLED (-DTIME_SYNC_ENABLED=true)\n");
+    return 1;
+#endif
+    runMicros = (argc > 3 ? strtoull(argv[3], nullptr, 10) : 7) * 86400 * 1000000ULL;
+  } else if (argc > 1) {
+    runMicros = strtoull(argv[1], nullptr, 10) * 1000000ULL;
+  }
+
+  FakeHal::reset();
+  if (replaying) {
+    Serial.setEcho(false);
+    replay.advanceTo(0);
+  }
+  if (discharging) {
+    Serial.setEcho(false);
+    printf("Discharging %s mAh:\n", argv[2]);
+    battery.begin();
+  }
+  if (drifting) {
+    Serial.setEcho(false);
+    printf("RTC timer drifting %s ppm:\n", argv[2]);
+    drift.begin();
+  }
+  setup();
+
+  while (FakeHal::clock().totalMicros() < runMicros) {
+    if (replaying) {
+      replay.advanceTo(FakeHal::clock().totalMicros() / 1000);
+    }
+#if BATTERY_MONITOR_ENABLED
+    if (discharging) {
+      battery.step();
+      battery.observeTier(batteryPolicy.getTier());
+      if (battery.empty()) {
+        break;
+      }
+    }
+#endif
+    if (drifting) {
+      drift.step();
+    }
+
+    // On target esp_deep_sleep_start() never returns; emulate the reboot
+    if (FakeHal::power().deepSleepRequested()) {
+      if (drifting) {
+        drift.observeWake();
+      }
+      FakeHal::power().wakeFromDeepSleep();
+      setup();
+      continue;
+    }
+    loop();
+    // Real passes take time; keep busy-polling loops from stalling the clock
+    FakeHal::clock().advanceMicros(LOOP_PASS_MICROS);
+  }
+
+  Serial.flush();
+  if (replaying) {
+    replay.printReport();
+  }
+  if (discharging) {
+    battery.printReport();
+  }
+  if (drifting) {
+    drift.printReport();
+  }
+  return 0;
+}
+
+#endif // !ARDUINO && !PIO_UNIT_TESTING
@@ -1,33 +1,49 @@
 // filepath: src/power_manager.cpp
 #include "power_manager.h"
-#include <esp_sleep.h>
-#include <esp_wifi.h>
-#include <esp_bt.h>
-#include <WiFi.h>
+#include "hal.h"
+#include "energy_model.h"
 
 // Static member initialization
 unsigned long PowerManager::wakeupTime = 0;
 unsigned long PowerManager::operationStartTime = 0;
 bool PowerManager::deepSleepScheduled = false;
+unsigned long PowerManager::sleepDurationSeconds = DEEP_SLEEP_DURATION;
+unsigned long PowerManager::checkIntervalSeconds = 0;
+uint8_t PowerManager::sleepMultiplier = 1;
+uint32_t PowerManager::cpuCeilingMhz = 240;
+RTC_DATA_ATTR uint64_t PowerManager::sleepOffsetMs = 0;
+bool PowerManager::lowPowerModeActive = false;
+bool PowerManager::lightSleepActive = false;
+PowerPhase PowerManager::currentPhase = PowerPhase::Idle;
+uint32_t PowerManager::phaseFrequencyMhz[POWER_PHASE_COUNT] = {
+  PM_IDLE_CPU_FREQ_MHZ, PM_SAMPLE_CPU_FREQ_MHZ, PM_PUBLISH_CPU_FREQ_MHZ
+};
+uint64_t PowerManager::phaseMicros[POWER_PHASE_COUNT] = {};
+unsigned long PowerManager::phaseStartMicros = 0;
+
+static const char* PHASE_NAMES[POWER_PHASE_COUNT] = { "idle", "sample", "publish" };
 
 void PowerManager::begin() {
   wakeupTime = millis();
   operationStartTime = millis();
   deepSleepScheduled = false;
+  currentPhase = PowerPhase::Idle;
+  phaseStartMicros = micros();
+  for (uint8_t i = 0; i < POWER_PHASE_COUNT; i++) {
+    phaseMicros[i] = 0;
+  }
 
 #if DEEP_SLEEP_ENABLED
   // Print wakeup reason for debugging
-  esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
-  
   Serial.println("=== Power Manager Initialized ===");
   Serial.print("Wake-up reason: ");
   Serial.println(getWakeupReason());
   
   // Configure timer wake-up source
-  esp_sleep_enable_timer_wakeup(DEEP_SLEEP_DURATION * 1000000ULL); // Convert seconds to microseconds
+  Hal::power().enableTimerWakeup(getArmedSleepDuration() * 1000000ULL); // Convert seconds to microseconds
   
   Serial.print("Deep sleep enabled - Duration: ");
-  Serial.print(DEEP_SLEEP_DURATION);
+  Serial.print(getArmedSleepDuration());
   Serial.println(" seconds");
   
   // Configure wake-up sources
@@ -35,6 +51,9 @@ void PowerManager::begin() {
 #else
   Serial.println("=== Power Manager Initialized ===");
   Serial.println("Deep sleep disabled");
+#if LIGHT_SLEEP_ENABLED
+  beginLowPowerMode();
+#endif
 #endif
 
   Serial.print("Operation timeout: ");
@@ -61,46 +80,38 @@ void PowerManager::enterDeepSleep() {
   
   // Prepare for sleep
   // inline printing using %
-  Serial.print("Sleeping for");
-  Serial.print(DEEP_SLEEP_DURATION);
+  Serial.print("Sleeping for ");
+  Serial.print(getArmedSleepDuration());
   Serial.println(" seconds...");
   
   // Flush serial output
   Serial.flush();
   
+  // Carry the monotonic clock across the sleep
+  sleepOffsetMs += millis() + getArmedSleepDuration() * 1000ULL;
+
   // Disconnect WiFi to save power
-  WiFi.disconnect();
-  WiFi.mode(WIFI_OFF);
+  Hal::network().shutdown();
   
-  // Disable Bluetooth
-  esp_bt_controller_disable();
-  
-  // Enter deep sleep
-  esp_deep_sleep_start();
+  // Enter deep sleep (Bluetooth is disabled by the HAL)
+  Hal::power().deepSleep();
 }
 
 bool PowerManager::isWakeupFromDeepSleep() {
-  esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
-  return wakeup_reason == ESP_SLEEP_WAKEUP_TIMER || 
-         wakeup_reason == ESP_SLEEP_WAKEUP_EXT0 || 
-         wakeup_reason == ESP_SLEEP_WAKEUP_EXT1 ||
-         wakeup_reason == ESP_SLEEP_WAKEUP_TOUCHPAD ||
-         wakeup_reason == ESP_SLEEP_WAKEUP_ULP;
+  return Hal::power().wakeCause() != WakeCause::PowerOn;
 }
 
 String PowerManager::getWakeupReason() {
-  esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
-  
-  switch (wakeup_reason) {
-    case ESP_SLEEP_WAKEUP_EXT0:
+  switch (Hal::power().wakeCause()) {
+    case WakeCause::ExternalRtcIo:
       return "External signal using RTC_IO";
-    case ESP_SLEEP_WAKEUP_EXT1:
+    case WakeCause::ExternalRtcCntl:
       return "External signal using RTC_CNTL";
-    case ESP_SLEEP_WAKEUP_TIMER:
+    case WakeCause::Timer:
       return "Timer";
-    case ESP_SLEEP_WAKEUP_TOUCHPAD:
+    case WakeCause::Touchpad:
       return "Touchpad";
-    case ESP_SLEEP_WAKEUP_ULP:
+    case WakeCause::Ulp:
       return "ULP program";
     default:
       return "First boot or reset";
@@ -136,29 +147,207 @@ void PowerManager::cancelDeepSleep() {
   Serial.println("Deep sleep cancelled");
 }
 
-bool PowerManager::isDeepSleepEnabled() {
+void PowerManager::setSleepDuration(unsigned long seconds) {
+  sleepDurationSeconds = seconds > 0 ? seconds : 1;
 #if DEEP_SLEEP_ENABLED
-  return true;
-#else
-  return false;
+  Hal::power().enableTimerWakeup(getArmedSleepDuration() * 1000000ULL);
+#endif
+}
+
+unsigned long PowerManager::getSleepDuration() {
+  return sleepDurationSeconds;
+}
+
+void PowerManager::setCheckInterval(unsigned long seconds) {
+  checkIntervalSeconds = seconds;
+#if DEEP_SLEEP_ENABLED
+  Hal::power().enableTimerWakeup(getArmedSleepDuration() * 1000000ULL);
+#endif
+}
+
+void PowerManager::setSleepMultiplier(uint8_t multiplier) {
+  sleepMultiplier = multiplier > 0 ? multiplier : 1;
+#if DEEP_SLEEP_ENABLED
+  Hal::power().enableTimerWakeup(getArmedSleepDuration() * 1000000ULL);
 #endif
 }
 
+uint8_t PowerManager::getSleepMultiplier() {
+  return sleepMultiplier;
+}
+
+unsigned long PowerManager::getArmedSleepDuration() {
+  unsigned long sleepSeconds = sleepDurationSeconds * sleepMultiplier;
+  if (checkIntervalSeconds > 0 && checkIntervalSeconds < sleepSeconds) {
+    return checkIntervalSeconds;
+  }
+  return sleepSeconds;
+}
+
+uint64_t PowerManager::getMonotonicMillis() {
+  return sleepOffsetMs + millis();
+}
+
 void PowerManager::printPowerStats() {
   Serial.println("=== Power Statistics ===");
   Serial.print("Total wake time: ");
   Serial.print(millis() - wakeupTime);
   Serial.println(" ms");
+  Serial.print("METRIC wake_ms=");
+  Serial.println(millis() - wakeupTime);
   
   Serial.print("Operation time: ");
   Serial.print(getOperationTime());
   Serial.println(" ms");
   
   Serial.print("Free heap: ");
-  Serial.print(ESP.getFreeHeap());
+  Serial.print(Hal::power().freeHeap());
   Serial.println(" bytes");
   
   Serial.print("CPU frequency: ");
-  Serial.print(ESP.getCpuFreqMHz());
+  Serial.print(Hal::power().cpuFrequencyMhz());
   Serial.println(" MHz");
 }
+
+void PowerManager::beginLowPowerMode() {
+  // Modem sleep keeps the AP association, so HomeSpan and Blynk sockets stay up
+  Hal::network().setModemSleep(true);
+
+  uint32_t idleMhz = getPhaseFrequency(PowerPhase::Idle);
+  lightSleepActive = Hal::power().configurePowerManagement(idleMhz, PM_MIN_CPU_FREQ_MHZ, true);
+  lowPowerModeActive = lightSleepActive ||
+                       Hal::power().configurePowerManagement(idleMhz, PM_MIN_CPU_FREQ_MHZ, false);
+
+  if (lightSleepActive) {
+    Serial.println("✓ Automatic light sleep and frequency scaling enabled");
+  } else if (lowPowerModeActive) {
+    Serial.println("⚠️ Light sleep not supported by this SDK build - frequency scaling only");
+  } else {
+    Serial.println("✗ Power management not supported by this SDK build");
+    return;
+  }
+
+#if SERIAL_DEBUG_VERBOSE
+  for (uint8_t i = 0; i < POWER_PHASE_COUNT; i++) {
+    Serial.print("  ");
+    Serial.print(PHASE_NAMES[i]);
+    Serial.print(": ");
+    Serial.print(getPhaseFrequency((PowerPhase)i));
+    Serial.println(" MHz");
+  }
+#endif
+}
+
+void PowerManager::applyPhasePolicy() {
+  if (!lowPowerModeActive) {
+    return;
+  }
+
+  // Set the ceiling first, then pin the CPU to it outside idle
+  Hal::power().configurePowerManagement(getPhaseFrequency(currentPhase),
+                                        PM_MIN_CPU_FREQ_MHZ, lightSleepActive);
+  Hal::power().holdCpuFrequency(currentPhase != PowerPhase::Idle);
+}
+
+void PowerManager::setPhaseFrequency(PowerPhase phase, uint32_t mhz) {
+  phaseFrequencyMhz[(uint8_t)phase] = mhz;
+  if (phase == currentPhase) {
+    applyPhasePolicy();
+  }
+}
+
+uint32_t PowerManager::getPhaseFrequency(PowerPhase phase) {
+  uint32_t mhz = phaseFrequencyMhz[(uint8_t)phase];
+  return mhz < cpuCeilingMhz ? mhz : cpuCeilingMhz;
+}
+
+void PowerManager::setCpuCeiling(uint32_t mhz) {
+  cpuCeilingMhz = mhz > PM_MIN_CPU_FREQ_MHZ ? mhz : PM_MIN_CPU_FREQ_MHZ;
+  if (lowPowerModeActive) {
+    applyPhasePolicy();
+  } else if (Hal::power().cpuFrequencyMhz() != cpuCeilingMhz) {
+    // No scaling: run the whole wake at the ceiling
+    Hal::power().setCpuFrequencyMhz(cpuCeilingMhz);
+  }
+}
+
+void PowerManager::enterPhase(PowerPhase phase) {
+  if (phase == currentPhase) {
+    return;
+  }
+
+  accumulatePhaseTime();
+  currentPhase = phase;
+  applyPhasePolicy();
+}
+
+PowerPhase PowerManager::getPhase() {
+  return currentPhase;
+}
+
+bool PowerManager::isLowPowerModeActive() {
+  return lowPowerModeActive;
+}
+
+void PowerManager::accumulatePhaseTime() {
+  unsigned long now = micros();
+  phaseMicros[(uint8_t)currentPhase] += now - phaseStartMicros;
+  phaseStartMicros = now;
+}
+
+float PowerManager::getPhaseCurrentMa(PowerPhase phase) {
+  if (!lowPowerModeActive) {
+    // Radio fully awake and the CPU at its boot frequency throughout
+    return EnergyModel::RADIO_CURRENT_MA;
+  }
+
+  uint32_t mhz = getPhaseFrequency(phase);
+  switch (phase) {
+    case PowerPhase::Idle:
+      return lightSleepActive ? EnergyModel::LIGHT_SLEEP_IDLE_CURRENT_MA
+                              : EnergyModel::cpuCurrentMa(PM_MIN_CPU_FREQ_MHZ) +
+                                EnergyModel::MODEM_SLEEP_RADIO_CURRENT_MA;
+    case PowerPhase::Sample:
+      return EnergyModel::cpuCurrentMa(mhz) + EnergyModel::MODEM_SLEEP_RADIO_CURRENT_MA;
+    case PowerPhase::Publish:
+    default:
+      // Radio transmitting; swap the 240 MHz CPU share for the held frequency
+      return EnergyModel::RADIO_CURRENT_MA - EnergyModel::ACTIVE_CURRENT_MA +
+             EnergyModel::cpuCurrentMa(mhz);
+  }
+}
+
+float PowerManager::getAverageCurrentMa() {
+  accumulatePhaseTime();
+
+  uint64_t totalMicros = 0;
+  float weighted = 0.0f;
+  for (uint8_t i = 0; i < POWER_PHASE_COUNT; i++) {
+    totalMicros += phaseMicros[i];
+    weighted += getPhaseCurrentMa((PowerPhase)i) * phaseMicros[i];
+  }
+  return totalMicros > 0 ? weighted / totalMicros : getPhaseCurrentMa(currentPhase);
+}
+
+void PowerManager::printPhaseStats() {
+  float averageMa = getAverageCurrentMa(); // Also brings the phase times up to date
+
+  uint64_t totalMicros = 0;
+  for (uint8_t i = 0; i < POWER_PHASE_COUNT; i++) {
+    totalMicros += phaseMicros[i];
+  }
+
+  Serial.println("=== Power Phases ===");
+  for (uint8_t i = 0; i < POWER_PHASE_COUNT; i++) {
+    Serial.print(PHASE_NAMES[i]);
+    Serial.print(": ");
+    Serial.print((unsigned long)(phaseMicros[i] / 1000));
+    Serial.print(" ms (");
+    Serial.print(totalMicros > 0 ? 100.0f * phaseMicros[i] / totalMicros : 0.0f, 1);
+    Serial.print("%) at ");
+    Serial.print(getPhaseCurrentMa((PowerPhase)i), 1);
+    Serial.println(" mA");
+  }
+  Serial.print("METRIC avg_current_ma=");
+  Serial.println(averageMa, 2);
+}
@@ -0,0 +1,241 @@
+#include "publish_dispatcher.h"
+#include "power_manager.h"
+
+PublishDispatcher::PublishDispatcher() : sinkCount(0) {}
+
+bool PublishDispatcher::addSink(Publisher& publisher, const SinkOptions& options) {
+  if (sinkCount >= MAX_SINKS) {
+    Serial.print("✗ Publisher not registered (sink limit): ");
+    Serial.println(publisher.name());
+    return false;
+  }
+
+  Sink& sink = sinks[sinkCount++];
+  sink = Sink();
+  sink.publisher = &publisher;
+  sink.options = options;
+  sink.enabled = true;
+  if (sink.options.queueCapacity < 1) {
+    sink.options.queueCapacity = 1;
+  } else if (sink.options.queueCapacity > MAX_QUEUE_DEPTH) {
+    sink.options.queueCapacity = MAX_QUEUE_DEPTH;
+  }
+  return true;
+}
+
+bool PublishDispatcher::setSinkEnabled(Publisher& publisher, bool enabled) {
+  for (uint8_t i = 0; i < sinkCount; i++) {
+    Sink& sink = sinks[i];
+    if (sink.publisher != &publisher) {
+      continue;
+    }
+    if (!enabled) {
+      sink.stats.dropped += sink.count;
+      sink.count = 0;
+      sink.attempts = 0;
+      sink.backingOff = false;
+    }
+    sink.enabled = enabled;
+    return true;
+  }
+  return false;
+}
+
+void PublishDispatcher::pop(Sink& sink) {
+  sink.head = (sink.head + 1) % MAX_QUEUE_DEPTH;
+  sink.count--;
+  sink.attempts = 0;
+  sink.backingOff = false;
+}
+
+void PublishDispatcher::submit(const PublishSample& sample) {
+  for (uint8_t i = 0; i < sinkCount; i++) {
+    Sink& sink = sinks[i];
+    if (!sink.enabled) {
+      continue;
+    }
+    if (sink.count >= sink.options.queueCapacity) {
+      sink.stats.dropped++;
+      if (sink.options.policy == QueuePolicy::DropNewest) {
+        continue;
+      }
+      pop(sink);
+    }
+    Entry& entry = sink.queue[(sink.head + sink.count) % MAX_QUEUE_DEPTH];
+    entry.sample = sample;
+    entry.enqueuedMs = PowerManager::getMonotonicMillis();
+    sink.count++;
+  }
+}
+
+uint8_t PublishDispatcher::service(uint64_t nowMs) {
+  uint8_t delivered = 0;
+  unsigned long passStart = millis();
+
+  for (uint8_t i = 0; i < sinkCount; i++) {
+    Sink& sink = sinks[i];
+    collectAcks(sink, nowMs + (millis() - passStart));
+    if (!sink.enabled || sink.count == 0 || !sink.publisher->isReady()) {
+      continue;
+    }
+    if (sink.backingOff && (long)(millis() - sink.retryAtMs) < 0) {
+      continue;
+    }
+
+    const Entry& entry = sink.queue[sink.head];
+    const PublishSample& sample = entry.sample;
+    unsigned long callStart = millis();
+    bool ok = sink.publisher->publish(sample);
+    unsigned long callMs = millis() - callStart;
+    if (callMs > sink.stats.maxCallMs) {
+      sink.stats.maxCallMs = callMs;
+    }
+
+    if (ok) {
+      // Includes time spent in the sinks serviced before this one
+      uint64_t deliveredMs = nowMs + (millis() - passStart);
+      unsigned long lag = deliveredMs > sample.timeMs ? (unsigned long)(deliveredMs - sample.timeMs) : 0;
+      sink.stats.lastLagMs = lag;
+      if (lag > sink.stats.maxLagMs) {
+        sink.stats.maxLagMs = lag;
+      }
+      sink.stats.lastQueueMs = deliveredMs > entry.enqueuedMs ? (unsigned long)(deliveredMs - entry.enqueuedMs) : 0;
+      sink.stats.publishLatency.record(lag);
+      sink.stats.sent.observe(sample.sequence);
+      sink.stats.delivered++;
+      delivered++;
+      pop(sink);
+      continue;
+    }
+
+    sink.attempts++;
+    if (sink.attempts > sink.options.retryBudget) {
+      sink.stats.failed++;
+      pop(sink);
+    } else {
+      sink.stats.retries++;
+      sink.backingOff = true;
+      sink.retryAtMs = millis() + sink.options.retryBackoffMs;
+    }
+  }
+  return delivered;
+}
+
+void PublishDispatcher::collectAcks(Sink& sink, uint64_t nowMs) {
+  PublishAck ack;
+  while (sink.publisher->takeAck(ack)) {
+    if (!sink.stats.acked.observe(ack.sequence)) {
+      continue; // Answered twice: timed the first time
+    }
+    unsigned long lag = nowMs > ack.timeMs ? (unsigned long)(nowMs - ack.timeMs) : 0;
+    sink.stats.lastAckLagMs = lag;
+    sink.stats.ackLatency.record(lag);
+    sink.stats.acks++;
+  }
+}
+
+uint8_t PublishDispatcher::drain(unsigned long timeoutMs) {
+  uint8_t delivered = 0;
+  unsigned long start = millis();
+
+  while (millis() - start < timeoutMs) {
+    bool pending = false;
+    for (uint8_t i = 0; i < sinkCount; i++) {
+      // Only sinks that could make progress right now keep the drain going
+      if (sinks[i].count > 0 && !sinks[i].backingOff && sinks[i].publisher->isReady()) {
+        pending = true;
+      }
+    }
+    if (!pending) {
+      break;
+    }
+    delivered += service(PowerManager::getMonotonicMillis());
+  }
+  return delivered;
+}
+
+void PublishDispatcher::printStats() {
+  Serial.println("=== Publishers ===");
+  for (uint8_t i = 0; i < sinkCount; i++) {
+    const Sink& sink = sinks[i];
+    Serial.print(sink.publisher->name());
+    if (!sink.enabled) {
+      Serial.print(" (disabled)");
+    }
+    Serial.print(": queued ");
+    Serial.print(sink.count);
+    Serial.print(", delivered ");
+    Serial.print(sink.stats.delivered);
+    Serial.print(", dropped ");
+    Serial.print(sink.stats.dropped);
+    Serial.print(", failed ");
+    Serial.print(sink.stats.failed);
+    Serial.print(", retries ");
+    Serial.print(sink.stats.retries);
+    Serial.print(", lag ");
+    Serial.print(sink.stats.lastLagMs);
+    Serial.print(" ms (max ");
+    Serial.print(sink.stats.maxLagMs);
+    Serial.print(" ms), slowest call ");
+    Serial.print(sink.stats.maxCallMs);
+    Serial.println(" ms");
+
+    const LatencyHistogram& latency = sink.stats.publishLatency;
+    Serial.print("  latency p50 ");
+    Serial.print(latency.getQuantileMs(0.5f));
+    Serial.print(" ms, p95 ");
+    Serial.print(latency.getQuantileMs(0.95f));
+    Serial.print(" ms, queued ");
+    Serial.print(sink.stats.lastQueueMs);
+    Serial.print(" ms, seq ");
+    Serial.print(sink.stats.sent.getLast());
+    Serial.print(" (gaps ");
+    Serial.print(sink.stats.sent.getGaps());
+    Serial.print(", duplicates ");
+    Serial.print(sink.stats.sent.getDuplicates());
+    Serial.println(")");
+    if (sink.stats.acks > 0) {
+      Serial.print("  acks ");
+      Serial.print(sink.stats.acks);
+      Serial.print(", ack latency ");
+      Serial.print(sink.stats.lastAckLagMs);
+      Serial.print(" ms (p95 ");
+      Serial.print(sink.stats.ackLatency.getQuantileMs(0.95f));
+      Serial.print(" ms), unanswered ");
+      Serial.print(sink.stats.delivered - sink.stats.acks);
+      Serial.print(", duplicate acks ");
+      Serial.println(sink.stats.acked.getDuplicates());
+    }
+
+    Serial.print("METRIC sink_");
+    Serial.print(sink.publisher->name());
+    Serial.print("_lag_ms=");
+    Serial.println(sink.stats.lastLagMs);
+    Serial.print("METRIC sink_");
+    Serial.print(sink.publisher->name());
+    Serial.print("_dropped=");
+    Serial.println(sink.stats.dropped + sink.stats.failed);
+    Serial.print("METRIC sink_");
+    Serial.print(sink.publisher->name());
+    Serial.print("_lag_p95_ms=");
+    Serial.println(latency.getQuantileMs(0.95f));
+    Serial.print("METRIC sink_");
+    Serial.print(sink.publisher->name());
+    Serial.print("_seq_gaps=");
+    Serial.println(sink.stats.sent.getGaps());
+    if (sink.stats.acks > 0) {
+      Serial.print("METRIC sink_");
+      Serial.print(sink.publisher->name());
+      Serial.print("_ack_ms=");
+      Serial.println(sink.stats.lastAckLagMs);
+      Serial.print("METRIC sink_");
+      Serial.print(sink.publisher->name());
+      Serial.print("_unanswered=");
+      Serial.println(sink.stats.delivered - sink.stats.acks);
+      Serial.print("METRIC sink_");
+      Serial.print(sink.publisher->name());
+      Serial.print("_ack_duplicates=");
+      Serial.println(sink.stats.acked.getDuplicates());
+    }
+  }
+}
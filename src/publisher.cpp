@@ -0,0 +1,93 @@
+#include "publisher.h"
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+
+#if HOMEKIT_ENABLED
+bool HomeKitPublisher::publish(const PublishSample& sample) {
+  homekit.updateSensorData(sample.temperature, sample.humidity);
+  return true;
+}
+#endif
+
+#if BLYNK_ENABLED
+bool BlynkPublisher::publish(const PublishSample& sample) {
+  if (!blynk.isConnected()) {
+    return false;
+  }
+  blynk.sendSensorData(sample.temperature, sample.humidity, sample.heatIndex);
+  blynk.sendStatus(sensorName, true);
+  return true;
+}
+#endif
+
+#if MQTT_ENABLED
+bool MqttPublisher::publish(const PublishSample& sample) {
+  mqtt.addSample(sample.timeMs, sample.rtcUs, sample.temperature, sample.humidity, sample.heatIndex);
+  if (WiFiManager::isConnected()) {
+    mqtt.flush();
+  }
+  return true;
+}
+#endif
+
+#if SERIAL_CSV_ENABLED
+bool SerialCsvPublisher::publish(const PublishSample& sample) {
+  Serial.print("CSV,");
+  Serial.print((unsigned long)sample.timeMs);
+  Serial.print(",");
+  Serial.print(sample.temperature, 2);
+  Serial.print(",");
+  Serial.print(sample.humidity, 2);
+  Serial.print(",");
+  Serial.println(sample.heatIndex, 2);
+  return true;
+}
+#endif
+
+#if ECHO_SINK_ENABLED
+size_t EchoPublisher::format(const PublishSample& sample, char* buffer, size_t capacity) {
+  int length = snprintf(buffer, capacity, "SEQ %lu %llu", (unsigned long)sample.sequence,
+                        (unsigned long long)sample.timeMs);
+  return length > 0 && (size_t)length < capacity ? length : 0;
+}
+
+bool EchoPublisher::parse(const char* datagram, size_t length, PublishAck& ack) {
+  char text[DATAGRAM_SIZE];
+  if (length >= sizeof(text)) {
+    return false;
+  }
+  memcpy(text, datagram, length);
+  text[length] = '\0';
+
+  unsigned long sequence;
+  unsigned long long timeMs;
+  if (sscanf(text, "SEQ %lu %llu", &sequence, &timeMs) != 2) {
+    return false;
+  }
+  ack.sequence = sequence;
+  ack.timeMs = timeMs;
+  return true;
+}
+
+bool EchoPublisher::publish(const PublishSample& sample) {
+  char datagram[DATAGRAM_SIZE];
+  size_t length = format(sample, datagram, sizeof(datagram));
+  if (length == 0 || !Hal::datagram().begin(ECHO_LOCAL_PORT)) {
+    return false;
+  }
+  return Hal::datagram().sendTo(ECHO_SERVER_HOST, ECHO_SERVER_PORT, (const uint8_t*)datagram, length);
+}
+
+bool EchoPublisher::takeAck(PublishAck& ack) {
+  uint8_t datagram[DATAGRAM_SIZE];
+  size_t length;
+  // Skip anything that is not an echo of ours
+  while ((length = Hal::datagram().receive(datagram, sizeof(datagram))) > 0) {
+    if (parse((const char*)datagram, length, ack)) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif
@@ -0,0 +1,144 @@
+#include "rolling_stats.h"
+#include <math.h>
+
+void RollingWindow::configure(uint32_t window) {
+  if (started && window == windowMs) {
+    return; // Same window: keep the history (deep sleep wake)
+  }
+  windowMs = window;
+  bucketMs = window / BUCKETS > 0 ? window / BUCKETS : 1;
+  reset();
+}
+
+void RollingWindow::reset() {
+  started = false;
+  currentBucketId = 0;
+  for (uint8_t i = 0; i < BUCKETS; i++) {
+    buckets[i] = Bucket{ 0, 0.0f, 0.0f };
+  }
+  minimums.clear();
+  maximums.clear();
+}
+
+void RollingWindow::advanceTo(uint32_t bucketId) {
+  if (!started) {
+    started = true;
+    currentBucketId = bucketId;
+    buckets[bucketId % BUCKETS] = Bucket{ 0, 0.0f, 0.0f };
+    return;
+  }
+  if (bucketId <= currentBucketId) {
+    return; // Same bucket, or a clock step backwards: keep adding to the newest
+  }
+
+  // Clear the buckets being reused; after a full window everything is stale
+  uint32_t steps = bucketId - currentBucketId;
+  for (uint32_t i = 1; i <= steps && i <= BUCKETS; i++) {
+    buckets[(currentBucketId + i) % BUCKETS] = Bucket{ 0, 0.0f, 0.0f };
+  }
+  currentBucketId = bucketId;
+
+  // Entries from buckets that left the window sit at the front
+  uint32_t oldestLive = bucketId >= BUCKETS - 1 ? bucketId - (BUCKETS - 1) : 0;
+  while (minimums.count > 0 && minimums.front().bucketId < oldestLive) {
+    minimums.popFront();
+  }
+  while (maximums.count > 0 && maximums.front().bucketId < oldestLive) {
+    maximums.popFront();
+  }
+}
+
+void RollingWindow::pushExtreme(MonotonicDeque& deque, uint32_t bucketId, float value, bool keepSmaller) {
+  // An entry from the same bucket that is at least as good expires together
+  // with this one, so this value could never be reported
+  if (deque.count > 0 && deque.back().bucketId == bucketId &&
+      (keepSmaller ? deque.back().value <= value : deque.back().value >= value)) {
+    return;
+  }
+  // Older entries this value beats can never be reported again
+  while (deque.count > 0 && (keepSmaller ? deque.back().value >= value : deque.back().value <= value)) {
+    deque.popBack();
+  }
+  deque.pushBack(Extreme{ bucketId, value });
+}
+
+void RollingWindow::add(uint64_t timeMs, float value) {
+  if (isnan(value)) {
+    return;
+  }
+  advanceTo((uint32_t)(timeMs / bucketMs));
+
+  // Welford update of the newest bucket
+  Bucket& bucket = buckets[currentBucketId % BUCKETS];
+  bucket.count++;
+  float delta = value - bucket.mean;
+  bucket.mean += delta / bucket.count;
+  bucket.m2 += delta * (value - bucket.mean);
+
+  pushExtreme(minimums, currentBucketId, value, true);
+  pushExtreme(maximums, currentBucketId, value, false);
+}
+
+WindowStats RollingWindow::getStats(uint64_t nowMs) {
+  WindowStats stats = { 0, NAN, 0.0f, NAN, NAN };
+  if (!started) {
+    return stats;
+  }
+  advanceTo((uint32_t)(nowMs / bucketMs));
+
+  // Chan et al. pairwise merge of the bucket summaries, in double
+  double count = 0.0;
+  double mean = 0.0;
+  double m2 = 0.0;
+  for (uint8_t i = 0; i < BUCKETS; i++) {
+    const Bucket& bucket = buckets[i];
+    if (bucket.count == 0) {
+      continue;
+    }
+    double merged = count + bucket.count;
+    double delta = bucket.mean - mean;
+    mean += delta * bucket.count / merged;
+    m2 += bucket.m2 + delta * delta * count * bucket.count / merged;
+    count = merged;
+  }
+
+  if (count == 0.0) {
+    return stats;
+  }
+  stats.count = (uint32_t)count;
+  stats.mean = (float)mean;
+  stats.stddev = count > 1.0 ? (float)sqrt(m2 / (count - 1.0)) : 0.0f;
+  stats.min = minimums.front().value;
+  stats.max = maximums.front().value;
+  return stats;
+}
+
+const uint32_t RollingStats::WINDOW_MS[WINDOW_COUNT] = { 5UL * 60 * 1000, 60UL * 60 * 1000,
+                                                         24UL * 60 * 60 * 1000 };
+const char* const RollingStats::WINDOW_NAMES[WINDOW_COUNT] = { "5m", "1h", "24h" };
+
+void RollingStats::configure() {
+  for (uint8_t i = 0; i < WINDOW_COUNT; i++) {
+    temperature[i].configure(WINDOW_MS[i]);
+    humidity[i].configure(WINDOW_MS[i]);
+  }
+}
+
+void RollingStats::reset() {
+  for (uint8_t i = 0; i < WINDOW_COUNT; i++) {
+    temperature[i].reset();
+    humidity[i].reset();
+  }
+}
+
+void RollingStats::add(uint64_t timeMs, float temperatureValue, float humidityValue) {
+  for (uint8_t i = 0; i < WINDOW_COUNT; i++) {
+    temperature[i].add(timeMs, temperatureValue);
+    humidity[i].add(timeMs, humidityValue);
+  }
+}
+
+WindowStats RollingStats::getStats(uint8_t window, RollingQuantity quantity, uint64_t nowMs) {
+  RollingWindow& source = quantity == RollingQuantity::Temperature ? temperature[window] : humidity[window];
+  return source.getStats(nowMs);
+}
@@ -0,0 +1,49 @@
+#include "runtime_metrics.h"
+#include "hal.h"
+
+unsigned long RuntimeMetrics::passStartMicros = 0;
+unsigned long RuntimeMetrics::lastMicros = 0;
+unsigned long RuntimeMetrics::maxMicros = 0;
+uint64_t RuntimeMetrics::totalMicros = 0;
+uint32_t RuntimeMetrics::passes = 0;
+
+void RuntimeMetrics::reset() {
+  passStartMicros = 0;
+  lastMicros = 0;
+  maxMicros = 0;
+  totalMicros = 0;
+  passes = 0;
+}
+
+void RuntimeMetrics::beginPass() {
+  passStartMicros = micros();
+}
+
+void RuntimeMetrics::endPass() {
+  lastMicros = micros() - passStartMicros;
+  if (lastMicros > maxMicros) {
+    maxMicros = lastMicros;
+  }
+  totalMicros += lastMicros;
+  passes++;
+}
+
+void RuntimeMetrics::report() {
+  Serial.print("METRIC uptime_ms=");
+  Serial.println(millis());
+  Serial.print("METRIC free_heap_bytes=");
+  Serial.println(Hal::power().freeHeap());
+  Serial.print("METRIC min_free_heap_bytes=");
+  Serial.println(Hal::power().minFreeHeap());
+  if (passes == 0) {
+    return;
+  }
+  Serial.print("METRIC loop_us=");
+  Serial.println(lastMicros);
+  Serial.print("METRIC loop_max_us=");
+  Serial.println(maxMicros);
+  Serial.print("METRIC loop_mean_us=");
+  Serial.println(getMeanMicros());
+  Serial.print("METRIC loop_passes=");
+  Serial.println(passes);
+}
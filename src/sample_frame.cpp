@@ -0,0 +1,56 @@
+#include "sample_frame.h"
+#include <math.h>
+
+static uint8_t crc8(const uint8_t* data, size_t length) {
+  // CRC-8/ATM (polynomial 0x07)
+  uint8_t crc = 0;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static int32_t toCenti(float value, int32_t minimum, int32_t maximum) {
+  int32_t centi = (int32_t)lroundf(value * 100.0f);
+  if (centi < minimum) return minimum;
+  if (centi > maximum) return maximum;
+  return centi;
+}
+
+size_t encodeSampleFrame(const SampleFrame& frame, uint8_t* buffer, size_t bufferSize) {
+  if (bufferSize < SAMPLE_FRAME_SIZE) {
+    return 0;
+  }
+
+  bool valid = !(frame.flags & SAMPLE_FLAG_SENSOR_ERROR);
+  int16_t temperature = valid ? (int16_t)toCenti(frame.temperature, INT16_MIN, INT16_MAX) : 0;
+  uint16_t humidity = valid ? (uint16_t)toCenti(frame.humidity, 0, 10000) : 0;
+
+  buffer[0] = SAMPLE_FRAME_MAGIC;
+  buffer[1] = SAMPLE_FRAME_VERSION;
+  buffer[2] = frame.sequence & 0xFF;
+  buffer[3] = frame.sequence >> 8;
+  buffer[4] = (uint16_t)temperature & 0xFF;
+  buffer[5] = (uint16_t)temperature >> 8;
+  buffer[6] = humidity & 0xFF;
+  buffer[7] = humidity >> 8;
+  buffer[8] = frame.flags;
+  buffer[9] = crc8(buffer, SAMPLE_FRAME_SIZE - 1);
+  return SAMPLE_FRAME_SIZE;
+}
+
+bool decodeSampleFrame(const uint8_t* data, size_t length, SampleFrame* frame) {
+  if (length != SAMPLE_FRAME_SIZE || data[0] != SAMPLE_FRAME_MAGIC ||
+      data[1] != SAMPLE_FRAME_VERSION || crc8(data, SAMPLE_FRAME_SIZE - 1) != data[9]) {
+    return false;
+  }
+
+  frame->sequence = (uint16_t)(data[2] | (data[3] << 8));
+  frame->temperature = (int16_t)(data[4] | (data[5] << 8)) / 100.0f;
+  frame->humidity = (uint16_t)(data[6] | (data[7] << 8)) / 100.0f;
+  frame->flags = data[8];
+  return true;
+}
@@ -0,0 +1,138 @@
+#include "sensor_supervisor.h"
+
+SensorSupervisor::SensorSupervisor()
+  : sensor(nullptr), health(SensorHealth::Healthy), consecutiveFailures(0), failingSinceMs(0),
+    nextAttemptMs(0), backoffMs(SENSOR_RETRY_BACKOFF_MIN), failedReads(0), reinitAttempts(0),
+    busRecoveries(0), recoveries(0), lastRecoveryMs(0), maxRecoveryMs(0) {}
+
+const char* SensorSupervisor::describe(SensorHealth state) {
+  switch (state) {
+    case SensorHealth::Healthy:    return "healthy";
+    case SensorHealth::Degraded:   return "degraded";
+    case SensorHealth::Offline:    return "offline";
+    case SensorHealth::Recovering: return "recovering";
+  }
+  return "unknown";
+}
+
+void SensorSupervisor::setHealth(SensorHealth next) {
+  if (next == health) {
+    return;
+  }
+  health = next;
+  Serial.print(next == SensorHealth::Healthy ? "✓ " : "⚠️  ");
+  Serial.print("Sensor ");
+  Serial.println(describe(next));
+}
+
+bool SensorSupervisor::begin(ClimateManager* climateSensor, uint64_t nowMs) {
+  sensor = climateSensor;
+  if (sensor && sensor->begin()) {
+    return true;
+  }
+  if (sensor) {
+    // A slave left holding SDA across a reset only lets go after a bus clear
+    busRecoveries++;
+    if (sensor->recoverBus() && sensor->begin()) {
+      Serial.println("✓ Sensor started after bus recovery");
+      return true;
+    }
+  }
+  failingSinceMs = nowMs;
+  goOffline(nowMs);
+  return false;
+}
+
+void SensorSupervisor::goOffline(uint64_t nowMs) {
+  if (health != SensorHealth::Recovering) {
+    backoffMs = SENSOR_RETRY_BACKOFF_MIN;
+  } // else: failed again right after a re-init, keep backing off
+  nextAttemptMs = nowMs + backoffMs;
+  setHealth(SensorHealth::Offline);
+}
+
+bool SensorSupervisor::read(sensors_event_t* temperatureEvent, sensors_event_t* humidityEvent,
+                            uint64_t nowMs) {
+  if (!sensor || health == SensorHealth::Offline) {
+    return false;
+  }
+
+  bool valid = sensor->getTemperatureEvent(temperatureEvent) &&
+               sensor->getHumidityEvent(humidityEvent) &&
+               !isnan(temperatureEvent->temperature) && !isnan(humidityEvent->relative_humidity);
+
+  if (valid) {
+    if (health == SensorHealth::Recovering) {
+      recoveries++;
+      lastRecoveryMs = (uint32_t)(nowMs - failingSinceMs);
+      if (lastRecoveryMs > maxRecoveryMs) {
+        maxRecoveryMs = lastRecoveryMs;
+      }
+      Serial.print("METRIC sensor_recovery_ms=");
+      Serial.println(lastRecoveryMs);
+    }
+    consecutiveFailures = 0;
+    setHealth(SensorHealth::Healthy);
+    sensor->markAcquired(nowMs);
+    return true;
+  }
+
+  failedReads++;
+  if (consecutiveFailures == 0 && health != SensorHealth::Recovering) {
+    failingSinceMs = nowMs;
+  }
+  if (consecutiveFailures < UINT8_MAX) {
+    consecutiveFailures++;
+  }
+
+  if (consecutiveFailures >= SENSOR_FAILURE_THRESHOLD) {
+    goOffline(nowMs);
+  } else if (health != SensorHealth::Recovering) {
+    setHealth(SensorHealth::Degraded);
+  }
+  return false;
+}
+
+bool SensorSupervisor::service(uint64_t nowMs) {
+  if (!sensor || health != SensorHealth::Offline || nowMs < nextAttemptMs) {
+    return false;
+  }
+  return reinitialize(nowMs);
+}
+
+bool SensorSupervisor::reinitialize(uint64_t nowMs) {
+  reinitAttempts++;
+  busRecoveries++;
+  bool busClear = sensor->recoverBus();
+  if (busClear && sensor->begin()) {
+    consecutiveFailures = 0;
+    setHealth(SensorHealth::Recovering);
+    return true;
+  }
+
+  backoffMs = backoffMs * 2 > SENSOR_RETRY_BACKOFF_MAX ? SENSOR_RETRY_BACKOFF_MAX : backoffMs * 2;
+  nextAttemptMs = nowMs + backoffMs;
+#if SERIAL_DEBUG_VERBOSE
+  Serial.print(busClear ? "✗ Sensor re-initialization failed" : "✗ I2C bus still held low");
+  Serial.print(", next attempt in ");
+  Serial.print(backoffMs);
+  Serial.println(" ms");
+#endif
+  return false;
+}
+
+void SensorSupervisor::printStats() {
+  Serial.print("Sensor health: ");
+  Serial.print(describe(health));
+  Serial.print(" (");
+  Serial.print(failedReads);
+  Serial.print(" failed reads, ");
+  Serial.print(reinitAttempts);
+  Serial.print(" re-inits, ");
+  Serial.print(recoveries);
+  Serial.println(" recoveries)");
+  if (recoveries > 0) {
+    Serial.print("METRIC sensor_recovery_max_ms=");
+    Serial.println(maxRecoveryMs);
+  }
+}
@@ -0,0 +1,143 @@
+#include "simulated_climate_manager.h"
+#include "i2c_recovery.h"
+#include "hal.h"
+#include <math.h>
+#include <string.h>
+
+#if CLIMATE_SENSOR_SIMULATED
+
+float SimulatedClimateManager::temperature = 21.0f;
+float SimulatedClimateManager::humidity = 45.0f;
+bool SimulatedClimateManager::readFailure = false;
+bool SimulatedClimateManager::busStuck = false;
+uint16_t SimulatedClimateManager::failingReads = 0;
+uint32_t SimulatedClimateManager::heaterPulses = 0;
+bool SimulatedClimateManager::dieWarm = false;
+unsigned long SimulatedClimateManager::pulseEndMs = 0;
+
+// SHT4x datasheet maximum measurement durations; a 1 s heater pulse ends
+// with a high precision measurement
+static const uint32_t CONVERSION_MICROS[MEASUREMENT_PRECISION_COUNT] = { 1600, 4500, 8300 };
+static const uint32_t HEATER_PULSE_MICROS = 1000000 + 8300;
+// Die temperature over ambient at the end of a pulse and its cooling time
+// constant; the excess is below 0.1 °C after about half a minute
+static const float HEATED_DIE_EXCESS = 20.0f;
+static const float HEATED_DIE_COOLING_MS = 5000.0f;
+static const unsigned long HEATED_DIE_SETTLED_MS = 60000;
+
+void SimulatedClimateManager::setReading(float newTemperature, float newHumidity) {
+  temperature = newTemperature;
+  humidity = newHumidity;
+}
+
+void SimulatedClimateManager::setReadFailure(bool failing) {
+  readFailure = failing;
+}
+
+void SimulatedClimateManager::failNextReads(uint16_t count) {
+  failingReads = count;
+}
+
+void SimulatedClimateManager::setBusStuck(bool stuck) {
+  busStuck = stuck;
+}
+
+bool SimulatedClimateManager::begin() {
+  if (busStuck) {
+    Serial.println("Simulated climate sensor not responding (bus stuck)");
+    return false;
+  }
+  Serial.println("Simulated climate sensor initialized");
+  return !readFailure;
+}
+
+bool SimulatedClimateManager::recoverBus() {
+  // Runs the real bus clear, so the host HAL fake decides whether it works
+  if (recoverI2cBus(I2C_SDA_PIN, I2C_SCL_PIN)) {
+    busStuck = false;
+  }
+  return !busStuck;
+}
+
+uint32_t SimulatedClimateManager::conversionMicros(MeasurementPrecision precision) {
+  return CONVERSION_MICROS[(uint8_t)precision];
+}
+
+bool SimulatedClimateManager::pulseHeater() {
+  if (readFailure || busStuck) {
+    return false;
+  }
+  Hal::clock().delayMicros(HEATER_PULSE_MICROS);
+  heaterPulses++;
+  dieWarm = true;
+  pulseEndMs = Hal::clock().millis();
+  return true;
+}
+
+float SimulatedClimateManager::dieExcessCelsius() {
+  if (!dieWarm) {
+    return 0.0f;
+  }
+  unsigned long elapsedMs = Hal::clock().millis() - pulseEndMs;
+  if (elapsedMs >= HEATED_DIE_SETTLED_MS) {
+    dieWarm = false;
+    return 0.0f;
+  }
+  return HEATED_DIE_EXCESS * expf(-(float)elapsedMs / HEATED_DIE_COOLING_MS);
+}
+
+bool SimulatedClimateManager::getTemperatureEvent(sensors_event_t* event) {
+  // One conversion per reading, as on the SHT41 (humidity comes with it)
+  Hal::clock().delayMicros(conversionMicros(precision));
+  memset(event, 0, sizeof(sensors_event_t));
+  event->version = sizeof(sensors_event_t);
+  event->type = SENSOR_TYPE_AMBIENT_TEMPERATURE;
+  event->timestamp = millis();
+  event->temperature = temperature + dieExcessCelsius();
+  if (failingReads > 0) {
+    failingReads--; // One failure per reading (the temperature half)
+    return false;
+  }
+  return !readFailure && !busStuck;
+}
+
+bool SimulatedClimateManager::getHumidityEvent(sensors_event_t* event) {
+  memset(event, 0, sizeof(sensors_event_t));
+  event->version = sizeof(sensors_event_t);
+  event->type = SENSOR_TYPE_RELATIVE_HUMIDITY;
+  event->timestamp = millis();
+  event->relative_humidity = humidity;
+  return !readFailure && !busStuck;
+}
+
+void SimulatedClimateManager::fillSensor(sensor_t* sensor, int32_t type, float minValue, float maxValue) {
+  memset(sensor, 0, sizeof(sensor_t));
+  strncpy(sensor->name, "Simulated", sizeof(sensor->name) - 1);
+  sensor->version = 1;
+  sensor->type = type;
+  sensor->min_value = minValue;
+  sensor->max_value = maxValue;
+  sensor->resolution = 0.01f;
+}
+
+void SimulatedClimateManager::getTemperatureSensor(sensor_t* sensor) {
+  fillSensor(sensor, SENSOR_TYPE_AMBIENT_TEMPERATURE, -40.0f, 125.0f);
+}
+
+void SimulatedClimateManager::getHumiditySensor(sensor_t* sensor) {
+  fillSensor(sensor, SENSOR_TYPE_RELATIVE_HUMIDITY, 0.0f, 100.0f);
+}
+
+String SimulatedClimateManager::getSensorName() {
+  return "Simulated";
+}
+
+void SimulatedClimateManager::printSensorInfo() {
+  Serial.println("=== Simulated Sensor Information ===");
+  Serial.print("Sensor Name: "); Serial.println(getSensorName());
+  Serial.print("Temperature: "); Serial.print(temperature); Serial.println(" °C");
+  Serial.print("Humidity: "); Serial.print(humidity); Serial.println(" %");
+  Serial.println("====================================");
+}
+
+#endif // CLIMATE_SENSOR_SIMULATED
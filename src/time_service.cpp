@@ -0,0 +1,225 @@
+#include "time_service.h"
+
+#if TIME_SYNC_ENABLED
+#include <math.h>
+#include <time.h>
+#include "hal.h"
+#include "power_manager.h"
+
+// Static member initialization
+RTC_DATA_ATTR bool TimeService::synced = false;
+RTC_DATA_ATTR uint64_t TimeService::anchorRtcUs = 0;
+RTC_DATA_ATTR uint64_t TimeService::anchorUnixUs = 0;
+RTC_DATA_ATTR uint64_t TimeService::referenceRtcUs = 0;
+RTC_DATA_ATTR uint64_t TimeService::referenceUnixUs = 0;
+RTC_DATA_ATTR float TimeService::driftPpm = 0.0f;
+RTC_DATA_ATTR bool TimeService::driftKnown = false;
+RTC_DATA_ATTR int32_t TimeService::lastCorrectionMs = 0;
+RTC_DATA_ATTR uint32_t TimeService::syncCount = 0;
+RTC_DATA_ATTR uint32_t TimeService::failureCount = 0;
+bool TimeService::requesting = false;
+unsigned long TimeService::requestStartMs = 0;
+unsigned long TimeService::lastAttemptMs = 0;
+bool TimeService::attempted = false;
+
+void TimeService::begin() {
+  requesting = false;
+  attempted = false;
+  if (PowerManager::isWakeupFromDeepSleep()) {
+    return;
+  }
+  // Power-on: the RTC timer started again from zero, the anchors mean nothing
+  synced = false;
+  driftKnown = false;
+  driftPpm = 0.0f;
+  lastCorrectionMs = 0;
+  syncCount = 0;
+  failureCount = 0;
+}
+
+void TimeService::startRequest() {
+  attempted = true;
+  lastAttemptMs = millis();
+  requestStartMs = millis();
+  requesting = Hal::timeSync().request(TIME_SNTP_SERVER);
+  if (!requesting) {
+    failureCount++;
+  }
+}
+
+bool TimeService::finishRequest(unsigned long timeoutMs) {
+  uint64_t unixUs;
+  if (Hal::timeSync().poll(unixUs)) {
+    requesting = false;
+    applySync(Hal::clock().rtcMicros(), unixUs);
+    return true;
+  }
+  if (millis() - requestStartMs >= timeoutMs) {
+    Hal::timeSync().end();
+    requesting = false;
+    failureCount++;
+    Serial.println("✗ SNTP: no answer from " TIME_SNTP_SERVER);
+    return true;
+  }
+  return false;
+}
+
+void TimeService::applySync(uint64_t rtcUs, uint64_t unixUs) {
+  if (!synced) {
+    referenceRtcUs = rtcUs;
+    referenceUnixUs = unixUs;
+    lastCorrectionMs = 0;
+  } else {
+    WallTime estimate = toWall(rtcUs);
+    lastCorrectionMs = (int32_t)((int64_t)estimate.unixMs - (int64_t)(unixUs / 1000));
+    if ((uint32_t)abs(lastCorrectionMs) > estimate.errorMs) {
+      Serial.print("⚠️  Clock estimate was off by ");
+      Serial.print(lastCorrectionMs);
+      Serial.print(" ms, outside its ±");
+      Serial.print(estimate.errorMs);
+      Serial.println(" ms bound");
+    }
+
+    // Drift over the span since the reference; short spans are all SNTP jitter
+    uint64_t spanRtcUs = rtcUs - referenceRtcUs;
+    int64_t spanUnixUs = (int64_t)(unixUs - referenceUnixUs);
+    if (spanRtcUs >= TIME_DRIFT_MIN_INTERVAL * 1000000ULL && spanUnixUs > 0) {
+      double measured = ((double)(int64_t)spanRtcUs - (double)spanUnixUs) * 1e6 / (double)spanUnixUs;
+      if (fabs(measured) <= TIME_RTC_TOLERANCE_PPM) {
+        driftPpm = driftKnown ? driftPpm + TIME_DRIFT_SMOOTHING * ((float)measured - driftPpm) : (float)measured;
+        driftKnown = true;
+      } else {
+        // UTC was stepped (or the server is wrong): start measuring again
+        Serial.println("⚠️  SNTP time jumped - drift measurement restarted");
+      }
+      referenceRtcUs = rtcUs;
+      referenceUnixUs = unixUs;
+    }
+  }
+
+  anchorRtcUs = rtcUs;
+  anchorUnixUs = unixUs;
+  synced = true;
+  syncCount++;
+
+#if SERIAL_DEBUG_VERBOSE
+  Serial.print("🕒 SNTP sync ");
+  Serial.print(syncCount);
+  Serial.print(": correction ");
+  Serial.print(lastCorrectionMs);
+  Serial.print(" ms, drift ");
+  if (driftKnown) {
+    Serial.print(driftPpm, 1);
+    Serial.println(" ppm");
+  } else {
+    Serial.println("not measured yet");
+  }
+#endif
+}
+
+void TimeService::service() {
+  if (requesting) {
+    finishRequest(TIME_SYNC_TIMEOUT);
+    return;
+  }
+  if (!Hal::network().isConnected() || !isSyncDue()) {
+    return;
+  }
+  if (attempted && millis() - lastAttemptMs < TIME_SYNC_RETRY_INTERVAL) {
+    return;
+  }
+  startRequest();
+}
+
+bool TimeService::syncNow(unsigned long timeoutMs) {
+  if (!Hal::network().isConnected()) {
+    return false;
+  }
+  uint32_t syncsBefore = syncCount;
+  if (!requesting) {
+    startRequest();
+  }
+  while (requesting && !finishRequest(timeoutMs)) {
+    Hal::clock().delay(10);
+  }
+  return syncCount != syncsBefore;
+}
+
+bool TimeService::isSyncDue() {
+  if (!synced) {
+    return true;
+  }
+  uint64_t rtcUs = Hal::clock().rtcMicros();
+  if (rtcUs - anchorRtcUs >= TIME_SYNC_INTERVAL * 1000000ULL) {
+    return true;
+  }
+  return toWall(rtcUs).errorMs > TIME_MAX_ERROR_MS;
+}
+
+WallTime TimeService::toWall(uint64_t rtcUs) {
+  WallTime wall = { 0, 0, false };
+  if (!synced) {
+    return wall;
+  }
+
+  int64_t elapsedUs = (int64_t)(rtcUs - anchorRtcUs);
+  double correctedUs = driftKnown ? elapsedUs / (1.0 + driftPpm * 1e-6) : (double)elapsedUs;
+  wall.unixMs = (uint64_t)((int64_t)anchorUnixUs + llround(correctedUs)) / 1000;
+
+  double elapsedMs = fabs((double)elapsedUs) / 1000.0;
+  double boundPpm = driftKnown ? TIME_DRIFT_RESIDUAL_PPM : TIME_RTC_TOLERANCE_PPM;
+  wall.errorMs = TIME_SNTP_ERROR_MS + (uint32_t)ceil(elapsedMs * boundPpm * 1e-6);
+  wall.valid = true;
+  return wall;
+}
+
+WallTime TimeService::now() {
+  return toWall(Hal::clock().rtcMicros());
+}
+
+void TimeService::formatUtc(uint64_t unixMs, char* text, size_t size) {
+  time_t seconds = (time_t)(unixMs / 1000);
+  struct tm utc;
+  gmtime_r(&seconds, &utc);
+  snprintf(text, size, "%04d-%02d-%02dT%02d:%02d:%02d.%03uZ", utc.tm_year + 1900, utc.tm_mon + 1,
+           utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec, (unsigned)(unixMs % 1000));
+}
+
+void TimeService::printStats() {
+  WallTime wall = now();
+  Serial.println("=== Time Service ===");
+  if (!wall.valid) {
+    Serial.println("Not synced yet");
+  } else {
+    char text[32];
+    formatUtc(wall.unixMs, text, sizeof(text));
+    Serial.print("UTC: ");
+    Serial.print(text);
+    Serial.print(" ±");
+    Serial.print(wall.errorMs);
+    Serial.println(" ms");
+    Serial.print("Drift: ");
+    if (driftKnown) {
+      Serial.print(driftPpm, 1);
+      Serial.println(" ppm");
+    } else {
+      Serial.println("not measured yet");
+    }
+  }
+  Serial.print("SNTP syncs: ");
+  Serial.print(syncCount);
+  Serial.print(" (");
+  Serial.print(failureCount);
+  Serial.println(" failed)");
+
+  Serial.print("METRIC time_error_ms=");
+  Serial.println(wall.valid ? wall.errorMs : 0);
+  Serial.print("METRIC time_drift_ppm=");
+  Serial.println(driftPpm, 1);
+  Serial.print("METRIC time_sync_correction_ms=");
+  Serial.println(lastCorrectionMs);
+  Serial.print("METRIC time_syncs=");
+  Serial.println(syncCount);
+}
+
+#endif // TIME_SYNC_ENABLED
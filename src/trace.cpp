@@ -0,0 +1,54 @@
+#include "trace.h"
+#include "power_manager.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool TraceRecorder::linkUp = false;
+
+bool parseTraceLine(const char* line, TraceEvent* event) {
+  // Tolerate monitor prefixes such as "12:00:00.123 > "
+  const char* start = strstr(line, "TRACE,");
+  if (!start) {
+    return false;
+  }
+
+  char* cursor = nullptr;
+  event->timeMs = strtoull(start + 6, &cursor, 10);
+  if (cursor == start + 6 || *cursor != ',') {
+    return false;
+  }
+  cursor++;
+
+  event->temperature = NAN;
+  event->humidity = NAN;
+  switch (*cursor) {
+    case 'S':
+      event->type = TraceEventType::Sample;
+      return sscanf(cursor + 1, ",%f,%f", &event->temperature, &event->humidity) == 2;
+    case 'U':
+      event->type = TraceEventType::LinkUp;
+      return true;
+    case 'D':
+      event->type = TraceEventType::LinkDown;
+      return true;
+    default:
+      return false;
+  }
+}
+
+void TraceRecorder::recordSample(const sensors_event_t& temperatureEvent, const sensors_event_t& humidityEvent) {
+  Serial.printf("TRACE,%llu,S,%.2f,%.2f\n", (unsigned long long)now(),
+                temperatureEvent.temperature, humidityEvent.relative_humidity);
+}
+
+void TraceRecorder::observeLink(bool connected) {
+  if (connected != linkUp) {
+    linkUp = connected;
+    Serial.printf("TRACE,%llu,%c\n", (unsigned long long)now(), connected ? 'U' : 'D');
+  }
+}
+
+uint64_t TraceRecorder::now() {
+  return PowerManager::getMonotonicMillis();
+}
@@ -0,0 +1,85 @@
+#ifndef ARDUINO
+
+#include "trace_replay.h"
+#include <stdio.h>
+#include "blynk_pins.h"
+#include "energy_model.h"
+#include "hal_fake.h"
+#include "power_manager.h"
+#include "simulated_climate_manager.h"
+
+bool TraceReplay::load(const char* path) {
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    return false;
+  }
+
+  char line[256];
+  TraceEvent event;
+  while (fgets(line, sizeof(line), file)) {
+    if (parseTraceLine(line, &event)) {
+      events.push_back(event);
+    }
+  }
+  fclose(file);
+
+  // Start the replay at the first recorded event
+  if (!events.empty()) {
+    uint64_t origin = events.front().timeMs;
+    for (TraceEvent& e : events) {
+      e.timeMs -= origin;
+    }
+  }
+  nextEvent = 0;
+  return !events.empty();
+}
+
+void TraceReplay::advanceTo(uint64_t timeMs) {
+  while (nextEvent < events.size() && events[nextEvent].timeMs <= timeMs) {
+    const TraceEvent& event = events[nextEvent++];
+    switch (event.type) {
+      case TraceEventType::Sample:
+        SimulatedClimateManager::setReading(event.temperature, event.humidity);
+        break;
+      case TraceEventType::LinkUp:
+        FakeHal::network().setAccessPointAvailable(true);
+        break;
+      case TraceEventType::LinkDown:
+        FakeHal::network().setAccessPointAvailable(false);
+        break;
+    }
+  }
+}
+
+void TraceReplay::printReport() {
+  uint64_t totalMicros = FakeHal::clock().totalMicros();
+  uint64_t sleepMicros = FakeHal::power().sleepMicros();
+  uint64_t awakeMicros = totalMicros - sleepMicros;
+  uint64_t radioMicros = FakeHal::network().radioOnMicros() + FakeHal::peers().radioOnMicros();
+  float energy = EnergyModel::energyMillijoules(awakeMicros, radioMicros, sleepMicros);
+
+  printf("=== Replay Report ===\n");
+  printf("Trace events: %zu\n", events.size());
+  printf("Simulated time: %.1f h\n", totalMicros / 3.6e9);
+  printf("Publishes (Blynk): %lu\n", FakeHal::blynk().writeCount(BLYNK_VIRTUAL_PIN_TEMP));
+  printf("Publishes (HomeKit): %lu\n", FakeHal::homekit().updateCount() / 2);
+  printf("Alert events (Blynk): %lu\n", FakeHal::blynk().eventCount());
+  printf("ESP-NOW frames: %lu (%lu acknowledged)\n", FakeHal::peers().sendCount(),
+         FakeHal::peers().deliveredCount());
+  printf("MQTT sessions: %lu (%lu bytes)\n", FakeHal::mqtt().sessionCount(), FakeHal::mqtt().bytesSent());
+  printf("Blynk writes: %lu\n", FakeHal::blynk().writeCount());
+  printf("Bytes sent: %lu\n", FakeHal::blynk().bytesSent());
+  printf("Sensor heater pulses: %lu\n", (unsigned long)SimulatedClimateManager::getHeaterPulses());
+  printf("Awake time: %.1f s\n", awakeMicros / 1e6);
+  printf("Radio-on time: %.1f s\n", radioMicros / 1e6);
+  printf("Estimated energy: %.1f J (avg %.3f mA)\n", energy / 1000.0f,
+         totalMicros ? energy / EnergyModel::SUPPLY_VOLTAGE / (totalMicros / 1e6) : 0.0);
+  if (!PowerManager::isDeepSleepEnabled()) {
+    // Always-on mode: per-phase model, accounts for frequency scaling and light sleep
+    printf("Phase-model current: %.3f mA (light sleep %s)\n", PowerManager::getAverageCurrentMa(),
+           FakeHal::power().isLightSleepEnabled() ? "on" : "off");
+  }
+  printf("=====================\n");
+}
+
+#endif // ARDUINO
@@ -0,0 +1,153 @@
+// AdaptiveSampler replayed over short traces: the interval backs off to the
+// ceiling while readings are quiet, halves on noise inside the band, snaps
+// to the floor on a step and never leaves [min, max].
+
+#include <unity.h>
+#include "adaptive_sampler.h"
+
+static const uint32_t MIN_INTERVAL = 60000;
+static const uint32_t MAX_INTERVAL = 900000;
+
+static AdaptiveSampler sampler;
+static uint64_t nowMs;
+
+void setUp() {
+  sampler.configure(MIN_INTERVAL, MAX_INTERVAL, 0.3f, 2.0f, 0.02f);
+  sampler.reset();
+  nowMs = 0;
+}
+
+void tearDown() {}
+
+// Next sample on schedule, one interval after the last
+static uint32_t feed(float temperature, float humidity) {
+  nowMs += sampler.getIntervalMs();
+  return sampler.update(temperature, humidity, nowMs);
+}
+
+static void settle(float temperature, int samples) {
+  for (int i = 0; i < samples; i++) {
+    feed(temperature, 50.0f);
+  }
+}
+
+void test_quiet_readings_back_off_to_max() {
+  const uint32_t expected[] = { 60000, 120000, 240000, 480000, 900000, 900000 };
+  for (uint32_t want : expected) {
+    TEST_ASSERT_EQUAL_UINT32(want, feed(20.0f, 50.0f));
+  }
+  TEST_ASSERT_EQUAL_UINT32(MAX_INTERVAL, sampler.getIntervalMs());
+}
+
+void test_noise_inside_band_halves_down_to_min() {
+  settle(20.0f, 6);
+
+  // ±0.25 °C stays inside the 0.3 °C band but the spread is unsettled
+  const float trace[] = { 20.25f, 19.75f, 20.25f, 19.75f, 20.25f, 19.75f };
+  const uint32_t expected[] = { 900000, 450000, 225000, 112500, 60000, 60000 };
+  for (int i = 0; i < 6; i++) {
+    TEST_ASSERT_EQUAL_UINT32(expected[i], feed(trace[i], 50.0f));
+  }
+}
+
+void test_step_snaps_back_to_min() {
+  settle(20.0f, 6);
+  TEST_ASSERT_EQUAL_UINT32(MAX_INTERVAL, sampler.getIntervalMs());
+
+  TEST_ASSERT_EQUAL_UINT32(MIN_INTERVAL, feed(20.5f, 50.0f));
+
+  settle(20.5f, 20);
+  TEST_ASSERT_EQUAL_UINT32(MAX_INTERVAL, sampler.getIntervalMs());
+
+  // A humidity step alone does it too
+  TEST_ASSERT_EQUAL_UINT32(MIN_INTERVAL, feed(20.5f, 53.0f));
+}
+
+void test_ramp_leaves_band_then_settles_again() {
+  settle(20.0f, 4);
+
+  // Slow warm-up: in band for three samples, then a new reference
+  float temperature = 20.0f;
+  for (int i = 0; i < 3; i++) {
+    temperature += 0.08f;
+    TEST_ASSERT_EQUAL_UINT32(MAX_INTERVAL, feed(temperature, 50.0f));
+  }
+  temperature += 0.08f;
+  TEST_ASSERT_EQUAL_UINT32(MIN_INTERVAL, feed(temperature, 50.0f));
+
+  // Still climbing at full rate: the slope keeps it at the floor
+  for (int i = 0; i < 4; i++) {
+    temperature += 0.08f;
+    feed(temperature, 50.0f);
+    TEST_ASSERT_TRUE(sampler.getSlope() > 0.02f);
+    TEST_ASSERT_EQUAL_UINT32(MIN_INTERVAL, sampler.getIntervalMs());
+  }
+
+  // Once it flattens out the interval climbs back to the ceiling
+  settle(temperature, 12);
+  TEST_ASSERT_EQUAL_UINT32(MAX_INTERVAL, sampler.getIntervalMs());
+}
+
+void test_early_sample_uses_the_elapsed_time() {
+  settle(20.0f, 6);
+  TEST_ASSERT_EQUAL_UINT32(MAX_INTERVAL, sampler.getIntervalMs());
+
+  // 0.2 °C one minute after the last sample (an alert wake), not fifteen
+  nowMs += 60000;
+  TEST_ASSERT_EQUAL_UINT32(450000, sampler.update(20.2f, 50.0f, nowMs));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.06f, sampler.getSlope());
+
+  // A sample with no time elapsed falls back to the scheduled interval
+  TEST_ASSERT_EQUAL_UINT32(225000, sampler.update(20.2f, 50.0f, nowMs));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.042f, sampler.getSlope());
+}
+
+void test_replayed_trace_stays_within_bounds() {
+  // Morning warm-up, a door opening, heating cycling, then night
+  const float trace[] = {
+    18.0f, 18.0f, 18.1f, 18.3f, 18.6f, 19.0f, 19.5f, 20.0f, 20.4f, 20.6f,
+    20.7f, 20.7f, 20.7f, 17.9f, 18.4f, 19.2f, 20.1f, 20.5f, 20.6f, 20.6f,
+    20.9f, 20.4f, 21.0f, 20.3f, 21.1f, 20.2f, 20.6f, 20.6f, 20.6f, 20.5f,
+    20.4f, 20.2f, 20.0f, 19.8f, 19.7f, 19.6f, 19.6f, 19.6f, 19.6f, 19.6f,
+    19.6f, 19.6f, 19.6f, 19.6f, 19.6f, 19.6f, 19.6f, 19.6f, 19.6f, 19.6f,
+  };
+  bool reachedMax = false;
+  bool reachedMin = false;
+  for (float temperature : trace) {
+    uint32_t intervalMs = feed(temperature, 50.0f);
+    TEST_ASSERT_TRUE(intervalMs >= MIN_INTERVAL);
+    TEST_ASSERT_TRUE(intervalMs <= MAX_INTERVAL);
+    reachedMax |= intervalMs == MAX_INTERVAL;
+    reachedMin |= intervalMs == MIN_INTERVAL;
+  }
+  TEST_ASSERT_TRUE(reachedMax);
+  TEST_ASSERT_TRUE(reachedMin);
+}
+
+void test_configure_clamps_the_bounds() {
+  settle(20.0f, 6);
+  TEST_ASSERT_EQUAL_UINT32(MAX_INTERVAL, sampler.getIntervalMs());
+
+  // A lower ceiling after an update puts an out-of-range interval back at the floor
+  sampler.configure(MIN_INTERVAL, 300000, 0.3f, 2.0f, 0.02f);
+  TEST_ASSERT_EQUAL_UINT32(MIN_INTERVAL, sampler.getIntervalMs());
+
+  // max below min collapses to a fixed interval
+  sampler.configure(MIN_INTERVAL, 1000, 0.3f, 2.0f, 0.02f);
+  settle(20.0f, 4);
+  TEST_ASSERT_EQUAL_UINT32(MIN_INTERVAL, sampler.getIntervalMs());
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_quiet_readings_back_off_to_max);
+  RUN_TEST(test_noise_inside_band_halves_down_to_min);
+  RUN_TEST(test_step_snaps_back_to_min);
+  RUN_TEST(test_ramp_leaves_band_then_settles_again);
+  RUN_TEST(test_early_sample_uses_the_elapsed_time);
+  RUN_TEST(test_replayed_trace_stays_within_bounds);
+  RUN_TEST(test_configure_clamps_the_bounds);
+  return UNITY_END();
+}
@@ -0,0 +1,82 @@
+// AlertMonitor's pending alarms: a raised alarm keeps coming back from
+// evaluate() until acknowledge() records its publish, and the latency counts
+// from the first detection.
+
+#include <unity.h>
+#include <string.h>
+#include "alert_monitor.h"
+
+static AlertMonitor monitor;
+
+void setUp() {
+  // Lives in RTC memory on the device: zeroed state, then configure()
+  memset(static_cast<void*>(&monitor), 0, sizeof(monitor));
+  AlertThresholds thresholds = { 30.0f, 10.0f, 70.0f, 20.0f, 0.5f, 0.5f, 120000 };
+  monitor.configure(thresholds);
+  monitor.evaluate(21.0f, 45.0f, 0);
+}
+
+void tearDown() {}
+
+void test_quiet_readings_raise_nothing() {
+  TEST_ASSERT_EQUAL(AlertType::None, monitor.evaluate(21.2f, 46.0f, 10000));
+  TEST_ASSERT_FALSE(monitor.anyActive());
+}
+
+void test_alarm_repeats_until_acknowledged() {
+  TEST_ASSERT_EQUAL(AlertType::HighHumidity, monitor.evaluate(21.0f, 75.0f, 10000));
+  TEST_ASSERT_TRUE(monitor.isPending(AlertType::HighHumidity));
+
+  // Publish failed: the next checks hand it back
+  TEST_ASSERT_EQUAL(AlertType::HighHumidity, monitor.evaluate(21.0f, 75.0f, 70000));
+  TEST_ASSERT_EQUAL(AlertType::HighHumidity, monitor.evaluate(21.0f, 75.0f, 130000));
+
+  monitor.acknowledge(AlertType::HighHumidity, 135000);
+  TEST_ASSERT_FALSE(monitor.isPending(AlertType::HighHumidity));
+  TEST_ASSERT_TRUE(monitor.isActive(AlertType::HighHumidity));
+  TEST_ASSERT_EQUAL(AlertType::None, monitor.evaluate(21.0f, 75.0f, 190000));
+
+  // Latency from the check that first saw it
+  TEST_ASSERT_EQUAL_UINT32(1, monitor.getAlarmCount());
+  TEST_ASSERT_EQUAL_UINT32(125000, monitor.getLastLatencyMs());
+}
+
+void test_alarm_that_clears_before_publish_still_goes_out() {
+  monitor.evaluate(21.0f, 75.0f, 10000);
+  TEST_ASSERT_EQUAL(AlertType::HighHumidity, monitor.evaluate(21.0f, 50.0f, 70000));
+  TEST_ASSERT_FALSE(monitor.isActive(AlertType::HighHumidity));
+
+  // Raised again before the first one went out: same alarm, same detection time
+  TEST_ASSERT_EQUAL(AlertType::HighHumidity, monitor.evaluate(21.0f, 75.0f, 100000));
+  TEST_ASSERT_EQUAL_UINT64(10000, monitor.getDetectedMs(AlertType::HighHumidity));
+}
+
+void test_oldest_pending_alarm_comes_first() {
+  monitor.evaluate(21.0f, 75.0f, 10000);
+  TEST_ASSERT_EQUAL(AlertType::LowTemperature, monitor.evaluate(9.0f, 75.0f, 20000));
+
+  // Nothing new: the humidity alarm is older
+  TEST_ASSERT_EQUAL(AlertType::HighHumidity, monitor.evaluate(9.0f, 75.0f, 25000));
+  monitor.acknowledge(AlertType::HighHumidity, 26000);
+  TEST_ASSERT_EQUAL(AlertType::LowTemperature, monitor.evaluate(9.0f, 75.0f, 27000));
+  monitor.acknowledge(AlertType::LowTemperature, 28000);
+  TEST_ASSERT_EQUAL(AlertType::None, monitor.evaluate(9.0f, 75.0f, 29000));
+  TEST_ASSERT_EQUAL_UINT32(2, monitor.getAlarmCount());
+}
+
+void test_acknowledge_without_pending_alarm_is_ignored() {
+  monitor.acknowledge(AlertType::HighTemperature, 5000);
+  TEST_ASSERT_EQUAL_UINT32(0, monitor.getAlarmCount());
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_quiet_readings_raise_nothing);
+  RUN_TEST(test_alarm_repeats_until_acknowledged);
+  RUN_TEST(test_alarm_that_clears_before_publish_still_goes_out);
+  RUN_TEST(test_oldest_pending_alarm_comes_first);
+  RUN_TEST(test_acknowledge_without_pending_alarm_is_ignored);
+  return UNITY_END();
+}
@@ -0,0 +1,166 @@
+// BatteryPolicy's tier transitions, hysteresis and per-tier settings, and
+// the tiers through the whole firmware: a boot on a tier without HomeKit and
+// a later recovery (env:native_features, BATTERY_MONITOR_ENABLED).
+
+#include <unity.h>
+#include <string.h>
+#include "hal_fake.h"
+#include "config.h"
+#include "battery_monitor.h"
+#include "battery_policy.h"
+
+static const uint8_t TIER_START[BATTERY_TIER_COUNT] = { 100, 50, 25, 10 };
+static const BatteryTierSettings SETTINGS[BATTERY_TIER_COUNT] = {
+  { 1, 1, 240, true }, { 2, 2, 160, true }, { 4, 4, 80, false }, { 8, 8, 80, false },
+};
+
+static BatteryPolicy policy;
+
+void setUp() {
+  FakeHal::reset();
+  Serial.setEcho(false);
+  policy.configure(TIER_START, 3, SETTINGS);
+  policy.reset();
+}
+
+void tearDown() {}
+
+void test_discharge_steps_down_through_the_tiers() {
+  const uint8_t charge[] = { 100, 60, 50, 49, 30, 24, 12, 9, 0 };
+  const BatteryTier expected[] = { BatteryTier::Normal, BatteryTier::Normal, BatteryTier::Normal,
+                                   BatteryTier::Conserve, BatteryTier::Conserve, BatteryTier::Low,
+                                   BatteryTier::Low, BatteryTier::Critical, BatteryTier::Critical };
+  int changes = 0;
+  for (int i = 0; i < 9; i++) {
+    changes += policy.update(charge[i]) ? 1 : 0;
+    TEST_ASSERT_EQUAL(expected[i], policy.getTier());
+  }
+  TEST_ASSERT_EQUAL_INT(3, changes);
+
+  // A sudden sag skips tiers
+  policy.reset();
+  TEST_ASSERT_TRUE(policy.update(5));
+  TEST_ASSERT_EQUAL(BatteryTier::Critical, policy.getTier());
+}
+
+void test_no_flapping_on_a_boundary() {
+  // Noise around the 50 % threshold: one step down, then back only at 53 %
+  const uint8_t charge[] = { 51, 49, 50, 51, 52, 49, 50, 52, 53, 52, 51, 50 };
+  const BatteryTier expected[] = { BatteryTier::Normal, BatteryTier::Conserve, BatteryTier::Conserve,
+                                   BatteryTier::Conserve, BatteryTier::Conserve, BatteryTier::Conserve,
+                                   BatteryTier::Conserve, BatteryTier::Conserve, BatteryTier::Normal,
+                                   BatteryTier::Normal, BatteryTier::Normal, BatteryTier::Normal };
+  int changes = 0;
+  for (int i = 0; i < 12; i++) {
+    changes += policy.update(charge[i]) ? 1 : 0;
+    TEST_ASSERT_EQUAL(expected[i], policy.getTier());
+  }
+  TEST_ASSERT_EQUAL_INT(2, changes);
+}
+
+void test_recovery_climbs_past_several_tiers() {
+  policy.update(5);
+  TEST_ASSERT_FALSE(policy.update(12)); // Critical until 13 %
+  TEST_ASSERT_TRUE(policy.update(13));
+  TEST_ASSERT_EQUAL(BatteryTier::Low, policy.getTier());
+
+  // Charger plugged in: straight to the tier the charge allows
+  TEST_ASSERT_TRUE(policy.update(80));
+  TEST_ASSERT_EQUAL(BatteryTier::Normal, policy.getTier());
+}
+
+void test_each_tier_applies_its_settings() {
+  const uint8_t charge[BATTERY_TIER_COUNT] = { 90, 40, 20, 5 };
+  for (uint8_t i = 0; i < BATTERY_TIER_COUNT; i++) {
+    policy.update(charge[i]);
+    const BatteryTierSettings& settings = policy.getSettings();
+    TEST_ASSERT_EQUAL_UINT8(SETTINGS[i].sleepMultiplier, settings.sleepMultiplier);
+    TEST_ASSERT_EQUAL_UINT8(SETTINGS[i].publishEvery, settings.publishEvery);
+    TEST_ASSERT_EQUAL_UINT16(SETTINGS[i].cpuMhz, settings.cpuMhz);
+    TEST_ASSERT_EQUAL(SETTINGS[i].homekit, settings.homekit);
+  }
+  TEST_ASSERT_EQUAL_STRING("low", BatteryPolicy::tierName(BatteryTier::Low));
+}
+
+void test_publish_slots_follow_the_tier() {
+  policy.update(40); // Conserve: every 2nd reading
+  TEST_ASSERT_FALSE(policy.takePublishSlot());
+  TEST_ASSERT_TRUE(policy.takePublishSlot());
+
+  policy.update(20); // Low: every 4th
+  int published = 0;
+  for (int i = 0; i < 12; i++) {
+    published += policy.takePublishSlot() ? 1 : 0;
+  }
+  TEST_ASSERT_EQUAL_INT(3, published);
+}
+
+void test_configure_repairs_bad_values() {
+  // Zero multipliers would stop the clock; garbage RTC state resets the tier
+  BatteryTierSettings zero[BATTERY_TIER_COUNT] = {};
+  memset(static_cast<void*>(&policy), 0xFF, sizeof(policy));
+  policy.configure(TIER_START, 3, zero);
+  TEST_ASSERT_EQUAL(BatteryTier::Normal, policy.getTier());
+  TEST_ASSERT_EQUAL_UINT8(1, policy.getSettings().sleepMultiplier);
+  TEST_ASSERT_EQUAL_UINT8(1, policy.getSettings().publishEvery);
+  TEST_ASSERT_TRUE(policy.takePublishSlot());
+}
+
+#if BATTERY_MONITOR_ENABLED && HOMEKIT_ENABLED && !DEEP_SLEEP_ENABLED
+void setup();
+void loop();
+
+static const uint64_t LOOP_PASS_MICROS = 1000;
+
+// Same driver as src/native_main.cpp: emulate the reboot of a deep sleep
+static void runFor(uint64_t seconds) {
+  uint64_t endMicros = FakeHal::clock().totalMicros() + seconds * 1000000ULL;
+  while (FakeHal::clock().totalMicros() < endMicros) {
+    if (FakeHal::power().deepSleepRequested()) {
+      FakeHal::power().wakeFromDeepSleep();
+      setup();
+      continue;
+    }
+    loop();
+    FakeHal::clock().advanceMicros(LOOP_PASS_MICROS);
+  }
+}
+
+// Resting cell at the given charge, seen through the divider and calibration
+static void setCharge(float percent) {
+  float cellMv = BatteryMonitor::restingMillivolts(percent);
+  float pinMv = (cellMv - BATTERY_CAL_OFFSET_MV) / BATTERY_CAL_GAIN / BATTERY_DIVIDER_RATIO;
+  FakeHal::bus().setAnalogMillivolts(BATTERY_ADC_PIN, (uint32_t)(pinMv + 0.5f));
+}
+
+// HomeSpan is only started where the tier allows it; one that boots on a low
+// cell must still come up once the charge recovers
+void test_homekit_starts_when_a_tier_allows_it() {
+  setCharge(15.0f);
+  setup();
+  runFor(SENSOR_READ_INTERVAL / 1000 + 5);
+  TEST_ASSERT_FALSE(FakeHal::homekit().isStarted());
+  TEST_ASSERT_EQUAL(0, FakeHal::homekit().updateCount());
+
+  setCharge(80.0f);
+  runFor(20 * SENSOR_READ_INTERVAL / 1000);
+  TEST_ASSERT_TRUE(FakeHal::homekit().isStarted());
+  TEST_ASSERT_GREATER_THAN(0, FakeHal::homekit().updateCount());
+}
+#endif
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_discharge_steps_down_through_the_tiers);
+  RUN_TEST(test_no_flapping_on_a_boundary);
+  RUN_TEST(test_recovery_climbs_past_several_tiers);
+  RUN_TEST(test_each_tier_applies_its_settings);
+  RUN_TEST(test_publish_slots_follow_the_tier);
+  RUN_TEST(test_configure_repairs_bad_values);
+#if BATTERY_MONITOR_ENABLED && HOMEKIT_ENABLED && !DEEP_SLEEP_ENABLED
+  RUN_TEST(test_homekit_starts_when_a_tier_allows_it);
+#endif
+  return UNITY_END();
+}
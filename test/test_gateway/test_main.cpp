@@ -0,0 +1,213 @@
+// Leaf-to-gateway path: GatewayAggregator's duplicate window, gap counting
+// and cold-boot handling, and sample frames through the loopback peer link
+// into GatewayNode, including frames the CRC-8 rejects.
+
+#include <unity.h>
+#include <string.h>
+#include "hal_fake.h"
+#include "config.h"
+#include "gateway_aggregator.h"
+#include "gateway_node.h"
+#include "sample_frame.h"
+
+static const uint8_t LEAF_A[6] = { 0x24, 0x0A, 0xC4, 0x00, 0x00, 0x0A };
+static const uint8_t LEAF_B[6] = { 0x24, 0x0A, 0xC4, 0x00, 0x00, 0x0B };
+static const uint8_t GATEWAY[6] = { 0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01 };
+
+static GatewayAggregator aggregator;
+
+static SampleFrame frameOf(uint16_t sequence, uint8_t flags = 0) {
+  SampleFrame frame = { sequence, 21.5f, 45.0f, flags };
+  return frame;
+}
+
+void setUp() {
+  FakeHal::reset();
+  Serial.setEcho(false);
+  aggregator.reset();
+  GatewayNode::aggregator().reset();
+}
+
+void tearDown() {}
+
+void test_in_order_frames_are_accepted() {
+  for (uint16_t sequence = 1; sequence <= 5; sequence++) {
+    TEST_ASSERT_EQUAL_INT(0, aggregator.accept(LEAF_A, frameOf(sequence), sequence * 1000));
+  }
+  TEST_ASSERT_EQUAL_INT(1, aggregator.accept(LEAF_B, frameOf(1), 6000));
+
+  const LeafRecord& leaf = aggregator.leaf(0);
+  TEST_ASSERT_EQUAL_UINT8(2, aggregator.leafCount());
+  TEST_ASSERT_EQUAL_UINT32(5, leaf.frames);
+  TEST_ASSERT_EQUAL_UINT16(5, leaf.lastSequence);
+  TEST_ASSERT_EQUAL_UINT32(0, leaf.duplicates);
+  TEST_ASSERT_EQUAL_UINT32(0, leaf.missed);
+  TEST_ASSERT_EQUAL_UINT32(5000, leaf.lastSeenMs);
+}
+
+void test_retransmits_and_stale_frames_are_duplicates() {
+  for (uint16_t sequence = 1; sequence <= 100; sequence++) {
+    aggregator.accept(LEAF_A, frameOf(sequence), 0);
+  }
+
+  // Same frame again (lost ACK), and late frames inside the window
+  TEST_ASSERT_EQUAL_INT(-1, aggregator.accept(LEAF_A, frameOf(100), 0));
+  TEST_ASSERT_EQUAL_INT(-1, aggregator.accept(LEAF_A, frameOf(99), 0));
+  TEST_ASSERT_EQUAL_INT(-1, aggregator.accept(LEAF_A, frameOf(100 - GatewayAggregator::DUPLICATE_WINDOW + 1), 0));
+
+  const LeafRecord& leaf = aggregator.leaf(0);
+  TEST_ASSERT_EQUAL_UINT32(3, leaf.duplicates);
+  TEST_ASSERT_EQUAL_UINT32(100, leaf.frames);
+  TEST_ASSERT_EQUAL_UINT16(100, leaf.lastSequence);
+}
+
+void test_sequence_gaps_count_missed_samples() {
+  aggregator.accept(LEAF_A, frameOf(1), 0);
+  aggregator.accept(LEAF_A, frameOf(2), 0);
+  TEST_ASSERT_EQUAL_INT(0, aggregator.accept(LEAF_A, frameOf(6), 0));
+  TEST_ASSERT_EQUAL_UINT32(3, aggregator.leaf(0).missed);
+
+  // The sequence wraps without a gap
+  aggregator.reset();
+  aggregator.accept(LEAF_A, frameOf(65535), 0);
+  TEST_ASSERT_EQUAL_INT(0, aggregator.accept(LEAF_A, frameOf(0), 0));
+  TEST_ASSERT_EQUAL_UINT32(0, aggregator.leaf(0).missed);
+}
+
+void test_cold_boot_restarts_the_sequence() {
+  for (uint16_t sequence = 1; sequence <= 10; sequence++) {
+    aggregator.accept(LEAF_A, frameOf(sequence), 0);
+  }
+
+  // The leaf lost its RTC memory: sequence 1 again, flagged
+  TEST_ASSERT_EQUAL_INT(0, aggregator.accept(LEAF_A, frameOf(1, SAMPLE_FLAG_COLD_BOOT), 0));
+  TEST_ASSERT_EQUAL_INT(0, aggregator.accept(LEAF_A, frameOf(2), 0));
+
+  const LeafRecord& leaf = aggregator.leaf(0);
+  TEST_ASSERT_EQUAL_UINT16(2, leaf.lastSequence);
+  TEST_ASSERT_EQUAL_UINT32(12, leaf.frames);
+  TEST_ASSERT_EQUAL_UINT32(0, leaf.duplicates);
+  TEST_ASSERT_EQUAL_UINT32(0, leaf.missed);
+}
+
+void test_jump_beyond_the_window_is_a_restart() {
+  for (uint16_t sequence = 1; sequence <= 200; sequence++) {
+    aggregator.accept(LEAF_A, frameOf(sequence), 0);
+  }
+
+  // Flag lost with the first frame after the reset: far behind still counts as a restart
+  TEST_ASSERT_EQUAL_INT(0, aggregator.accept(LEAF_A, frameOf(3), 0));
+  TEST_ASSERT_EQUAL_UINT16(3, aggregator.leaf(0).lastSequence);
+  TEST_ASSERT_EQUAL_UINT32(0, aggregator.leaf(0).duplicates);
+}
+
+void test_sensor_error_keeps_the_last_reading() {
+  SampleFrame frame = { 1, 22.25f, 40.5f, 0 };
+  aggregator.accept(LEAF_A, frame, 0);
+  aggregator.accept(LEAF_A, frameOf(2, SAMPLE_FLAG_SENSOR_ERROR), 0);
+
+  const LeafRecord& leaf = aggregator.leaf(0);
+  TEST_ASSERT_TRUE(leaf.sensorError);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 22.25f, leaf.temperature);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 40.5f, leaf.humidity);
+}
+
+void test_full_table_rejects_new_leaves() {
+  uint8_t mac[6];
+  memcpy(mac, LEAF_A, sizeof(mac));
+  for (uint8_t i = 0; i < GATEWAY_MAX_LEAVES; i++) {
+    mac[5] = 0x10 + i;
+    TEST_ASSERT_EQUAL_INT(i, aggregator.accept(mac, frameOf(1), 0));
+  }
+  mac[5] = 0x10 + GATEWAY_MAX_LEAVES;
+  TEST_ASSERT_EQUAL_INT(-1, aggregator.accept(mac, frameOf(1), 0));
+  TEST_ASSERT_EQUAL_UINT32(1, aggregator.rejectedCount());
+
+  // Pending samples come out once each, in leaf order
+  for (uint8_t i = 0; i < GATEWAY_MAX_LEAVES; i++) {
+    TEST_ASSERT_EQUAL_INT(i, aggregator.takePending());
+  }
+  TEST_ASSERT_EQUAL_INT(-1, aggregator.takePending());
+}
+
+void test_frame_round_trip() {
+  SampleFrame frame = { 0xBEEF, -12.34f, 56.78f, SAMPLE_FLAG_COLD_BOOT };
+  uint8_t buffer[SAMPLE_FRAME_SIZE];
+  TEST_ASSERT_EQUAL_UINT32(SAMPLE_FRAME_SIZE, encodeSampleFrame(frame, buffer, sizeof(buffer)));
+  TEST_ASSERT_EQUAL_UINT8(SAMPLE_FRAME_MAGIC, buffer[0]);
+
+  SampleFrame decoded;
+  TEST_ASSERT_TRUE(decodeSampleFrame(buffer, sizeof(buffer), &decoded));
+  TEST_ASSERT_EQUAL_UINT16(0xBEEF, decoded.sequence);
+  TEST_ASSERT_FLOAT_WITHIN(0.005f, -12.34f, decoded.temperature);
+  TEST_ASSERT_FLOAT_WITHIN(0.005f, 56.78f, decoded.humidity);
+  TEST_ASSERT_EQUAL_UINT8(SAMPLE_FLAG_COLD_BOOT, decoded.flags);
+
+  // Too small a buffer, and humidity clamped to the wire range
+  TEST_ASSERT_EQUAL_UINT32(0, encodeSampleFrame(frame, buffer, SAMPLE_FRAME_SIZE - 1));
+  frame.humidity = 120.0f;
+  encodeSampleFrame(frame, buffer, sizeof(buffer));
+  decodeSampleFrame(buffer, sizeof(buffer), &decoded);
+  TEST_ASSERT_FLOAT_WITHIN(0.005f, 100.0f, decoded.humidity);
+}
+
+void test_crc_rejects_every_single_bit_error() {
+  SampleFrame frame = { 42, 21.5f, 45.0f, 0 };
+  uint8_t buffer[SAMPLE_FRAME_SIZE];
+  encodeSampleFrame(frame, buffer, sizeof(buffer));
+
+  SampleFrame decoded;
+  for (size_t bit = 0; bit < SAMPLE_FRAME_SIZE * 8; bit++) {
+    uint8_t corrupt[SAMPLE_FRAME_SIZE];
+    memcpy(corrupt, buffer, sizeof(corrupt));
+    corrupt[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    TEST_ASSERT_FALSE(decodeSampleFrame(corrupt, sizeof(corrupt), &decoded));
+  }
+  TEST_ASSERT_FALSE(decodeSampleFrame(buffer, sizeof(buffer) - 1, &decoded));
+}
+
+void test_loopback_delivers_good_frames_and_drops_corrupt_ones() {
+  TEST_ASSERT_TRUE(GatewayNode::begin());
+  FakeHal::peers().setLocalMac(LEAF_A);
+
+  uint8_t buffer[SAMPLE_FRAME_SIZE];
+  for (uint16_t sequence = 1; sequence <= 3; sequence++) {
+    encodeSampleFrame(frameOf(sequence), buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(FakeHal::peers().send(GATEWAY, buffer, sizeof(buffer)));
+  }
+  // Retransmit of the last frame, then sequence 4 with a flipped bit on the air
+  TEST_ASSERT_TRUE(FakeHal::peers().send(GATEWAY, buffer, sizeof(buffer)));
+  encodeSampleFrame(frameOf(4), buffer, sizeof(buffer));
+  buffer[4] ^= 0x10;
+  TEST_ASSERT_TRUE(FakeHal::peers().send(GATEWAY, buffer, sizeof(buffer)));
+
+  TEST_ASSERT_EQUAL_INT(3, GatewayNode::poll());
+  const LeafRecord& leaf = GatewayNode::aggregator().leaf(0);
+  TEST_ASSERT_EQUAL_UINT32(3, leaf.frames);
+  TEST_ASSERT_EQUAL_UINT32(1, leaf.duplicates);
+  TEST_ASSERT_EQUAL_UINT16(3, leaf.lastSequence);
+  TEST_ASSERT_FLOAT_WITHIN(0.005f, 21.5f, leaf.temperature);
+
+  // The corrupt frame is simply lost: the next good one shows it as a gap
+  encodeSampleFrame(frameOf(5), buffer, sizeof(buffer));
+  FakeHal::peers().send(GATEWAY, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_INT(1, GatewayNode::poll());
+  TEST_ASSERT_EQUAL_UINT32(1, leaf.missed);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_in_order_frames_are_accepted);
+  RUN_TEST(test_retransmits_and_stale_frames_are_duplicates);
+  RUN_TEST(test_sequence_gaps_count_missed_samples);
+  RUN_TEST(test_cold_boot_restarts_the_sequence);
+  RUN_TEST(test_jump_beyond_the_window_is_a_restart);
+  RUN_TEST(test_sensor_error_keeps_the_last_reading);
+  RUN_TEST(test_full_table_rejects_new_leaves);
+  RUN_TEST(test_frame_round_trip);
+  RUN_TEST(test_crc_rejects_every_single_bit_error);
+  RUN_TEST(test_loopback_delivers_good_frames_and_drops_corrupt_ones);
+  return UNITY_END();
+}
@@ -0,0 +1,306 @@
+// Request parser, Prometheus rendering and the /metrics endpoint against the
+// fake HTTP client.
+
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "hal_fake.h"
+#include "http_request.h"
+#include "metrics_writer.h"
+#include "metrics_server.h"
+
+static HttpParseStatus feedText(HttpRequestParser& parser, const char* text) {
+  return parser.feed((const uint8_t*)text, strlen(text));
+}
+
+// A sink that accepts everything, to give the dispatcher counters
+class NullPublisher : public Publisher {
+public:
+  const char* name() const override { return "null"; }
+  bool isReady() override { return true; }
+  bool publish(const PublishSample& sample) override {
+    (void)sample;
+    return true;
+  }
+};
+
+static void collectReading(MetricsSnapshot& snapshot) {
+  snapshot.readingValid = true;
+  snapshot.temperature = 21.5f;
+  snapshot.humidity = 45.25f;
+  snapshot.heatIndex = 21.3f;
+  snapshot.readings = 7;
+}
+
+// Serve queued requests until the fake has closed this many clients
+static void serveUntilClosed(unsigned long closed) {
+  for (int pass = 0; pass < 100 && FakeHal::http().closedCount() < closed; pass++) {
+    MetricsServer::service();
+  }
+}
+
+void setUp() {
+  FakeHal::reset();
+  Serial.setEcho(false);
+}
+
+void tearDown() {
+  MetricsServer::end();
+}
+
+void test_parser_accepts_request_split_into_single_bytes() {
+  const char* request = "GET /metrics HTTP/1.1\r\nHost: sensor\r\nAccept: */*\r\n\r\n";
+  HttpRequestParser parser;
+  for (size_t i = 0; request[i] != '\0'; i++) {
+    HttpParseStatus status = parser.feed((const uint8_t*)&request[i], 1);
+    TEST_ASSERT_EQUAL(request[i + 1] == '\0' ? (int)HttpParseStatus::Complete : (int)HttpParseStatus::Incomplete,
+                      (int)status);
+  }
+  TEST_ASSERT_EQUAL((int)HttpMethod::Get, (int)parser.getMethod());
+  TEST_ASSERT_EQUAL_STRING("/metrics", parser.getPath());
+}
+
+void test_parser_strips_query_and_reads_method() {
+  HttpRequestParser parser;
+  TEST_ASSERT_EQUAL((int)HttpParseStatus::Complete, (int)feedText(parser, "HEAD /metrics?name=x HTTP/1.0\n\n"));
+  TEST_ASSERT_EQUAL((int)HttpMethod::Head, (int)parser.getMethod());
+  TEST_ASSERT_EQUAL_STRING("/metrics", parser.getPath());
+
+  parser.reset();
+  TEST_ASSERT_EQUAL((int)HttpParseStatus::Complete, (int)feedText(parser, "\r\nPOST /metrics HTTP/1.1\r\n\r\n"));
+  TEST_ASSERT_EQUAL((int)HttpMethod::Other, (int)parser.getMethod());
+}
+
+void test_parser_rejects_malformed_request_lines() {
+  const char* bad[] = { "GARBAGE\r\n", "GET /metrics\r\n", "GET metrics HTTP/1.1\r\n",
+                        "GET /metrics SPDY/3\r\n", "GET  HTTP/1.1\r\n" };
+  for (const char* line : bad) {
+    HttpRequestParser parser;
+    TEST_ASSERT_EQUAL((int)HttpParseStatus::Malformed, (int)feedText(parser, line));
+  }
+}
+
+void test_parser_limits_request_line_and_headers() {
+  HttpRequestParser parser;
+  std::string longLine = "GET /" + std::string(HttpRequestParser::MAX_REQUEST_LINE, 'a') + " HTTP/1.1\r\n";
+  TEST_ASSERT_EQUAL((int)HttpParseStatus::TooLarge, (int)feedText(parser, longLine.c_str()));
+
+  parser.reset();
+  feedText(parser, "GET /metrics HTTP/1.1\r\n");
+  std::string header = "X-Padding: " + std::string(64, 'b') + "\r\n";
+  HttpParseStatus status = HttpParseStatus::Incomplete;
+  for (int i = 0; i < 64 && status == HttpParseStatus::Incomplete; i++) {
+    status = feedText(parser, header.c_str());
+  }
+  TEST_ASSERT_EQUAL((int)HttpParseStatus::TooLarge, (int)status);
+}
+
+void test_parser_ignores_bytes_after_completion() {
+  HttpRequestParser parser;
+  feedText(parser, "GET /metrics HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_EQUAL((int)HttpParseStatus::Complete, (int)feedText(parser, "garbage that follows"));
+  TEST_ASSERT_EQUAL_STRING("/metrics", parser.getPath());
+}
+
+void test_writer_formats_gauges_counters_and_buckets() {
+  char buffer[512];
+  MetricsWriter writer(buffer, sizeof(buffer));
+  writer.gauge("t_celsius", "Temperature.", 21.456, 2);
+  writer.gauge("nan_value", "Not a number.", NAN);
+  writer.counter("reads_total", "Reads.", 42);
+  unsigned long bound = 250;
+  writer.bucket("lag_bucket", "sink", "blynk", &bound, 3);
+  writer.bucket("lag_bucket", "sink", "blynk", nullptr, 4);
+
+  TEST_ASSERT_FALSE(writer.overflowed());
+  TEST_ASSERT_EQUAL_STRING("# HELP t_celsius Temperature.\n# TYPE t_celsius gauge\nt_celsius 21.46\n"
+                           "# HELP nan_value Not a number.\n# TYPE nan_value gauge\nnan_value NaN\n"
+                           "# HELP reads_total Reads.\n# TYPE reads_total counter\nreads_total 42\n"
+                           "lag_bucket{sink=\"blynk\",le=\"250\"} 3\n"
+                           "lag_bucket{sink=\"blynk\",le=\"+Inf\"} 4\n",
+                           writer.data());
+  TEST_ASSERT_EQUAL(strlen(buffer), writer.length());
+}
+
+void test_writer_drops_whole_metric_on_overflow() {
+  char buffer[80];
+  MetricsWriter writer(buffer, sizeof(buffer));
+  writer.counter("a_total", "A.", 1);
+  size_t afterFirst = writer.length();
+  writer.counter("b_total", "A second counter that cannot fit.", 2);
+  writer.counter("c", "C.", 3); // Would fit, but output stops at the first overflow
+
+  TEST_ASSERT_TRUE(writer.overflowed());
+  TEST_ASSERT_EQUAL(afterFirst, writer.length());
+  TEST_ASSERT_EQUAL('\n', buffer[writer.length() - 1]);
+  TEST_ASSERT_NULL(strstr(buffer, "b_total"));
+}
+
+void test_render_includes_reading_and_sink_counters() {
+  NullPublisher sink;
+  PublishDispatcher dispatcher;
+  dispatcher.addSink(sink, { 2, QueuePolicy::Overwrite, 0, 0 });
+  PublishSample sample = { 0, 1, 0, 21.5f, 45.25f, 21.3f };
+  dispatcher.submit(sample);
+  dispatcher.service(120);
+
+  MetricsSnapshot snapshot = {};
+  collectReading(snapshot);
+  snapshot.publishers = &dispatcher;
+  static char body[METRICS_RESPONSE_SIZE];
+  size_t length = MetricsServer::render(snapshot, body, sizeof(body));
+
+  TEST_ASSERT_GREATER_THAN(0, length);
+  TEST_ASSERT_EQUAL(strlen(body), length);
+  TEST_ASSERT_NOT_NULL(strstr(body, "\nclimate_temperature_celsius 21.50\n"));
+  TEST_ASSERT_NOT_NULL(strstr(body, "\nclimate_humidity_percent 45.25\n"));
+  TEST_ASSERT_NOT_NULL(strstr(body, "\nclimate_sensor_readings_total 7\n"));
+  TEST_ASSERT_NOT_NULL(strstr(body, "\nclimate_publish_delivered_total{sink=\"null\"} 1\n"));
+  TEST_ASSERT_NOT_NULL(strstr(body, "\nclimate_publish_latency_milliseconds_bucket{sink=\"null\",le=\"+Inf\"} 1\n"));
+  TEST_ASSERT_NOT_NULL(strstr(body, "\nclimate_publish_latency_milliseconds_sum{sink=\"null\"} 120\n"));
+}
+
+void test_render_omits_reading_until_valid_and_fails_when_too_small() {
+  MetricsSnapshot snapshot = {};
+  static char body[METRICS_RESPONSE_SIZE];
+  TEST_ASSERT_GREATER_THAN(0, MetricsServer::render(snapshot, body, sizeof(body)));
+  TEST_ASSERT_NULL(strstr(body, "climate_temperature_celsius"));
+
+  char tiny[256];
+  TEST_ASSERT_EQUAL(0, MetricsServer::render(snapshot, tiny, sizeof(tiny)));
+}
+
+void test_server_answers_scrape_with_matching_content_length() {
+  FakeHal::network().begin("ssid", "password");
+  FakeHal::clock().advanceMicros(2000000ULL);
+  TEST_ASSERT_TRUE(MetricsServer::begin(collectReading));
+  FakeHal::http().setChunkSize(7);
+  FakeHal::http().queueRequest("GET /metrics HTTP/1.1\r\nHost: sensor\r\n\r\n");
+  serveUntilClosed(1);
+
+  std::string response = FakeHal::http().lastResponse().c_str();
+  TEST_ASSERT_EQUAL(0, response.find("HTTP/1.1 200 OK\r\n"));
+  size_t bodyStart = response.find("\r\n\r\n") + 4;
+  unsigned long contentLength = strtoul(strstr(response.c_str(), "Content-Length: ") + 16, nullptr, 10);
+  TEST_ASSERT_EQUAL(response.size() - bodyStart, contentLength);
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, response.find("\nclimate_temperature_celsius 21.50\n"));
+}
+
+void test_server_sends_large_body_across_passes() {
+  FakeHal::network().begin("ssid", "password");
+  FakeHal::clock().advanceMicros(2000000ULL);
+  MetricsServer::begin(collectReading);
+  FakeHal::http().queueRequest("GET /metrics HTTP/1.1\r\n\r\n");
+  serveUntilClosed(1);
+  std::string whole = FakeHal::http().lastResponse().c_str();
+
+  // A send buffer far smaller than the response, as with lwIP's TCP_SND_BUF
+  const size_t sendBuffer = 256;
+  FakeHal::http().setSendBufferSize(sendBuffer);
+  FakeHal::http().queueRequest("GET /metrics HTTP/1.1\r\n\r\n");
+  int passes = 0;
+  while (FakeHal::http().closedCount() < 2 && passes < 1000) {
+    MetricsServer::service();
+    passes++;
+  }
+
+  std::string chunked = FakeHal::http().lastResponse().c_str();
+  TEST_ASSERT_GREATER_THAN(sendBuffer * 4, whole.size());
+  TEST_ASSERT_EQUAL((whole.size() + sendBuffer - 1) / sendBuffer, passes);
+  // Same bytes apart from the scrape counter, which has gone up by one
+  TEST_ASSERT_EQUAL(whole.size(), chunked.size());
+  TEST_ASSERT_EQUAL(0, chunked.find("HTTP/1.1 200 OK\r\n"));
+  TEST_ASSERT_EQUAL(chunked.size() - 1, chunked.rfind('\n'));
+}
+
+void test_server_drops_client_that_stops_reading() {
+  FakeHal::network().begin("ssid", "password");
+  FakeHal::clock().advanceMicros(2000000ULL);
+  MetricsServer::begin(collectReading);
+  unsigned long timeoutsBefore = MetricsServer::getTimeoutCount();
+  FakeHal::http().setSendBufferSize(256);
+  FakeHal::http().queueRequest("GET /metrics HTTP/1.1\r\n\r\n");
+  MetricsServer::service();
+  FakeHal::http().setSendBufferSize(0);
+
+  // The window never reopens: nothing more is written until the timeout
+  for (int pass = 0; pass < 10 && FakeHal::http().closedCount() == 0; pass++) {
+    FakeHal::clock().advanceMicros(METRICS_CLIENT_TIMEOUT * 1000ULL / 4);
+    MetricsServer::service();
+  }
+  TEST_ASSERT_EQUAL(timeoutsBefore + 1, MetricsServer::getTimeoutCount());
+  TEST_ASSERT_EQUAL(256, FakeHal::http().lastResponse().length());
+}
+
+void test_server_rejects_other_paths_methods_and_garbage() {
+  FakeHal::network().begin("ssid", "password");
+  FakeHal::clock().advanceMicros(2000000ULL);
+  MetricsServer::begin(collectReading);
+  unsigned long rejectedBefore = MetricsServer::getRejectedCount();
+
+  FakeHal::http().queueRequest("GET / HTTP/1.1\r\n\r\n");
+  serveUntilClosed(1);
+  TEST_ASSERT_EQUAL(0, std::string(FakeHal::http().lastResponse().c_str()).find("HTTP/1.1 404 Not Found\r\n"));
+
+  FakeHal::http().queueRequest("DELETE /metrics HTTP/1.1\r\n\r\n");
+  serveUntilClosed(2);
+  std::string response = FakeHal::http().lastResponse().c_str();
+  TEST_ASSERT_EQUAL(0, response.find("HTTP/1.1 405 Method Not Allowed\r\n"));
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, response.find("Allow: GET, HEAD\r\n"));
+
+  FakeHal::http().queueRequest("hello\r\n\r\n");
+  serveUntilClosed(3);
+  TEST_ASSERT_EQUAL(0, std::string(FakeHal::http().lastResponse().c_str()).find("HTTP/1.1 400 Bad Request\r\n"));
+  TEST_ASSERT_EQUAL(rejectedBefore + 3, MetricsServer::getRejectedCount());
+}
+
+void test_server_head_sends_headers_only() {
+  FakeHal::network().begin("ssid", "password");
+  FakeHal::clock().advanceMicros(2000000ULL);
+  MetricsServer::begin(collectReading);
+  FakeHal::http().queueRequest("HEAD /metrics HTTP/1.1\r\n\r\n");
+  serveUntilClosed(1);
+
+  std::string response = FakeHal::http().lastResponse().c_str();
+  TEST_ASSERT_EQUAL(0, response.find("HTTP/1.1 200 OK\r\n"));
+  TEST_ASSERT_EQUAL(response.size() - 4, response.find("\r\n\r\n"));
+}
+
+void test_server_drops_stalled_client() {
+  FakeHal::network().begin("ssid", "password");
+  FakeHal::clock().advanceMicros(2000000ULL);
+  MetricsServer::begin(collectReading);
+  unsigned long timeoutsBefore = MetricsServer::getTimeoutCount();
+  FakeHal::http().queueRequest("GET /metrics HTTP/1.1\r\n"); // Never finishes its headers
+
+  for (int pass = 0; pass < 10; pass++) {
+    MetricsServer::service();
+    FakeHal::clock().advanceMicros(METRICS_CLIENT_TIMEOUT * 1000ULL / 4);
+  }
+  TEST_ASSERT_EQUAL(timeoutsBefore + 1, MetricsServer::getTimeoutCount());
+  TEST_ASSERT_EQUAL(1, FakeHal::http().closedCount());
+  TEST_ASSERT_EQUAL_STRING("", FakeHal::http().lastResponse().c_str());
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_parser_accepts_request_split_into_single_bytes);
+  RUN_TEST(test_parser_strips_query_and_reads_method);
+  RUN_TEST(test_parser_rejects_malformed_request_lines);
+  RUN_TEST(test_parser_limits_request_line_and_headers);
+  RUN_TEST(test_parser_ignores_bytes_after_completion);
+  RUN_TEST(test_writer_formats_gauges_counters_and_buckets);
+  RUN_TEST(test_writer_drops_whole_metric_on_overflow);
+  RUN_TEST(test_render_includes_reading_and_sink_counters);
+  RUN_TEST(test_render_omits_reading_until_valid_and_fails_when_too_small);
+  RUN_TEST(test_server_answers_scrape_with_matching_content_length);
+  RUN_TEST(test_server_sends_large_body_across_passes);
+  RUN_TEST(test_server_drops_client_that_stops_reading);
+  RUN_TEST(test_server_rejects_other_paths_methods_and_garbage);
+  RUN_TEST(test_server_head_sends_headers_only);
+  RUN_TEST(test_server_drops_stalled_client);
+  return UNITY_END();
+}
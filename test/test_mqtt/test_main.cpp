@@ -0,0 +1,151 @@
+// MqttManager's RTC backlog, packed payload and retries, and the MQTT sink,
+// against the fake broker.
+// Runs under env:native_features (MQTT_ENABLED).
+
+#include <unity.h>
+#include <string.h>
+#include "hal_fake.h"
+#include "config.h"
+#include "mqtt_manager.h"
+#include "publish_dispatcher.h"
+
+void setUp() {
+  FakeHal::reset();
+  Serial.setEcho(false);
+  FakeHal::mqtt().setConnectLatency(0);
+}
+
+#if MQTT_ENABLED
+
+static MqttManager mqtt;
+
+static void associate() {
+  FakeHal::network().setAssociationDelay(0);
+  FakeHal::network().begin("ssid", "password");
+}
+
+// The backlog is static (RTC memory): leave it empty for the next test
+void tearDown() {
+  FakeHal::mqtt().setBrokerAvailable(true);
+  associate();
+  while (mqtt.pendingCount() > 0 && mqtt.flush()) {
+  }
+}
+
+void test_sample_age_counts_from_acquisition() {
+  associate();
+  FakeHal::clock().advanceMicros(10000000ULL);
+  uint64_t acquiredMs = millis() - 4000; // Waited 4 s for its slot
+  mqtt.addSample(acquiredMs, 0, 21.5f, 45.0f, 21.3f);
+
+  TEST_ASSERT_TRUE(mqtt.flush());
+  String payload = FakeHal::mqtt().lastPayload();
+  TEST_ASSERT_NOT_NULL(strstr(payload.c_str(), "\"samples\":[[4000,21.50,45.00,21.30"));
+}
+
+void test_offline_samples_go_out_together() {
+  mqtt.addSample(millis(), 0, 20.0f, 40.0f, 20.0f);
+  TEST_ASSERT_FALSE(mqtt.flush()); // No WiFi
+  FakeHal::clock().advanceMicros(60000000ULL);
+  mqtt.addSample(millis(), 0, 21.0f, 41.0f, 21.0f);
+  TEST_ASSERT_EQUAL(2, mqtt.pendingCount());
+
+  associate();
+  TEST_ASSERT_TRUE(mqtt.flush());
+  TEST_ASSERT_EQUAL(0, mqtt.pendingCount());
+  TEST_ASSERT_EQUAL(1, FakeHal::mqtt().publishCount());
+  TEST_ASSERT_NOT_NULL(strstr(FakeHal::mqtt().lastPayload().c_str(), "[[60000,20.00"));
+}
+
+void test_sink_hands_over_without_burning_retries() {
+  MqttPublisher sink(mqtt);
+  PublishDispatcher dispatcher;
+  dispatcher.addSink(sink, { 4, QueuePolicy::DropNewest, 0, 0 });
+  PublishSample sample = { millis(), 1, 0, 21.0f, 45.0f, 21.0f };
+  dispatcher.submit(sample);
+
+  // Offline: the sample moves to the RTC backlog on the first pass
+  for (int pass = 0; pass < 10; pass++) {
+    dispatcher.service(millis());
+    FakeHal::clock().advanceMicros(1000000ULL);
+  }
+  const SinkStats& stats = dispatcher.getStats(0);
+  TEST_ASSERT_EQUAL(1, stats.delivered);
+  TEST_ASSERT_EQUAL(0, stats.retries);
+  TEST_ASSERT_EQUAL(0, stats.failed);
+  TEST_ASSERT_EQUAL(1, mqtt.pendingCount());
+  TEST_ASSERT_EQUAL(0, FakeHal::mqtt().sessionCount());
+}
+
+void test_manager_retries_after_backoff() {
+  associate();
+  FakeHal::mqtt().setBrokerAvailable(false);
+  mqtt.addSample(millis(), 0, 21.0f, 45.0f, 21.0f);
+  TEST_ASSERT_FALSE(mqtt.flush());
+
+  FakeHal::mqtt().setBrokerAvailable(true);
+  mqtt.service(); // Too soon after the failed attempt
+  TEST_ASSERT_EQUAL(1, mqtt.pendingCount());
+
+  FakeHal::clock().advanceMicros(PUBLISH_RETRY_BACKOFF * 1000ULL);
+  mqtt.service();
+  TEST_ASSERT_EQUAL(0, mqtt.pendingCount());
+  TEST_ASSERT_EQUAL(1, FakeHal::mqtt().publishCount());
+}
+
+// The connect-publish-disconnect cycle: one clean session per flush, nothing
+// left open for keepalive traffic, and no session at all with an empty queue
+void test_flush_is_one_short_session() {
+  associate();
+  TEST_ASSERT_FALSE(mqtt.flush());
+  TEST_ASSERT_EQUAL(0, FakeHal::mqtt().sessionCount());
+
+  mqtt.setSensorName("SHT41");
+  for (int i = 0; i < 3; i++) {
+    mqtt.addSample(millis(), 0, 21.0f + i, 45.0f, 21.0f);
+  }
+  TEST_ASSERT_TRUE(mqtt.flush());
+  TEST_ASSERT_EQUAL(1, FakeHal::mqtt().sessionCount());
+  TEST_ASSERT_EQUAL(1, FakeHal::mqtt().publishCount());
+  TEST_ASSERT_FALSE(FakeHal::mqtt().connected());
+  TEST_ASSERT_EQUAL(MQTT_KEEPALIVE, FakeHal::mqtt().keepAliveSeconds());
+  String topic = FakeHal::mqtt().lastTopic();
+  TEST_ASSERT_EQUAL_STRING(MQTT_TOPIC, topic.c_str());
+
+  String payload = FakeHal::mqtt().lastPayload();
+  TEST_ASSERT_EQUAL(0, strncmp(payload.c_str(), "{\"sensor\":\"SHT41\",\"samples\":[[", 24));
+  TEST_ASSERT_NOT_NULL(strstr(payload.c_str(), ",23.00,45.00,21.00]]}"));
+}
+
+// The RTC backlog keeps the newest MQTT_BACKLOG_SIZE readings
+void test_full_backlog_drops_the_oldest() {
+  unsigned long droppedBefore = mqtt.getDroppedCount();
+  for (int i = 0; i < MQTT_BACKLOG_SIZE + 2; i++) {
+    mqtt.addSample(millis(), 0, (float)i, 45.0f, 0.0f);
+  }
+  TEST_ASSERT_EQUAL(MQTT_BACKLOG_SIZE, mqtt.pendingCount());
+  TEST_ASSERT_EQUAL(droppedBefore + 2, mqtt.getDroppedCount());
+
+  associate();
+  TEST_ASSERT_TRUE(mqtt.flush());
+  TEST_ASSERT_NOT_NULL(strstr(FakeHal::mqtt().lastPayload().c_str(), "[[0,2.00,45.00"));
+}
+
+#else
+void tearDown() {}
+#endif // MQTT_ENABLED
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+#if MQTT_ENABLED
+  RUN_TEST(test_sample_age_counts_from_acquisition);
+  RUN_TEST(test_offline_samples_go_out_together);
+  RUN_TEST(test_sink_hands_over_without_burning_retries);
+  RUN_TEST(test_manager_retries_after_backoff);
+  RUN_TEST(test_flush_is_one_short_session);
+  RUN_TEST(test_full_backlog_drops_the_oldest);
+#endif
+  return UNITY_END();
+}
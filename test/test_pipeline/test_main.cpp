@@ -0,0 +1,173 @@
+// Host tests of the whole firmware: setup()/loop() against the HAL fakes on
+// the simulated clock, with the default config.h settings.
+
+#include <unity.h>
+#include "hal_fake.h"
+#include "blynk_pins.h"
+#include "config.h"
+#include "publish_dispatcher.h"
+#include "simulated_climate_manager.h"
+#include "alert_monitor.h"
+
+void setup();
+void loop();
+extern PublishDispatcher publishers;
+extern unsigned long previousMillis;
+extern unsigned long interval;
+#if ALERTS_ENABLED
+extern AlertMonitor alerts;
+#endif
+
+static const uint64_t LOOP_PASS_MICROS = 1000;
+
+// Same driver as src/native_main.cpp: emulate the reboot of a deep sleep
+static void runFor(uint64_t seconds) {
+  uint64_t endMicros = FakeHal::clock().totalMicros() + seconds * 1000000ULL;
+  while (FakeHal::clock().totalMicros() < endMicros) {
+    if (FakeHal::power().deepSleepRequested()) {
+      FakeHal::power().wakeFromDeepSleep();
+      setup();
+      continue;
+    }
+    loop();
+    FakeHal::clock().advanceMicros(LOOP_PASS_MICROS);
+  }
+}
+
+void setUp() {
+  FakeHal::reset();
+  Serial.setEcho(false);
+  setup();
+}
+
+void tearDown() {
+  SimulatedClimateManager::setReading(21.0f, 45.0f);
+}
+
+void test_first_reading_is_published_after_boot() {
+  runFor(SENSOR_READ_INTERVAL / 1000 + 10);
+#if BLYNK_ENABLED
+  TEST_ASSERT_GREATER_OR_EQUAL(1, FakeHal::blynk().writeCount(BLYNK_VIRTUAL_PIN_TEMP));
+  float published = FakeHal::blynk().lastValue(BLYNK_VIRTUAL_PIN_TEMP).toFloat();
+  TEST_ASSERT_FLOAT_WITHIN(15.0f, 22.0f, published);
+#endif
+#if HOMEKIT_ENABLED
+  TEST_ASSERT_GREATER_THAN(0, FakeHal::homekit().updateCount());
+#endif
+}
+
+void test_readings_follow_the_read_interval() {
+  runFor(600);
+#if BLYNK_ENABLED && !ADAPTIVE_SAMPLING_ENABLED
+  unsigned long expected = 600000UL / SENSOR_READ_INTERVAL;
+  unsigned long writes = FakeHal::blynk().writeCount(BLYNK_VIRTUAL_PIN_TEMP);
+  TEST_ASSERT_GREATER_OR_EQUAL(expected - 1, writes);
+  TEST_ASSERT_LESS_OR_EQUAL(expected + 1, writes);
+#endif
+}
+
+void test_no_publish_while_access_point_is_down() {
+  FakeHal::network().setAccessPointAvailable(false);
+  runFor(300);
+  TEST_ASSERT_EQUAL(0, FakeHal::blynk().writeCount(BLYNK_VIRTUAL_PIN_TEMP));
+  TEST_ASSERT_EQUAL(0, FakeHal::mqtt().publishCount());
+}
+
+// A reading that falls due while the die is still warm from a heater pulse
+// waits for SHT41_HEATER_COOLDOWN instead of publishing the heated value
+void test_reading_after_heater_pulse_waits_for_cooldown() {
+  const float ambient = 21.0f;
+  SimulatedClimateManager::setReading(ambient, 95.0f);
+  uint32_t pulses = SimulatedClimateManager::getHeaterPulses();
+  uint64_t limitMicros = FakeHal::clock().totalMicros() + (SHT41_HEATER_HOLD + 3 * SENSOR_READ_INTERVAL) * 1000ULL;
+  while (SimulatedClimateManager::getHeaterPulses() == pulses && FakeHal::clock().totalMicros() < limitMicros) {
+    runFor(1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(pulses + 1, SimulatedClimateManager::getHeaterPulses());
+
+  // Make the next reading due at once, as with a read interval shorter than the cooldown
+  unsigned long writes = FakeHal::blynk().writeCount(BLYNK_VIRTUAL_PIN_TEMP);
+  previousMillis = millis() - interval;
+  runFor(SHT41_HEATER_COOLDOWN / 1000 - 2);
+  TEST_ASSERT_EQUAL(writes, FakeHal::blynk().writeCount(BLYNK_VIRTUAL_PIN_TEMP));
+
+  runFor(4);
+  TEST_ASSERT_EQUAL(writes + 1, FakeHal::blynk().writeCount(BLYNK_VIRTUAL_PIN_TEMP));
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, ambient, FakeHal::blynk().lastValue(BLYNK_VIRTUAL_PIN_TEMP).toFloat());
+}
+
+#if DEEP_SLEEP_ENABLED
+// A quick wake pulses the heater with WiFi already off: the pulse adds
+// nothing to the wake's radio time
+void test_quick_wake_pulses_heater_with_radio_off() {
+  SimulatedClimateManager::setReading(21.0f, 95.0f);
+  uint32_t pulses = SimulatedClimateManager::getHeaterPulses();
+  uint64_t limitMicros = FakeHal::clock().totalMicros() + (SHT41_HEATER_HOLD + 3 * SENSOR_READ_INTERVAL) * 1000ULL;
+  uint64_t longestRadioMicros = 0;
+  uint64_t wakeRadioMicros = 0;
+  while (SimulatedClimateManager::getHeaterPulses() == pulses && FakeHal::clock().totalMicros() < limitMicros) {
+    longestRadioMicros = wakeRadioMicros > longestRadioMicros ? wakeRadioMicros : longestRadioMicros;
+    uint64_t radioMicros = FakeHal::network().radioOnMicros();
+    runFor(1);
+    wakeRadioMicros = FakeHal::network().radioOnMicros() - radioMicros;
+  }
+  TEST_ASSERT_EQUAL_UINT32(pulses + 1, SimulatedClimateManager::getHeaterPulses());
+  TEST_ASSERT_GREATER_THAN(0, longestRadioMicros);
+  TEST_ASSERT_LESS_THAN(longestRadioMicros + 500000, wakeRadioMicros);
+}
+#endif
+
+#if ALERTS_ENABLED
+// Alert checks run between regular readings (ALERT_CHECK_INTERVAL) but never
+// reach the sinks, so they must not use up sequence numbers
+void test_alert_checks_leave_no_sequence_gaps() {
+  runFor(600);
+  TEST_ASSERT_GREATER_THAN(0, publishers.getSinkCount());
+  for (uint8_t i = 0; i < publishers.getSinkCount(); i++) {
+    const SinkStats& stats = publishers.getStats(i);
+    TEST_ASSERT_GREATER_OR_EQUAL(600000UL / SENSOR_READ_INTERVAL - 1, stats.delivered);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.sent.getGaps());
+  }
+}
+
+// An alarm raised while the access point is down stays pending and goes out
+// on a check after the link is back
+void test_alarm_survives_a_failed_publish() {
+  runFor(SENSOR_READ_INTERVAL / 1000 + 5);
+  FakeHal::network().setAccessPointAvailable(false);
+  runFor(5);
+
+  SimulatedClimateManager::setReading(ALERT_TEMP_HIGH + 3.0f, 45.0f);
+  runFor(3 * ALERT_CHECK_INTERVAL / 1000);
+  TEST_ASSERT_TRUE(alerts.isActive(AlertType::HighTemperature));
+  TEST_ASSERT_TRUE(alerts.isPending(AlertType::HighTemperature));
+#if BLYNK_ENABLED
+  TEST_ASSERT_EQUAL(0, FakeHal::blynk().eventCount());
+#endif
+
+  FakeHal::network().setAccessPointAvailable(true);
+  runFor(60);
+  TEST_ASSERT_FALSE(alerts.isPending(AlertType::HighTemperature));
+#if BLYNK_ENABLED
+  TEST_ASSERT_GREATER_THAN(0, FakeHal::blynk().eventCount());
+#endif
+}
+#endif
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_first_reading_is_published_after_boot);
+  RUN_TEST(test_readings_follow_the_read_interval);
+  RUN_TEST(test_no_publish_while_access_point_is_down);
+  RUN_TEST(test_reading_after_heater_pulse_waits_for_cooldown);
+#if DEEP_SLEEP_ENABLED
+  RUN_TEST(test_quick_wake_pulses_heater_with_radio_off);
+#endif
+#if ALERTS_ENABLED
+  RUN_TEST(test_alert_checks_leave_no_sequence_gaps);
+  RUN_TEST(test_alarm_survives_a_failed_publish);
+#endif
+  return UNITY_END();
+}
@@ -0,0 +1,198 @@
+// Sink enable/disable in PublishDispatcher: switching one sink off and on
+// leaves the other sinks' queues, counters and sequence history alone. Also
+// the per-sink trace counters (SequenceTracker, LatencyHistogram) on a
+// numbered stream with drops and duplicates, and through the echo sink
+// against FakeDatagramLink (env:native_features, ECHO_SINK_ENABLED).
+
+#include <unity.h>
+#include "hal_fake.h"
+#include "publish_dispatcher.h"
+
+// Accepts samples while ready and remembers the last sequence number
+class RecordingPublisher : public Publisher {
+private:
+  const char* sinkName;
+
+public:
+  bool ready = true;
+  unsigned long published = 0;
+  uint32_t lastSequence = 0;
+
+  explicit RecordingPublisher(const char* name) : sinkName(name) {}
+  const char* name() const override { return sinkName; }
+  bool isReady() override { return ready; }
+  bool publish(const PublishSample& sample) override {
+    published++;
+    lastSequence = sample.sequence;
+    return true;
+  }
+};
+
+static PublishDispatcher dispatcher;
+static RecordingPublisher homekit("homekit");
+static RecordingPublisher blynk("blynk");
+static uint32_t nextSequence;
+
+static void submitAndService() {
+  PublishSample sample = { 0, ++nextSequence, 0, 21.0f, 45.0f, 21.0f };
+  dispatcher.submit(sample);
+  dispatcher.service(0);
+}
+
+void setUp() {
+  FakeHal::reset();
+  dispatcher.reset();
+  homekit = RecordingPublisher("homekit");
+  blynk = RecordingPublisher("blynk");
+  nextSequence = 0;
+  dispatcher.addSink(homekit, { 1, QueuePolicy::Overwrite, 0, 0 });
+  dispatcher.addSink(blynk, { 4, QueuePolicy::Overwrite, 2, 0 });
+}
+
+void tearDown() {}
+
+void test_disabled_sink_gets_nothing() {
+  TEST_ASSERT_TRUE(dispatcher.setSinkEnabled(homekit, false));
+  TEST_ASSERT_FALSE(dispatcher.isSinkEnabled(0));
+
+  for (int i = 0; i < 3; i++) {
+    submitAndService();
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(0, homekit.published);
+  TEST_ASSERT_EQUAL_UINT32(0, dispatcher.getQueuedCount(0));
+  TEST_ASSERT_EQUAL_UINT32(3, blynk.published);
+}
+
+void test_toggling_one_sink_keeps_the_others_history() {
+  submitAndService();
+  submitAndService();
+  dispatcher.setSinkEnabled(homekit, false);
+  submitAndService();
+  dispatcher.setSinkEnabled(homekit, true);
+  submitAndService();
+
+  TEST_ASSERT_EQUAL_UINT8(2, dispatcher.getSinkCount());
+  const SinkStats& blynkStats = dispatcher.getStats(1);
+  TEST_ASSERT_EQUAL_UINT32(4, blynkStats.delivered);
+  TEST_ASSERT_EQUAL_UINT32(4, blynkStats.sent.getLast());
+  TEST_ASSERT_EQUAL_UINT32(0, blynkStats.sent.getGaps());
+
+  // HomeKit resumes with the current sample; the one it missed is its gap
+  TEST_ASSERT_EQUAL_UINT32(3, homekit.published);
+  TEST_ASSERT_EQUAL_UINT32(4, homekit.lastSequence);
+  TEST_ASSERT_EQUAL_UINT32(1, dispatcher.getStats(0).sent.getGaps());
+}
+
+void test_disabling_drops_the_queue() {
+  homekit.ready = false;
+  submitAndService();
+  TEST_ASSERT_EQUAL_UINT8(1, dispatcher.getQueuedCount(0));
+
+  dispatcher.setSinkEnabled(homekit, false);
+  TEST_ASSERT_EQUAL_UINT8(0, dispatcher.getQueuedCount(0));
+  TEST_ASSERT_EQUAL_UINT32(1, dispatcher.getStats(0).dropped);
+
+  // Nothing stale comes out once it is back
+  homekit.ready = true;
+  dispatcher.setSinkEnabled(homekit, true);
+  dispatcher.service(0);
+  TEST_ASSERT_EQUAL_UINT32(0, homekit.published);
+}
+
+// Numbers the sink never got are gaps, repeated ones duplicates; each
+// delivery's lag lands in the bucket of its age
+void test_trace_counters_on_a_numbered_stream() {
+  dispatcher.setSinkEnabled(homekit, false);
+  FakeHal::clock().advanceMicros(10000000ULL);
+  const uint32_t sequence[] = { 1, 2, 3, 6, 7, 7, 8, 12 };
+  const uint32_t ageMs[] = { 0, 30, 80, 200, 400, 400, 900, 4000 };
+  for (int i = 0; i < 8; i++) {
+    uint64_t nowMs = millis();
+    PublishSample sample = { nowMs - ageMs[i], sequence[i], 0, 21.0f, 45.0f, 21.0f };
+    dispatcher.submit(sample);
+    dispatcher.service(nowMs);
+  }
+
+  const SinkStats& stats = dispatcher.getStats(1);
+  TEST_ASSERT_EQUAL_UINT32(8, stats.delivered);
+  TEST_ASSERT_EQUAL_UINT32(12, stats.sent.getLast());
+  TEST_ASSERT_EQUAL_UINT32(2 + 3, stats.sent.getGaps());
+  TEST_ASSERT_EQUAL_UINT32(1, stats.sent.getDuplicates());
+
+  // Buckets 50, 100, 250, 500, 1000, 2500, 5000 ms (cumulative)
+  const LatencyHistogram& lag = stats.publishLatency;
+  TEST_ASSERT_EQUAL_UINT32(8, lag.getCount());
+  TEST_ASSERT_EQUAL_UINT32(2, lag.getCumulativeCount(0));
+  TEST_ASSERT_EQUAL_UINT32(3, lag.getCumulativeCount(1));
+  TEST_ASSERT_EQUAL_UINT32(4, lag.getCumulativeCount(2));
+  TEST_ASSERT_EQUAL_UINT32(6, lag.getCumulativeCount(3));
+  TEST_ASSERT_EQUAL_UINT32(7, lag.getCumulativeCount(4));
+  TEST_ASSERT_EQUAL_UINT32(7, lag.getCumulativeCount(5));
+  TEST_ASSERT_EQUAL_UINT32(8, lag.getCumulativeCount(6));
+  TEST_ASSERT_EQUAL_UINT32(4000, lag.getMaxMs());
+  TEST_ASSERT_EQUAL_UINT32(250, lag.getQuantileMs(0.5f));
+  TEST_ASSERT_EQUAL_UINT32(4000, lag.getQuantileMs(0.95f));
+}
+
+#if ECHO_SINK_ENABLED
+// Every 4th datagram is lost on the way and every 6th echoed twice: the
+// acknowledged stream shows the losses as gaps and the repeats as duplicates
+void test_echo_sink_counts_lost_and_repeated_echoes() {
+  FakeHal::network().setAssociationDelay(0);
+  FakeHal::network().begin("ssid", "password");
+  FakeHal::datagram().setDropEvery(4);
+  FakeHal::datagram().setDuplicateEvery(6);
+  FakeHal::datagram().setEchoDelay(120);
+
+  EchoPublisher echo;
+  PublishDispatcher echoDispatcher;
+  echoDispatcher.addSink(echo, { 4, QueuePolicy::DropNewest, 0, 0 });
+  for (uint32_t sequence = 1; sequence <= 20; sequence++) {
+    PublishSample sample = { millis(), sequence, 0, 21.0f, 45.0f, 21.0f };
+    echoDispatcher.submit(sample);
+    echoDispatcher.service(millis());
+    FakeHal::clock().advanceMicros(200000ULL); // Echo is back by the next pass
+    echoDispatcher.service(millis());
+    FakeHal::clock().advanceMicros(800000ULL);
+  }
+
+  const SinkStats& stats = echoDispatcher.getStats(0);
+  TEST_ASSERT_EQUAL_UINT32(20, stats.delivered);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.sent.getGaps());
+
+  // 4, 8, 12 and 16 lost (20 too, but nothing after it shows the gap); 6 and 18 repeated
+  TEST_ASSERT_EQUAL_UINT32(15, stats.acks);
+  TEST_ASSERT_EQUAL_UINT32(19, stats.acked.getLast());
+  TEST_ASSERT_EQUAL_UINT32(4, stats.acked.getGaps());
+  TEST_ASSERT_EQUAL_UINT32(2, stats.acked.getDuplicates());
+
+  // Every echo took 200 ms from acquisition: all in the 250 ms bucket
+  TEST_ASSERT_EQUAL_UINT32(15, stats.ackLatency.getCount());
+  TEST_ASSERT_EQUAL_UINT32(0, stats.ackLatency.getCumulativeCount(1));
+  TEST_ASSERT_EQUAL_UINT32(15, stats.ackLatency.getCumulativeCount(2));
+  TEST_ASSERT_EQUAL_UINT32(200, stats.ackLatency.getMaxMs());
+}
+#endif
+
+void test_unregistered_sink_is_rejected() {
+  RecordingPublisher other("other");
+  TEST_ASSERT_FALSE(dispatcher.setSinkEnabled(other, false));
+  TEST_ASSERT_TRUE(dispatcher.isSinkEnabled(0));
+  TEST_ASSERT_TRUE(dispatcher.isSinkEnabled(1));
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_disabled_sink_gets_nothing);
+  RUN_TEST(test_toggling_one_sink_keeps_the_others_history);
+  RUN_TEST(test_disabling_drops_the_queue);
+  RUN_TEST(test_trace_counters_on_a_numbered_stream);
+#if ECHO_SINK_ENABLED
+  RUN_TEST(test_echo_sink_counts_lost_and_repeated_echoes);
+#endif
+  RUN_TEST(test_unregistered_sink_is_rejected);
+  return UNITY_END();
+}
@@ -0,0 +1,180 @@
+// RollingWindow against a naive recompute over the same bucket-aligned window
+
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+#include "rolling_stats.h"
+
+struct Sample {
+  uint64_t timeMs;
+  float value;
+};
+
+// Straight recompute in double over every sample whose bucket is still live
+static WindowStats reference(const std::vector<Sample>& samples, uint32_t windowMs, uint64_t nowMs) {
+  uint32_t bucketMs = windowMs / RollingWindow::BUCKETS;
+  uint64_t nowBucket = nowMs / bucketMs;
+  uint64_t oldestLive = nowBucket >= RollingWindow::BUCKETS - 1 ? nowBucket - (RollingWindow::BUCKETS - 1) : 0;
+
+  WindowStats stats = { 0, NAN, 0.0f, NAN, NAN };
+  double sum = 0.0;
+  std::vector<float> live;
+  for (const Sample& sample : samples) {
+    if (sample.timeMs / bucketMs >= oldestLive && sample.timeMs <= nowMs) {
+      live.push_back(sample.value);
+      sum += sample.value;
+    }
+  }
+  if (live.empty()) {
+    return stats;
+  }
+  double mean = sum / live.size();
+  double squares = 0.0;
+  float minimum = live[0];
+  float maximum = live[0];
+  for (float value : live) {
+    squares += (value - mean) * (value - mean);
+    minimum = fminf(minimum, value);
+    maximum = fmaxf(maximum, value);
+  }
+  stats.count = live.size();
+  stats.mean = (float)mean;
+  stats.stddev = live.size() > 1 ? (float)sqrt(squares / (live.size() - 1)) : 0.0f;
+  stats.min = minimum;
+  stats.max = maximum;
+  return stats;
+}
+
+// Deterministic generator (no libc rand(), so runs match across hosts)
+static uint32_t lcgState = 12345;
+static uint32_t nextRandom() {
+  lcgState = lcgState * 1664525u + 1013904223u;
+  return lcgState >> 8;
+}
+static double uniform() { return nextRandom() / 16777216.0; }
+
+static RollingWindow window; // Zero-initialized, like the instances in RTC memory
+
+void setUp() {
+  window.configure(RollingStats::WINDOW_MS[0]);
+  window.reset();
+}
+
+void tearDown() {}
+
+void test_empty_window_reports_nan() {
+  WindowStats stats = window.getStats(1000);
+  TEST_ASSERT_EQUAL(0, stats.count);
+  TEST_ASSERT_TRUE(isnan(stats.mean));
+  TEST_ASSERT_TRUE(isnan(stats.min));
+}
+
+void test_single_sample_has_zero_stddev() {
+  window.add(1000, 21.5f);
+  WindowStats stats = window.getStats(2000);
+  TEST_ASSERT_EQUAL(1, stats.count);
+  TEST_ASSERT_EQUAL_FLOAT(21.5f, stats.mean);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.stddev);
+  TEST_ASSERT_EQUAL_FLOAT(21.5f, stats.min);
+  TEST_ASSERT_EQUAL_FLOAT(21.5f, stats.max);
+}
+
+void test_nan_readings_are_ignored() {
+  window.add(1000, NAN);
+  window.add(2000, 20.0f);
+  TEST_ASSERT_EQUAL(1, window.getStats(3000).count);
+}
+
+void test_whole_window_expires_after_a_gap() {
+  window.add(1000, 10.0f);
+  window.add(2000, 30.0f);
+  WindowStats stats = window.getStats(1000 + window.getWindowMs() * 3);
+  TEST_ASSERT_EQUAL(0, stats.count);
+  window.add(1000 + window.getWindowMs() * 3, 20.0f);
+  stats = window.getStats(1000 + window.getWindowMs() * 3);
+  TEST_ASSERT_EQUAL(1, stats.count);
+  TEST_ASSERT_EQUAL_FLOAT(20.0f, stats.min);
+  TEST_ASSERT_EQUAL_FLOAT(20.0f, stats.max);
+}
+
+void test_configure_keeps_history_for_same_window() {
+  window.add(1000, 20.0f);
+  window.configure(RollingStats::WINDOW_MS[0]); // Deep sleep wake: same window
+  TEST_ASSERT_EQUAL(1, window.getStats(2000).count);
+  window.configure(RollingStats::WINDOW_MS[1]);
+  TEST_ASSERT_EQUAL(0, window.getStats(2000).count);
+}
+
+// 200k samples at a 1000 offset (worst case for float cancellation), with
+// bursts, irregular spacing and gaps longer than the window
+void test_matches_naive_recompute() {
+  const uint32_t windowMs = RollingStats::WINDOW_MS[0];
+  const int SAMPLES = 200000;
+  const int CHECK_EVERY = 37;
+  std::vector<Sample> samples;
+  std::vector<Sample> live; // Samples that can still be in the window
+  uint64_t timeMs = 0;
+  int comparisons = 0;
+  int countMismatches = 0;
+  int extremeMismatches = 0;
+  double worstMeanUlps = 0.0; // Both means end up as float: one ulp at 1000 is 6.1e-5
+  double worstStddevError = 0.0;
+
+  for (int i = 0; i < SAMPLES; i++) {
+    double roll = uniform();
+    if (roll < 0.001) {
+      timeMs += windowMs + (uint64_t)(uniform() * windowMs * 2); // Outage
+    } else if (roll < 0.2) {
+      timeMs += (uint64_t)(uniform() * 500); // Burst (alert checks)
+    } else {
+      timeMs += 1000 + (uint64_t)(uniform() * 59000);
+    }
+    float value = (float)(1000.0 + 5.0 * sin(i / 500.0) + (uniform() - 0.5) * 2.0);
+    window.add(timeMs, value);
+    live.push_back(Sample{ timeMs, value });
+    while (!live.empty() && live.front().timeMs + 2 * windowMs < timeMs) {
+      live.erase(live.begin());
+    }
+
+    if (i % CHECK_EVERY != 0) {
+      continue;
+    }
+    uint64_t nowMs = timeMs + (uint64_t)(uniform() * windowMs / 4);
+    WindowStats expected = reference(live, windowMs, nowMs);
+    WindowStats actual = window.getStats(nowMs);
+    comparisons++;
+    if (actual.count != expected.count) {
+      countMismatches++;
+      continue;
+    }
+    if (expected.count == 0) {
+      continue;
+    }
+    double ulp = nextafterf(expected.mean, INFINITY) - expected.mean;
+    worstMeanUlps = fmax(worstMeanUlps, fabs(actual.mean - expected.mean) / ulp);
+    worstStddevError = fmax(worstStddevError, fabs(actual.stddev - expected.stddev));
+    if (actual.min != expected.min || actual.max != expected.max) {
+      extremeMismatches++;
+    }
+  }
+
+  TEST_ASSERT_GREATER_THAN(5000, comparisons);
+  TEST_ASSERT_EQUAL(0, countMismatches);
+  TEST_ASSERT_EQUAL(0, extremeMismatches);
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 0.0f, worstMeanUlps);
+  TEST_ASSERT_FLOAT_WITHIN(5e-5f, 0.0f, worstStddevError);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_window_reports_nan);
+  RUN_TEST(test_single_sample_has_zero_stddev);
+  RUN_TEST(test_nan_readings_are_ignored);
+  RUN_TEST(test_whole_window_expires_after_a_gap);
+  RUN_TEST(test_configure_keeps_history_for_same_window);
+  RUN_TEST(test_matches_naive_recompute);
+  return UNITY_END();
+}
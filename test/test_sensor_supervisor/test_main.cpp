@@ -0,0 +1,180 @@
+// SensorSupervisor and the I2C bus clear under injected faults: failed reads
+// from the simulated sensor, and a slave holding SDA low on the fake bus.
+
+#include <unity.h>
+#include "hal_fake.h"
+#include "blynk_pins.h"
+#include "config.h"
+#include "sensor_supervisor.h"
+#include "simulated_climate_manager.h"
+
+extern SensorSupervisor sensorSupervisor; // main.cpp
+void setup();
+void loop();
+
+static SimulatedClimateManager sensor;
+static sensors_event_t temperatureEvent;
+static sensors_event_t humidityEvent;
+
+static bool readAt(SensorSupervisor& supervisor, uint64_t nowMs) {
+  return supervisor.read(&temperatureEvent, &humidityEvent, nowMs);
+}
+
+static void runFirmwareFor(uint64_t seconds) {
+  uint64_t endMicros = FakeHal::clock().totalMicros() + seconds * 1000000ULL;
+  while (FakeHal::clock().totalMicros() < endMicros) {
+    loop();
+    FakeHal::clock().advanceMicros(1000);
+  }
+}
+
+void setUp() {
+  FakeHal::reset();
+  Serial.setEcho(false);
+  SimulatedClimateManager::setReadFailure(false);
+  SimulatedClimateManager::setBusStuck(false);
+  SimulatedClimateManager::failNextReads(0);
+}
+
+void tearDown() {}
+
+void test_transient_failures_only_degrade() {
+  SensorSupervisor supervisor;
+  TEST_ASSERT_TRUE(supervisor.begin(&sensor, 0));
+
+  SimulatedClimateManager::failNextReads(SENSOR_FAILURE_THRESHOLD - 1);
+  for (int i = 0; i < SENSOR_FAILURE_THRESHOLD - 1; i++) {
+    TEST_ASSERT_FALSE(readAt(supervisor, 1000 * i));
+    TEST_ASSERT_EQUAL((int)SensorHealth::Degraded, (int)supervisor.getHealth());
+  }
+  TEST_ASSERT_TRUE(readAt(supervisor, 10000));
+  TEST_ASSERT_EQUAL((int)SensorHealth::Healthy, (int)supervisor.getHealth());
+  TEST_ASSERT_EQUAL(0, supervisor.getReinitAttempts());
+  TEST_ASSERT_EQUAL(SENSOR_FAILURE_THRESHOLD - 1, supervisor.getFailedReads());
+}
+
+void test_offline_sensor_restarts_after_backoff() {
+  SensorSupervisor supervisor;
+  supervisor.begin(&sensor, 0);
+  SimulatedClimateManager::setReadFailure(true);
+  for (int i = 0; i < SENSOR_FAILURE_THRESHOLD; i++) {
+    readAt(supervisor, 1000 + 1000 * i);
+  }
+  uint64_t offlineMs = 1000 * SENSOR_FAILURE_THRESHOLD;
+  TEST_ASSERT_EQUAL((int)SensorHealth::Offline, (int)supervisor.getHealth());
+  TEST_ASSERT_FALSE(readAt(supervisor, offlineMs + 1)); // Skipped while offline
+  TEST_ASSERT_EQUAL(SENSOR_FAILURE_THRESHOLD, supervisor.getFailedReads());
+
+  SimulatedClimateManager::setReadFailure(false);
+  TEST_ASSERT_FALSE(supervisor.service(offlineMs + SENSOR_RETRY_BACKOFF_MIN - 1));
+  TEST_ASSERT_TRUE(supervisor.service(offlineMs + SENSOR_RETRY_BACKOFF_MIN));
+  TEST_ASSERT_EQUAL((int)SensorHealth::Recovering, (int)supervisor.getHealth());
+
+  uint64_t recoveredMs = offlineMs + SENSOR_RETRY_BACKOFF_MIN + 500;
+  TEST_ASSERT_TRUE(readAt(supervisor, recoveredMs));
+  TEST_ASSERT_EQUAL((int)SensorHealth::Healthy, (int)supervisor.getHealth());
+  TEST_ASSERT_EQUAL(1, supervisor.getRecoveryCount());
+  TEST_ASSERT_EQUAL(recoveredMs - 1000, supervisor.getLastRecoveryMs()); // From the first failure
+}
+
+void test_bus_clear_frees_a_stuck_slave() {
+  SensorSupervisor supervisor;
+  supervisor.begin(&sensor, 0);
+  SimulatedClimateManager::setBusStuck(true);
+  FakeHal::bus().holdLineLow(I2C_SDA_PIN, I2C_SCL_PIN, 5); // Mid-byte: lets go after 5 clocks
+  for (int i = 0; i < SENSOR_FAILURE_THRESHOLD; i++) {
+    readAt(supervisor, 1000 * i);
+  }
+  TEST_ASSERT_EQUAL((int)SensorHealth::Offline, (int)supervisor.getHealth());
+
+  TEST_ASSERT_TRUE(supervisor.service(100000));
+  TEST_ASSERT_FALSE(FakeHal::bus().isLineHeld());
+  TEST_ASSERT_FALSE(SimulatedClimateManager::isBusStuck());
+  TEST_ASSERT_GREATER_OR_EQUAL(5, FakeHal::bus().clockPulseCount());
+  TEST_ASSERT_LESS_OR_EQUAL(I2C_RECOVERY_PULSES + 1, FakeHal::bus().clockPulseCount()); // Plus the STOP
+  TEST_ASSERT_EQUAL(1, supervisor.getBusRecoveries());
+  TEST_ASSERT_TRUE(readAt(supervisor, 100100));
+}
+
+void test_backoff_doubles_while_bus_stays_held() {
+  SensorSupervisor supervisor;
+  SimulatedClimateManager::setBusStuck(true);
+  FakeHal::bus().holdLineLow(I2C_SDA_PIN, I2C_SCL_PIN, -1);
+  TEST_ASSERT_FALSE(supervisor.begin(&sensor, 0)); // Bus clear at start fails too
+  TEST_ASSERT_EQUAL((int)SensorHealth::Offline, (int)supervisor.getHealth());
+
+  uint64_t nowMs = 0;
+  uint32_t expected = SENSOR_RETRY_BACKOFF_MIN;
+  for (int attempt = 0; attempt < 12; attempt++) {
+    nowMs += supervisor.getBackoffMs();
+    TEST_ASSERT_FALSE(supervisor.service(nowMs));
+    expected = expected * 2 > SENSOR_RETRY_BACKOFF_MAX ? SENSOR_RETRY_BACKOFF_MAX : expected * 2;
+    TEST_ASSERT_EQUAL(expected, supervisor.getBackoffMs());
+  }
+  TEST_ASSERT_EQUAL(SENSOR_RETRY_BACKOFF_MAX, supervisor.getBackoffMs());
+  TEST_ASSERT_EQUAL(12, supervisor.getReinitAttempts());
+}
+
+void test_begin_recovers_bus_left_held_across_reset() {
+  SensorSupervisor supervisor;
+  SimulatedClimateManager::setBusStuck(true);
+  FakeHal::bus().holdLineLow(I2C_SDA_PIN, I2C_SCL_PIN, 3);
+  TEST_ASSERT_TRUE(supervisor.begin(&sensor, 0));
+  TEST_ASSERT_EQUAL((int)SensorHealth::Healthy, (int)supervisor.getHealth());
+  TEST_ASSERT_EQUAL(1, supervisor.getBusRecoveries());
+}
+
+void test_failure_right_after_restart_keeps_backing_off() {
+  SensorSupervisor supervisor;
+  supervisor.begin(&sensor, 0);
+  SimulatedClimateManager::setReadFailure(true);
+  for (int i = 0; i < SENSOR_FAILURE_THRESHOLD; i++) {
+    readAt(supervisor, i);
+  }
+  uint64_t nowMs = SENSOR_RETRY_BACKOFF_MIN + 10;
+  TEST_ASSERT_FALSE(supervisor.service(nowMs)); // begin() fails as well
+  TEST_ASSERT_EQUAL(2 * SENSOR_RETRY_BACKOFF_MIN, supervisor.getBackoffMs());
+
+  // The restart works, but the next readings fail again
+  SimulatedClimateManager::setReadFailure(false);
+  nowMs += supervisor.getBackoffMs();
+  TEST_ASSERT_TRUE(supervisor.service(nowMs));
+  SimulatedClimateManager::setReadFailure(true);
+  for (int i = 0; i < SENSOR_FAILURE_THRESHOLD; i++) {
+    readAt(supervisor, nowMs + 1 + i);
+  }
+  TEST_ASSERT_EQUAL((int)SensorHealth::Offline, (int)supervisor.getHealth());
+  TEST_ASSERT_EQUAL(2 * SENSOR_RETRY_BACKOFF_MIN, supervisor.getBackoffMs()); // Not back to the minimum
+  TEST_ASSERT_EQUAL(0, supervisor.getRecoveryCount());
+}
+
+// Whole firmware: a wedged bus stops publishing, the supervisor clears it
+// from loop() and readings go out again without a reboot
+void test_firmware_publishes_again_after_bus_recovery() {
+  setup();
+  runFirmwareFor(SENSOR_READ_INTERVAL / 1000 + 5);
+  unsigned long before = FakeHal::blynk().writeCount(BLYNK_VIRTUAL_PIN_TEMP);
+  TEST_ASSERT_GREATER_THAN(0, before);
+
+  SimulatedClimateManager::setBusStuck(true);
+  FakeHal::bus().holdLineLow(I2C_SDA_PIN, I2C_SCL_PIN, 4);
+  runFirmwareFor((SENSOR_READ_INTERVAL / 1000) * (SENSOR_FAILURE_THRESHOLD + 3));
+
+  TEST_ASSERT_TRUE(sensorSupervisor.isOnline());
+  TEST_ASSERT_GREATER_OR_EQUAL(1, sensorSupervisor.getRecoveryCount());
+  TEST_ASSERT_GREATER_THAN(before, FakeHal::blynk().writeCount(BLYNK_VIRTUAL_PIN_TEMP));
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_transient_failures_only_degrade);
+  RUN_TEST(test_offline_sensor_restarts_after_backoff);
+  RUN_TEST(test_bus_clear_frees_a_stuck_slave);
+  RUN_TEST(test_backoff_doubles_while_bus_stays_held);
+  RUN_TEST(test_begin_recovers_bus_left_held_across_reset);
+  RUN_TEST(test_failure_right_after_restart_keeps_backing_off);
+  RUN_TEST(test_firmware_publishes_again_after_bus_recovery);
+  return UNITY_END();
+}
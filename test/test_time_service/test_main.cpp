@@ -0,0 +1,141 @@
+// TimeService against the fake SNTP server and a drifting RTC timer: drift
+// estimation, the error bound around the true time, and when a resync falls
+// due. Runs under env:native_features (TIME_SYNC_ENABLED).
+
+#include <unity.h>
+#include "hal_fake.h"
+#include "config.h"
+#include "time_service.h"
+
+void setUp() {
+  FakeHal::reset();
+  Serial.setEcho(false);
+}
+
+#if TIME_SYNC_ENABLED
+
+static void associate() {
+  FakeHal::network().setAssociationDelay(0);
+  FakeHal::network().begin("ssid", "password");
+}
+
+static void advanceSeconds(uint64_t seconds) {
+  FakeHal::clock().advanceMicros(seconds * 1000000ULL);
+}
+
+// Estimate minus true UTC, in milliseconds
+static int64_t estimateErrorMs() {
+  WallTime wall = TimeService::now();
+  return (int64_t)wall.unixMs - (int64_t)(FakeHal::timeSync().trueUnixMicros() / 1000);
+}
+
+void tearDown() {
+  FakeHal::clock().setRtcDrift(0.0);
+}
+
+void test_not_synced_until_the_first_answer() {
+  TimeService::begin();
+  TEST_ASSERT_FALSE(TimeService::now().valid);
+  TEST_ASSERT_TRUE(TimeService::isSyncDue());
+
+  // No WiFi, then no server: failures are counted and the sync stays due
+  TEST_ASSERT_FALSE(TimeService::syncNow(TIME_SYNC_TIMEOUT));
+  associate();
+  FakeHal::timeSync().setServerAvailable(false);
+  TEST_ASSERT_FALSE(TimeService::syncNow(TIME_SYNC_TIMEOUT));
+  TEST_ASSERT_EQUAL_UINT32(1, TimeService::getFailureCount());
+  TEST_ASSERT_TRUE(TimeService::isSyncDue());
+
+  FakeHal::timeSync().setServerAvailable(true);
+  TEST_ASSERT_TRUE(TimeService::syncNow(TIME_SYNC_TIMEOUT));
+  WallTime wall = TimeService::now();
+  TEST_ASSERT_TRUE(wall.valid);
+  TEST_ASSERT_EQUAL_UINT32(TIME_SNTP_ERROR_MS, wall.errorMs);
+  TEST_ASSERT_TRUE(llabs(estimateErrorMs()) <= 1);
+  TEST_ASSERT_FALSE(TimeService::isSyncDue());
+}
+
+// Before the drift is known the bound grows at TIME_RTC_TOLERANCE_PPM, and
+// the true time stays inside it while the RTC runs within that tolerance
+void test_error_bound_holds_and_schedules_the_resync() {
+  FakeHal::clock().setRtcDrift(15000.0);
+  TimeService::begin();
+  associate();
+  TEST_ASSERT_TRUE(TimeService::syncNow(TIME_SYNC_TIMEOUT));
+
+  // 50 ms + 20 ms per RTC second (1.5 % fast here): over TIME_MAX_ERROR_MS
+  // after about 244 s
+  advanceSeconds(240);
+  WallTime wall = TimeService::now();
+  TEST_ASSERT_UINT32_WITHIN(2, TIME_SNTP_ERROR_MS + 4872, wall.errorMs);
+  TEST_ASSERT_TRUE(llabs(estimateErrorMs()) <= (int64_t)wall.errorMs);
+  TEST_ASSERT_FALSE(TimeService::isSyncDue());
+
+  advanceSeconds(10);
+  TEST_ASSERT_TRUE(TimeService::isSyncDue());
+  TEST_ASSERT_TRUE(llabs(estimateErrorMs()) <= (int64_t)TimeService::now().errorMs);
+}
+
+void test_drift_is_measured_and_corrected() {
+  FakeHal::clock().setRtcDrift(300.0);
+  TimeService::begin();
+  associate();
+  TimeService::syncNow(TIME_SYNC_TIMEOUT);
+
+  // Too short a span to tell drift from SNTP jitter
+  advanceSeconds(200);
+  TimeService::syncNow(TIME_SYNC_TIMEOUT);
+  TEST_ASSERT_FALSE(TimeService::isDriftKnown());
+
+  // An hour later: 300 ppm fast is 1080 ms ahead, corrected at the sync
+  advanceSeconds(3600);
+  TEST_ASSERT_INT64_WITHIN(20, 1080, estimateErrorMs());
+  TEST_ASSERT_TRUE(TimeService::syncNow(TIME_SYNC_TIMEOUT));
+  TEST_ASSERT_TRUE(TimeService::isDriftKnown());
+  TEST_ASSERT_FLOAT_WITHIN(5.0f, 300.0f, TimeService::getDriftPpm());
+  TEST_ASSERT_INT_WITHIN(20, 1080, TimeService::getLastCorrectionMs());
+
+  // With the drift taken out, another hour leaves only a few milliseconds
+  advanceSeconds(3600);
+  TEST_ASSERT_TRUE(llabs(estimateErrorMs()) <= 20);
+  TEST_ASSERT_UINT32_WITHIN(2, TIME_SNTP_ERROR_MS + 1800, TimeService::now().errorMs);
+}
+
+// With the drift known the bound grows at TIME_DRIFT_RESIDUAL_PPM, so syncs
+// space out from minutes to hours
+void test_resync_spaces_out_once_drift_is_known() {
+  FakeHal::clock().setRtcDrift(-800.0);
+  TimeService::begin();
+  associate();
+  TimeService::syncNow(TIME_SYNC_TIMEOUT);
+  // The span is measured on the RTC, which runs slow here
+  advanceSeconds(TIME_DRIFT_MIN_INTERVAL + 10);
+  TimeService::syncNow(TIME_SYNC_TIMEOUT);
+  TEST_ASSERT_TRUE(TimeService::isDriftKnown());
+  TEST_ASSERT_FLOAT_WITHIN(5.0f, -800.0f, TimeService::getDriftPpm());
+
+  // 50 ms + 0.5 ms per second: over TIME_MAX_ERROR_MS after 9900 s
+  advanceSeconds(9800);
+  TEST_ASSERT_FALSE(TimeService::isSyncDue());
+  TEST_ASSERT_TRUE(llabs(estimateErrorMs()) <= (int64_t)TimeService::now().errorMs);
+  advanceSeconds(200);
+  TEST_ASSERT_TRUE(TimeService::isSyncDue());
+  TEST_ASSERT_EQUAL_UINT32(2, TimeService::getSyncCount());
+}
+
+#else
+void tearDown() {}
+#endif // TIME_SYNC_ENABLED
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+#if TIME_SYNC_ENABLED
+  RUN_TEST(test_not_synced_until_the_first_answer);
+  RUN_TEST(test_error_bound_holds_and_schedules_the_resync);
+  RUN_TEST(test_drift_is_measured_and_corrected);
+  RUN_TEST(test_resync_spaces_out_once_drift_is_known);
+#endif
+  return UNITY_END();
+}